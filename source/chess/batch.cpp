@@ -0,0 +1,772 @@
+#include "batch.hpp"
+
+#include "sliding.hpp"
+#include "precompute.hpp"
+
+#include <bit>
+#include <tuple>
+#include <algorithm>
+
+#if SCREEPFISH_BATCH_AVX2
+	#include <immintrin.h>
+#endif
+
+namespace chess
+{
+	namespace impl
+	{
+		/**
+		 * @brief Portable set of 64 bit boards that are operated on together.
+		*/
+		template <size_t N>
+		struct ScalarLanes
+		{
+			static ScalarLanes splat(uint64_t _bits) noexcept
+			{
+				auto o = ScalarLanes{};
+				o.v_.fill(_bits);
+				return o;
+			};
+			static ScalarLanes load(const uint64_t* _from) noexcept
+			{
+				auto o = ScalarLanes{};
+				std::copy_n(_from, N, o.v_.begin());
+				return o;
+			};
+			void store(uint64_t* _to) const noexcept
+			{
+				std::copy_n(this->v_.begin(), N, _to);
+			};
+
+			/**
+			 * @brief Shifts each board left by S bits, or right for negative S.
+			*/
+			template <int S>
+			ScalarLanes shift() const noexcept
+			{
+				auto o = ScalarLanes{};
+				for (size_t n = 0; n != N; ++n)
+				{
+					if constexpr (S > 0) { o.v_[n] = this->v_[n] << S; }
+					else { o.v_[n] = this->v_[n] >> -S; };
+				};
+				return o;
+			};
+
+			/**
+			 * @brief Gets all bits set for the empty boards and no bits set for the others.
+			*/
+			ScalarLanes zero_mask() const noexcept
+			{
+				auto o = ScalarLanes{};
+				for (size_t n = 0; n != N; ++n)
+				{
+					o.v_[n] = (this->v_[n] == 0) ? ~uint64_t(0) : uint64_t(0);
+				};
+				return o;
+			};
+
+			/**
+			 * @brief Gets the number of bits set on each board.
+			*/
+			ScalarLanes popcount() const noexcept
+			{
+				auto o = ScalarLanes{};
+				for (size_t n = 0; n != N; ++n)
+				{
+					o.v_[n] = static_cast<uint64_t>(std::popcount(this->v_[n]));
+				};
+				return o;
+			};
+
+#define SCREEPFISH_SCALAR_LANES_OP(op) \
+			friend ScalarLanes operator op(const ScalarLanes& lhs, const ScalarLanes& rhs) noexcept \
+			{ \
+				auto o = ScalarLanes{}; \
+				for (size_t n = 0; n != N; ++n) { o.v_[n] = lhs.v_[n] op rhs.v_[n]; }; \
+				return o; \
+			}
+
+			SCREEPFISH_SCALAR_LANES_OP(&);
+			SCREEPFISH_SCALAR_LANES_OP(|);
+			SCREEPFISH_SCALAR_LANES_OP(^);
+			SCREEPFISH_SCALAR_LANES_OP(+);
+
+#undef SCREEPFISH_SCALAR_LANES_OP
+
+			friend ScalarLanes operator~(const ScalarLanes& rhs) noexcept
+			{
+				return rhs ^ splat(~uint64_t(0));
+			};
+
+			std::array<uint64_t, N> v_;
+		};
+
+#if SCREEPFISH_BATCH_AVX2
+		/**
+		 * @brief Four 64 bit boards held in an AVX2 register.
+		*/
+		struct Avx2Lanes
+		{
+			static Avx2Lanes splat(uint64_t _bits) noexcept
+			{
+				return Avx2Lanes{ _mm256_set1_epi64x(static_cast<long long>(_bits)) };
+			};
+			static Avx2Lanes load(const uint64_t* _from) noexcept
+			{
+				return Avx2Lanes{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_from)) };
+			};
+			void store(uint64_t* _to) const noexcept
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(_to), this->v_);
+			};
+
+			/**
+			 * @brief Shifts each board left by S bits, or right for negative S.
+			*/
+			template <int S>
+			Avx2Lanes shift() const noexcept
+			{
+				if constexpr (S > 0) { return Avx2Lanes{ _mm256_slli_epi64(this->v_, S) }; }
+				else { return Avx2Lanes{ _mm256_srli_epi64(this->v_, -S) }; };
+			};
+
+			/**
+			 * @brief Gets all bits set for the empty boards and no bits set for the others.
+			*/
+			Avx2Lanes zero_mask() const noexcept
+			{
+				return Avx2Lanes{ _mm256_cmpeq_epi64(this->v_, _mm256_setzero_si256()) };
+			};
+
+			/**
+			 * @brief Gets the number of bits set on each board.
+			 *
+			 * Each nibble is counted with a table lookup and the byte counts are summed per board.
+			*/
+			Avx2Lanes popcount() const noexcept
+			{
+				const auto _table = _mm256_setr_epi8
+				(
+					0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+					0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+				);
+				const auto _nibble = _mm256_set1_epi8(0x0F);
+				const auto _lo = _mm256_and_si256(this->v_, _nibble);
+				const auto _hi = _mm256_and_si256(_mm256_srli_epi16(this->v_, 4), _nibble);
+				const auto _bytes = _mm256_add_epi8(_mm256_shuffle_epi8(_table, _lo), _mm256_shuffle_epi8(_table, _hi));
+				return Avx2Lanes{ _mm256_sad_epu8(_bytes, _mm256_setzero_si256()) };
+			};
+
+			friend Avx2Lanes operator&(Avx2Lanes lhs, Avx2Lanes rhs) noexcept { return Avx2Lanes{ _mm256_and_si256(lhs.v_, rhs.v_) }; };
+			friend Avx2Lanes operator|(Avx2Lanes lhs, Avx2Lanes rhs) noexcept { return Avx2Lanes{ _mm256_or_si256(lhs.v_, rhs.v_) }; };
+			friend Avx2Lanes operator^(Avx2Lanes lhs, Avx2Lanes rhs) noexcept { return Avx2Lanes{ _mm256_xor_si256(lhs.v_, rhs.v_) }; };
+			friend Avx2Lanes operator+(Avx2Lanes lhs, Avx2Lanes rhs) noexcept { return Avx2Lanes{ _mm256_add_epi64(lhs.v_, rhs.v_) }; };
+			friend Avx2Lanes operator~(Avx2Lanes rhs) noexcept { return rhs ^ splat(~uint64_t(0)); };
+
+			__m256i v_;
+		};
+
+		using BatchLanes = Avx2Lanes;
+#else
+		using BatchLanes = ScalarLanes<batch_lanes_v>;
+#endif
+	};
+
+	namespace
+	{
+		constexpr uint64_t all_bits_v = ~uint64_t(0);
+		constexpr uint64_t rank1_bits_v = 0x0101'0101'0101'0101;
+		constexpr uint64_t rank2_bits_v = rank1_bits_v << 1;
+		constexpr uint64_t rank3_bits_v = rank1_bits_v << 2;
+		constexpr uint64_t rank7_bits_v = rank1_bits_v << 6;
+		constexpr uint64_t rank8_bits_v = rank1_bits_v << 7;
+
+		constexpr uint64_t square_bit(File _file, Rank _rank) noexcept
+		{
+			return uint64_t(1) << static_cast<uint8_t>(Position(_file, _rank));
+		};
+
+		constexpr auto a1_bit_v = square_bit(File::a, Rank::r1);
+		constexpr auto b1_bit_v = square_bit(File::b, Rank::r1);
+		constexpr auto c1_bit_v = square_bit(File::c, Rank::r1);
+		constexpr auto d1_bit_v = square_bit(File::d, Rank::r1);
+		constexpr auto e1_bit_v = square_bit(File::e, Rank::r1);
+		constexpr auto f1_bit_v = square_bit(File::f, Rank::r1);
+		constexpr auto g1_bit_v = square_bit(File::g, Rank::r1);
+		constexpr auto h1_bit_v = square_bit(File::h, Rank::r1);
+		constexpr auto a8_bit_v = square_bit(File::a, Rank::r8);
+		constexpr auto c8_bit_v = square_bit(File::c, Rank::r8);
+		constexpr auto g8_bit_v = square_bit(File::g, Rank::r8);
+		constexpr auto h8_bit_v = square_bit(File::h, Rank::r8);
+
+		/**
+		 * @brief Mirrors a bitboard vertically, each file is held in one byte so the bits of each byte are reversed.
+		*/
+		constexpr uint64_t flip_ranks(uint64_t _bits) noexcept
+		{
+			_bits = ((_bits >> 1) & 0x5555'5555'5555'5555) | ((_bits & 0x5555'5555'5555'5555) << 1);
+			_bits = ((_bits >> 2) & 0x3333'3333'3333'3333) | ((_bits & 0x3333'3333'3333'3333) << 2);
+			_bits = ((_bits >> 4) & 0x0F0F'0F0F'0F0F'0F0F) | ((_bits & 0x0F0F'0F0F'0F0F'0F0F) << 4);
+			return _bits;
+		};
+
+		/**
+		 * @brief A direction a piece can move in.
+		 * @tparam S Change in square index for a single step.
+		 * @tparam G Squares that can be reached by a single step without wrapping around the board.
+		*/
+		template <int S, uint64_t G>
+		struct Step
+		{
+			constexpr static int shift_v = S;
+			constexpr static uint64_t guard_v = G;
+		};
+
+		using up = Step<1, ~rank1_bits_v>;
+		using down = Step<-1, ~rank8_bits_v>;
+		using right = Step<8, all_bits_v>;
+		using left = Step<-8, all_bits_v>;
+		using up_right = Step<9, ~rank1_bits_v>;
+		using up_left = Step<-7, ~rank1_bits_v>;
+		using down_right = Step<7, ~rank8_bits_v>;
+		using down_left = Step<-9, ~rank8_bits_v>;
+
+		using knight_steps = std::tuple
+		<
+			Step<10, ~(rank1_bits_v | rank2_bits_v)>,
+			Step<6, ~(rank7_bits_v | rank8_bits_v)>,
+			Step<-6, ~(rank1_bits_v | rank2_bits_v)>,
+			Step<-10, ~(rank7_bits_v | rank8_bits_v)>,
+			Step<17, ~rank1_bits_v>,
+			Step<15, ~rank8_bits_v>,
+			Step<-15, ~rank1_bits_v>,
+			Step<-17, ~rank8_bits_v>
+		>;
+
+		template <typename StepT, typename V>
+		inline V step(V _bits) noexcept
+		{
+			return _bits.template shift<StepT::shift_v>() & V::splat(StepT::guard_v);
+		};
+
+		/**
+		 * @brief Slides pieces in a direction until they hit a piece or the board edge.
+		 *
+		 * Uses a Kogge-Stone fill so a whole set of pieces is slid in three steps.
+		 *
+		 * @return Squares reached, including the pieces hit.
+		*/
+		template <typename StepT, typename V>
+		inline V slide(V _pieces, V _empty) noexcept
+		{
+			constexpr auto S = StepT::shift_v;
+			auto _open = _empty & V::splat(StepT::guard_v);
+			_pieces = _pieces | (_open & _pieces.template shift<S>());
+			_open = _open & _open.template shift<S>();
+			_pieces = _pieces | (_open & _pieces.template shift<S * 2>());
+			_open = _open & _open.template shift<S * 2>();
+			_pieces = _pieces | (_open & _pieces.template shift<S * 4>());
+			return step<StepT>(_pieces);
+		};
+
+		template <typename V>
+		inline V knight_attacks(V _knights) noexcept
+		{
+			return std::apply([_knights](auto... _steps)
+			{
+				return (step<decltype(_steps)>(_knights) | ...);
+			}, knight_steps{});
+		};
+
+		template <typename V>
+		inline V king_attacks(V _kings) noexcept
+		{
+			return step<up>(_kings) | step<down>(_kings) | step<right>(_kings) | step<left>(_kings) |
+				step<up_right>(_kings) | step<up_left>(_kings) | step<down_right>(_kings) | step<down_left>(_kings);
+		};
+
+		/**
+		 * @brief Looks outwards from the king in one direction for a checking or pinning piece.
+		 * @param _sliders Enemy pieces that attack along this direction.
+		 * @param _checkLine Gains the squares between the king and a checking piece, including the checking piece.
+		 * @param _checkCount Counts the checking piece.
+		 * @param _pinned Gains the pinned piece.
+		*/
+		template <typename StepT, typename V>
+		inline void look_from_king(V _king, V _empty, V _own, V _sliders, V& _checkLine, V& _checkCount, V& _pinned) noexcept
+		{
+			const auto _line = slide<StepT>(_king, _empty);
+			const auto _check = ~(_line & _sliders).zero_mask();
+			_checkLine = _checkLine | (_line & _check);
+			_checkCount = _checkCount + (_check & V::splat(1));
+
+			const auto _blocker = _line & _own;
+			const auto _pin = ~(slide<StepT>(_king, _empty | _blocker) & _sliders).zero_mask();
+			_pinned = _pinned | (_blocker & _pin);
+		};
+
+		/**
+		 * @brief Generates the legal moves of positions with white to move, en passant is left to for_each_en_passant().
+		 *
+		 * Moves are handed to the sink as sets of target squares grouped so the origin of each move
+		 * can be found from its target, so counting only needs to count bits.
+		*/
+		template <typename V, typename SinkT>
+		inline void generate(const std::array<V, 6>& _own, const std::array<V, 6>& _enemy, V _castle, SinkT& _sink)
+		{
+			const auto _ownAll = _own[0] | _own[1] | _own[2] | _own[3] | _own[4] | _own[5];
+			const auto _enemyAll = _enemy[0] | _enemy[1] | _enemy[2] | _enemy[3] | _enemy[4] | _enemy[5];
+			const auto _occupied = _ownAll | _enemyAll;
+			const auto _empty = ~_occupied;
+			const auto _king = _own[5];
+
+			const auto _enemyStraights = _enemy[3] | _enemy[4];
+			const auto _enemyDiagonals = _enemy[2] | _enemy[4];
+
+			// Squares the enemy attacks, seeing through our king so it cannot step back along a checking line
+			const auto _emptyNoKing = _empty | _king;
+			const auto _attacked =
+				step<down_left>(_enemy[0]) | step<down_right>(_enemy[0]) |
+				knight_attacks(_enemy[1]) | king_attacks(_enemy[5]) |
+				slide<up>(_enemyStraights, _emptyNoKing) | slide<down>(_enemyStraights, _emptyNoKing) |
+				slide<right>(_enemyStraights, _emptyNoKing) | slide<left>(_enemyStraights, _emptyNoKing) |
+				slide<up_right>(_enemyDiagonals, _emptyNoKing) | slide<up_left>(_enemyDiagonals, _emptyNoKing) |
+				slide<down_right>(_enemyDiagonals, _emptyNoKing) | slide<down_left>(_enemyDiagonals, _emptyNoKing);
+
+			// Checks and pins, pins are kept per line as pinned pieces may still move along their pin
+			const auto _jumpers = (knight_attacks(_king) & _enemy[1]) | ((step<up_right>(_king) | step<up_left>(_king)) & _enemy[0]);
+			auto _checkLine = _jumpers;
+			auto _checkCount = _jumpers.popcount();
+			auto _pinnedVertical = V::splat(0);
+			auto _pinnedHorizontal = V::splat(0);
+			auto _pinnedRising = V::splat(0);
+			auto _pinnedFalling = V::splat(0);
+			look_from_king<up>(_king, _empty, _ownAll, _enemyStraights, _checkLine, _checkCount, _pinnedVertical);
+			look_from_king<down>(_king, _empty, _ownAll, _enemyStraights, _checkLine, _checkCount, _pinnedVertical);
+			look_from_king<right>(_king, _empty, _ownAll, _enemyStraights, _checkLine, _checkCount, _pinnedHorizontal);
+			look_from_king<left>(_king, _empty, _ownAll, _enemyStraights, _checkLine, _checkCount, _pinnedHorizontal);
+			look_from_king<up_right>(_king, _empty, _ownAll, _enemyDiagonals, _checkLine, _checkCount, _pinnedRising);
+			look_from_king<down_left>(_king, _empty, _ownAll, _enemyDiagonals, _checkLine, _checkCount, _pinnedRising);
+			look_from_king<up_left>(_king, _empty, _ownAll, _enemyDiagonals, _checkLine, _checkCount, _pinnedFalling);
+			look_from_king<down_right>(_king, _empty, _ownAll, _enemyDiagonals, _checkLine, _checkCount, _pinnedFalling);
+
+			// Squares other pieces may move to : anywhere out of check, the check line in single check, nowhere in double check
+			const auto _evasions = _checkCount.zero_mask() | ((_checkCount ^ V::splat(1)).zero_mask() & _checkLine);
+			const auto _unpinned = ~(_pinnedVertical | _pinnedHorizontal | _pinnedRising | _pinnedFalling);
+			const auto _targets = ~_ownAll & _evasions;
+
+			_sink.king(king_attacks(_king) & ~_ownAll & ~_attacked, _king);
+
+			const auto _knights = _own[1] & _unpinned;
+			std::apply([&](auto... _steps)
+			{
+				(_sink.template shifted<decltype(_steps)::shift_v>(step<decltype(_steps)>(_knights) & _targets), ...);
+			}, knight_steps{});
+
+			const auto _straights = _own[3] | _own[4];
+			const auto _diagonals = _own[2] | _own[4];
+			const auto _vertical = _straights & (_unpinned | _pinnedVertical);
+			const auto _horizontal = _straights & (_unpinned | _pinnedHorizontal);
+			const auto _rising = _diagonals & (_unpinned | _pinnedRising);
+			const auto _falling = _diagonals & (_unpinned | _pinnedFalling);
+			_sink.template slid<up::shift_v>(slide<up>(_vertical, _empty) & _targets, _vertical);
+			_sink.template slid<down::shift_v>(slide<down>(_vertical, _empty) & _targets, _vertical);
+			_sink.template slid<right::shift_v>(slide<right>(_horizontal, _empty) & _targets, _horizontal);
+			_sink.template slid<left::shift_v>(slide<left>(_horizontal, _empty) & _targets, _horizontal);
+			_sink.template slid<up_right::shift_v>(slide<up_right>(_rising, _empty) & _targets, _rising);
+			_sink.template slid<down_left::shift_v>(slide<down_left>(_rising, _empty) & _targets, _rising);
+			_sink.template slid<up_left::shift_v>(slide<up_left>(_falling, _empty) & _targets, _falling);
+			_sink.template slid<down_right::shift_v>(slide<down_right>(_falling, _empty) & _targets, _falling);
+
+			const auto _pawns = _own[0];
+			const auto _promotionRank = V::splat(rank8_bits_v);
+			const auto _single = step<up>(_pawns & (_unpinned | _pinnedVertical)) & _empty;
+			const auto _double = step<up>(_single & V::splat(rank3_bits_v)) & _empty & _evasions;
+			const auto _pushes = _single & _evasions;
+			const auto _capturesRight = step<up_right>(_pawns & (_unpinned | _pinnedRising)) & _enemyAll & _evasions;
+			const auto _capturesLeft = step<up_left>(_pawns & (_unpinned | _pinnedFalling)) & _enemyAll & _evasions;
+			_sink.template shifted<up::shift_v>(_pushes & ~_promotionRank);
+			_sink.template promotions<up::shift_v>(_pushes & _promotionRank);
+			_sink.template shifted<up::shift_v * 2>(_double);
+			_sink.template shifted<up_right::shift_v>(_capturesRight & ~_promotionRank);
+			_sink.template promotions<up_right::shift_v>(_capturesRight & _promotionRank);
+			_sink.template shifted<up_left::shift_v>(_capturesLeft & ~_promotionRank);
+			_sink.template promotions<up_left::shift_v>(_capturesLeft & _promotionRank);
+
+			// Castling needs the right, an empty path and no attacked square from the king to its target
+			const auto _kingside =
+				((_castle & V::splat(g1_bit_v)) ^ V::splat(g1_bit_v)).zero_mask() &
+				(_occupied & V::splat(f1_bit_v | g1_bit_v)).zero_mask() &
+				(_attacked & V::splat(e1_bit_v | f1_bit_v | g1_bit_v)).zero_mask();
+			const auto _queenside =
+				((_castle & V::splat(c1_bit_v)) ^ V::splat(c1_bit_v)).zero_mask() &
+				(_occupied & V::splat(b1_bit_v | c1_bit_v | d1_bit_v)).zero_mask() &
+				(_attacked & V::splat(c1_bit_v | d1_bit_v | e1_bit_v)).zero_mask();
+			_sink.castle((_kingside & V::splat(g1_bit_v)) | (_queenside & V::splat(c1_bit_v)), _king);
+		};
+
+		/**
+		 * @brief Calls an operation for each legal en passant capture of a position with white to move.
+		 * @param _op Called with the from and to square of each capture.
+		*/
+		template <typename OpT>
+		inline void for_each_en_passant(const std::array<uint64_t, 6>& _own, const std::array<uint64_t, 6>& _enemy,
+			uint64_t _enpassant, OpT&& _op)
+		{
+			if (_enpassant == 0 || _own[5] == 0)
+			{
+				return;
+			};
+
+			const auto _target = Position::from_bits(static_cast<uint8_t>(std::countr_zero(_enpassant)));
+			const auto _king = Position::from_bits(static_cast<uint8_t>(std::countr_zero(_own[5])));
+			const auto _victim = _enpassant >> 1;
+			const auto _occupied =
+				_own[0] | _own[1] | _own[2] | _own[3] | _own[4] | _own[5] |
+				_enemy[0] | _enemy[1] | _enemy[2] | _enemy[3] | _enemy[4] | _enemy[5];
+
+			// Rare enough to check each capture by looking for attacks on the king afterwards
+			const auto _pawns = get_pawn_attacking_squares(_target, Color::black) & BitBoard(_own[0]);
+			for (const auto _from : _pawns)
+			{
+				const auto _after = BitBoard((_occupied ^ (uint64_t(1) << static_cast<uint8_t>(_from)) ^ _victim) | _enpassant);
+				const auto _attackers =
+					(get_rook_attacks(_king, _after) & BitBoard(_enemy[3] | _enemy[4])) |
+					(get_bishop_attacks(_king, _after) & BitBoard(_enemy[2] | _enemy[4])) |
+					(get_knight_attack_squares(_king) & BitBoard(_enemy[1])) |
+					(get_pawn_attacking_squares(_king, Color::white) & BitBoard(_enemy[0] & ~_victim)) |
+					(get_king_attack_squares(_king) & BitBoard(_enemy[5]));
+				if (_attackers.none())
+				{
+					_op(_from, _target);
+				};
+			};
+		};
+
+		/**
+		 * @brief Counts the moves handed out by generate().
+		*/
+		template <typename V>
+		struct CountSink
+		{
+			template <int S>
+			void shifted(V _targets) { this->count_ = this->count_ + _targets.popcount(); };
+			template <int S>
+			void promotions(V _targets) { this->count_ = this->count_ + _targets.popcount().template shift<2>(); };
+			template <int S>
+			void slid(V _targets, V) { this->count_ = this->count_ + _targets.popcount(); };
+			void king(V _targets, V) { this->count_ = this->count_ + _targets.popcount(); };
+			void castle(V _targets, V) { this->count_ = this->count_ + _targets.popcount(); };
+
+			V count_ = V::splat(0);
+		};
+
+		/**
+		 * @brief Writes the moves handed out by generate() for a single position.
+		*/
+		struct ListSink
+		{
+			using V = impl::ScalarLanes<1>;
+
+			Position position(int _square) const noexcept
+			{
+				return Position::from_bits(static_cast<uint8_t>(_square ^ this->flip_));
+			};
+
+			template <int S>
+			void shifted(V _targets)
+			{
+				for (const auto _to : BitBoard(_targets.v_[0]))
+				{
+					const auto _square = static_cast<int>(_to);
+					this->buffer_->write(Move(this->position(_square - S), this->position(_square)));
+				};
+			};
+			template <int S>
+			void promotions(V _targets)
+			{
+				for (const auto _to : BitBoard(_targets.v_[0]))
+				{
+					const auto _square = static_cast<int>(_to);
+					const auto _fromPos = this->position(_square - S);
+					const auto _toPos = this->position(_square);
+					this->buffer_->write(Move(_fromPos, _toPos, PieceType::bishop));
+					this->buffer_->write(Move(_fromPos, _toPos, PieceType::rook));
+					this->buffer_->write(Move(_fromPos, _toPos, PieceType::knight));
+					this->buffer_->write(Move(_fromPos, _toPos, PieceType::queen));
+				};
+			};
+			template <int S>
+			void slid(V _targets, V _pieces)
+			{
+				for (const auto _to : BitBoard(_targets.v_[0]))
+				{
+					// Step back along the slide to the piece that made it
+					auto _from = static_cast<int>(_to) - S;
+					while (((_pieces.v_[0] >> _from) & 1) == 0)
+					{
+						_from -= S;
+					};
+					this->buffer_->write(Move(this->position(_from), this->position(static_cast<int>(_to))));
+				};
+			};
+			void king(V _targets, V _king)
+			{
+				const auto _from = std::countr_zero(_king.v_[0]);
+				for (const auto _to : BitBoard(_targets.v_[0]))
+				{
+					this->buffer_->write(Move(this->position(_from), this->position(static_cast<int>(_to))));
+				};
+			};
+			void castle(V _targets, V _king)
+			{
+				const auto _from = std::countr_zero(_king.v_[0]);
+				for (const auto _to : BitBoard(_targets.v_[0]))
+				{
+					this->buffer_->write(Move::castle(this->position(_from), this->position(static_cast<int>(_to))));
+				};
+			};
+
+			MoveBuffer* buffer_;
+			int flip_;
+		};
+	};
+
+	BatchPosition::BatchPosition(const Board& _board) :
+		flipped_(_board.get_toplay() == Color::black)
+	{
+		const auto _player = _board.get_toplay();
+		const auto _orient = [this](uint64_t _bits)
+		{
+			return (this->flipped_) ? flip_ranks(_bits) : _bits;
+		};
+
+		for (size_t n = 0; n != this->own_.size(); ++n)
+		{
+			const auto _type = static_cast<PieceType>(n + 1);
+			this->own_[n] = _orient(_board.get_piece_bitboard(_type, _player).to_uint64());
+			this->enemy_[n] = _orient(_board.get_piece_bitboard(_type, !_player).to_uint64());
+		};
+
+		if (_board.has_enpassant_target())
+		{
+			this->enpassant_ = _orient(uint64_t(1) << static_cast<uint8_t>(_board.enpassant_target()));
+		};
+
+		uint64_t _castle = 0;
+		if (_board.get_castle_kingside_flag(Color::white)) { _castle |= g1_bit_v; };
+		if (_board.get_castle_queenside_flag(Color::white)) { _castle |= c1_bit_v; };
+		if (_board.get_castle_kingside_flag(Color::black)) { _castle |= g8_bit_v; };
+		if (_board.get_castle_queenside_flag(Color::black)) { _castle |= c8_bit_v; };
+		this->castle_ = _orient(_castle);
+	};
+
+	BatchPosition BatchPosition::after(Move _move) const
+	{
+		const auto _flip = (this->flipped_) ? 7 : 0;
+		const auto _fromBit = uint64_t(1) << (static_cast<uint8_t>(_move.from()) ^ _flip);
+		const auto _toBit = uint64_t(1) << (static_cast<uint8_t>(_move.to()) ^ _flip);
+
+		auto _own = this->own_;
+		auto _enemy = this->enemy_;
+		auto _castle = this->castle_;
+		uint64_t _enpassant = 0;
+
+		size_t _moved = 0;
+		while ((_own[_moved] & _fromBit) == 0)
+		{
+			++_moved;
+		};
+
+		for (auto& _bits : _enemy)
+		{
+			_bits &= ~_toBit;
+		};
+
+		_own[_moved] ^= _fromBit;
+		auto _placed = _moved;
+		if (_moved == 0)
+		{
+			if (_toBit & rank8_bits_v)
+			{
+				const auto _promotion = _move.promotion();
+				_placed = (_promotion == PieceType::none) ?
+					static_cast<size_t>(PieceType::queen) - 1 :
+					static_cast<size_t>(_promotion) - 1;
+			}
+			else if (_toBit == this->enpassant_)
+			{
+				_enemy[0] &= ~(_toBit >> 1);
+			}
+			else if (_toBit == (_fromBit << 2))
+			{
+				_enpassant = _fromBit << 1;
+			};
+		}
+		else if (_moved == 5)
+		{
+			if (_fromBit == e1_bit_v && _toBit == g1_bit_v)
+			{
+				_own[3] ^= h1_bit_v | f1_bit_v;
+			}
+			else if (_fromBit == e1_bit_v && _toBit == c1_bit_v)
+			{
+				_own[3] ^= a1_bit_v | d1_bit_v;
+			};
+			_castle &= ~(g1_bit_v | c1_bit_v);
+		};
+		_own[_placed] |= _toBit;
+
+		// Moving a rook or capturing one loses the matching right
+		if ((_fromBit | _toBit) & h1_bit_v) { _castle &= ~g1_bit_v; };
+		if ((_fromBit | _toBit) & a1_bit_v) { _castle &= ~c1_bit_v; };
+		if (_toBit & h8_bit_v) { _castle &= ~g8_bit_v; };
+		if (_toBit & a8_bit_v) { _castle &= ~c8_bit_v; };
+
+		// The other player moves next so swap sides and flip the board around
+		auto o = BatchPosition();
+		for (size_t n = 0; n != o.own_.size(); ++n)
+		{
+			o.own_[n] = flip_ranks(_enemy[n]);
+			o.enemy_[n] = flip_ranks(_own[n]);
+		};
+		o.enpassant_ = flip_ranks(_enpassant);
+		o.castle_ = flip_ranks(_castle);
+		o.flipped_ = !this->flipped_;
+		return o;
+	};
+
+	void BoardBatch::clear() noexcept
+	{
+		for (auto& _field : this->fields_)
+		{
+			_field.clear();
+		};
+		this->size_ = 0;
+	};
+
+	void BoardBatch::push_back(const BatchPosition& _position)
+	{
+		if (this->size_ % batch_lanes_v == 0)
+		{
+			for (auto& _field : this->fields_)
+			{
+				_field.resize(this->size_ + batch_lanes_v, 0);
+			};
+		};
+
+		const auto n = this->size_;
+		for (size_t i = 0; i != _position.own_.size(); ++i)
+		{
+			this->fields_[own_begin + i][n] = _position.own_[i];
+			this->fields_[enemy_begin + i][n] = _position.enemy_[i];
+		};
+		this->fields_[enpassant][n] = _position.enpassant_;
+		this->fields_[castle][n] = _position.castle_;
+		this->fields_[flipped][n] = _position.flipped_;
+		++this->size_;
+	};
+
+	BatchPosition BoardBatch::get(size_t _index) const
+	{
+		SCREEPFISH_ASSERT(_index < this->size_);
+		auto o = BatchPosition();
+		for (size_t i = 0; i != o.own_.size(); ++i)
+		{
+			o.own_[i] = this->fields_[own_begin + i][_index];
+			o.enemy_[i] = this->fields_[enemy_begin + i][_index];
+		};
+		o.enpassant_ = this->fields_[enpassant][_index];
+		o.castle_ = this->fields_[castle][_index];
+		o.flipped_ = this->fields_[flipped][_index] != 0;
+		return o;
+	};
+
+	void BoardBatch::count_lanes(size_t _offset, std::span<uint64_t, batch_lanes_v> _counts) const
+	{
+		using V = impl::BatchLanes;
+
+		auto _own = std::array<V, 6>{};
+		auto _enemy = std::array<V, 6>{};
+		for (size_t i = 0; i != _own.size(); ++i)
+		{
+			_own[i] = V::load(this->fields_[own_begin + i].data() + _offset);
+			_enemy[i] = V::load(this->fields_[enemy_begin + i].data() + _offset);
+		};
+
+		auto _sink = CountSink<V>();
+		generate(_own, _enemy, V::load(this->fields_[castle].data() + _offset), _sink);
+		_sink.count_.store(_counts.data());
+
+		for (size_t i = 0; i != batch_lanes_v; ++i)
+		{
+			if (this->fields_[enpassant][_offset + i] != 0)
+			{
+				const auto _position = this->get(_offset + i);
+				for_each_en_passant(_position.own_, _position.enemy_, _position.enpassant_, [&_counts, i](auto, auto)
+				{
+					++_counts[i];
+				});
+			};
+		};
+	};
+
+	void BoardBatch::count_legal_moves(std::span<uint32_t> _counts) const
+	{
+		SCREEPFISH_ASSERT(_counts.size() >= this->size_);
+		auto _lanes = std::array<uint64_t, batch_lanes_v>{};
+		for (size_t n = 0; n < this->size_; n += batch_lanes_v)
+		{
+			this->count_lanes(n, _lanes);
+			const auto _end = std::min(n + batch_lanes_v, this->size_);
+			for (size_t i = n; i != _end; ++i)
+			{
+				_counts[i] = static_cast<uint32_t>(_lanes[i - n]);
+			};
+		};
+	};
+
+	size_t BoardBatch::count_legal_moves() const
+	{
+		// Padding boards have no pieces so they add nothing
+		auto _lanes = std::array<uint64_t, batch_lanes_v>{};
+		size_t _total = 0;
+		for (size_t n = 0; n < this->size_; n += batch_lanes_v)
+		{
+			this->count_lanes(n, _lanes);
+			for (const auto _count : _lanes)
+			{
+				_total += static_cast<size_t>(_count);
+			};
+		};
+		return _total;
+	};
+
+	void BoardBatch::get_legal_moves(size_t _index, MoveBuffer& _buffer) const
+	{
+		chess::get_legal_moves(this->get(_index), _buffer);
+	};
+
+	void get_legal_moves(const BatchPosition& _position, MoveBuffer& _buffer)
+	{
+		using V = impl::ScalarLanes<1>;
+
+		auto _own = std::array<V, 6>{};
+		auto _enemy = std::array<V, 6>{};
+		for (size_t i = 0; i != _own.size(); ++i)
+		{
+			_own[i] = V::splat(_position.own_[i]);
+			_enemy[i] = V::splat(_position.enemy_[i]);
+		};
+
+		auto _sink = ListSink{ &_buffer, (_position.flipped_) ? 7 : 0 };
+		generate(_own, _enemy, V::splat(_position.castle_), _sink);
+		for_each_en_passant(_position.own_, _position.enemy_, _position.enpassant_, [&_sink](Position _from, Position _to)
+		{
+			_sink.buffer_->write(Move::en_passant(
+				_sink.position(static_cast<int>(_from)),
+				_sink.position(static_cast<int>(_to))));
+		});
+	};
+};
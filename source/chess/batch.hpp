@@ -0,0 +1,166 @@
+#pragma once
+
+/** @file */
+
+#include "board.hpp"
+#include "move.hpp"
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+	Batched move generation runs the same bitboard operations over several boards at once.
+
+	AVX2 is used to process four boards per instruction when it is available, otherwise a portable
+	scalar path is used. Define SCREEPFISH_NO_AVX2 to force the scalar path.
+*/
+#if !defined(SCREEPFISH_NO_AVX2) && defined(__AVX2__)
+	#define SCREEPFISH_BATCH_AVX2 1
+#else
+	#define SCREEPFISH_BATCH_AVX2 0
+#endif
+
+namespace chess
+{
+	/**
+	 * @brief Number of boards that batched move generation works on together.
+	*/
+	constexpr size_t batch_lanes_v = 4;
+
+	/**
+	 * @brief A single position in the form used by batched move generation.
+	 *
+	 * Positions are held from the view of the player to move. Boards with black to move are flipped
+	 * vertically so every position has white to move, which lets boards with either player to move
+	 * share the same instructions.
+	*/
+	struct BatchPosition
+	{
+		/**
+		 * @brief Gets the position reached by playing a legal move.
+		 *
+		 * Only the bitboards are updated so this is much cheaper than Board::make().
+		 *
+		 * @param _move Move to play, given in the coordinates of the original board.
+		 * @return The new position, from the view of the other player.
+		*/
+		BatchPosition after(Move _move) const;
+
+		/**
+		 * @brief Pieces of the player to move, indexed by piece type - 1.
+		*/
+		std::array<uint64_t, 6> own_{};
+
+		/**
+		 * @brief Pieces of the other player, indexed by piece type - 1.
+		*/
+		std::array<uint64_t, 6> enemy_{};
+
+		/**
+		 * @brief En passant target square, empty if there is none.
+		*/
+		uint64_t enpassant_ = 0;
+
+		/**
+		 * @brief Castling rights as the squares the kings may castle to.
+		 *
+		 * c1 and g1 for the player to move, c8 and g8 for the other player.
+		*/
+		uint64_t castle_ = 0;
+
+		/**
+		 * @brief True if the original board had black to move.
+		*/
+		bool flipped_ = false;
+
+		BatchPosition() = default;
+		explicit BatchPosition(const Board& _board);
+	};
+
+	/**
+	 * @brief Positions laid out as a struct of arrays for batched move generation.
+	 *
+	 * Each bitboard of a position lives in its own array so the same bitboard of several boards can
+	 * be loaded with a single instruction.
+	*/
+	class BoardBatch
+	{
+	public:
+
+		size_t size() const noexcept { return this->size_; };
+		bool empty() const noexcept { return this->size_ == 0; };
+
+		/**
+		 * @brief Removes all positions, keeping the allocated storage.
+		*/
+		void clear() noexcept;
+
+		void push_back(const BatchPosition& _position);
+		void push_back(const Board& _board)
+		{
+			this->push_back(BatchPosition(_board));
+		};
+
+		/**
+		 * @brief Gets a position held in the batch.
+		*/
+		BatchPosition get(size_t _index) const;
+
+		/**
+		 * @brief Counts the legal moves of each position.
+		 * @param _counts Output counts, must hold at least size() values.
+		*/
+		void count_legal_moves(std::span<uint32_t> _counts) const;
+
+		/**
+		 * @brief Counts the legal moves of all positions together.
+		*/
+		size_t count_legal_moves() const;
+
+		/**
+		 * @brief Gets the legal moves of a position held in the batch.
+		 * @param _index Index of the position.
+		 * @param _buffer Buffer to write the moves into, moves are in the coordinates of the original board.
+		*/
+		void get_legal_moves(size_t _index, MoveBuffer& _buffer) const;
+
+		BoardBatch() = default;
+
+	private:
+
+		/**
+		 * @brief Counts the legal moves of one group of batch_lanes_v positions.
+		 * @param _offset Index of the first position in the group.
+		*/
+		void count_lanes(size_t _offset, std::span<uint64_t, batch_lanes_v> _counts) const;
+
+		/**
+		 * @brief Arrays held for each position, see BatchPosition.
+		*/
+		enum Field : size_t
+		{
+			own_begin = 0,
+			enemy_begin = 6,
+			enpassant = 12,
+			castle = 13,
+			flipped = 14,
+			field_count = 15,
+		};
+
+		/**
+		 * @brief Position data, the arrays are padded with empty boards to a multiple of batch_lanes_v.
+		*/
+		std::array<std::vector<uint64_t>, field_count> fields_{};
+		size_t size_ = 0;
+	};
+
+	/**
+	 * @brief Gets the legal moves of a single position using the batched generator.
+	 * @param _position Position to generate moves for.
+	 * @param _buffer Buffer to write the moves into, moves are in the coordinates of the original board.
+	*/
+	void get_legal_moves(const BatchPosition& _position, MoveBuffer& _buffer);
+};
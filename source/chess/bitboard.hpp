@@ -4,324 +4,339 @@
 
 #include "position.hpp"
 
-#include <bitset>
+#include <bit>
+#include <cstdint>
+#include <iterator>
 #include <iostream>
 
 namespace chess
 {
-	class BitBoardCX;
-	
+	/**
+	 * @brief Set of board positions packed into a single 64 bit integer.
+	 *
+	 * Bit n is set for position index n. Positions are file major (a1 = 0, a2 = 1, ... b1 = 8) so
+	 * shifting by one moves along a file and shifting by eight moves along a rank.
+	*/
 	class BitBoard
 	{
 	private:
-		friend BitBoardCX;
-		
 		using size_type = uint64_t;
 
-		
-		constexpr size_type toindex(Position _pos) const
+		constexpr static size_type toindex(Position _pos)
 		{
 			return static_cast<size_type>(_pos);
 		};
-		constexpr size_type toindex(File _file, Rank _rank) const
+		constexpr static size_type toindex(File _file, Rank _rank)
 		{
-			return this->toindex((_file, _rank));
+			return toindex(Position(_file, _rank));
 		};
 
-		constexpr Position topos(size_type _index) const
+		constexpr static size_type bitmask(size_type _index)
 		{
-			const auto _rank = Rank(_index & 0b0000'0111);
-			const auto _file = File((_index & 0b0011'1000) >> 3);
-			return Position(_file, _rank);
-		};
-
-	public:
-
-		void set(Position _pos)
-		{
-			this->bits_.set(this->toindex(_pos));
-		};
-		void set(File _file, Rank _rank)
-		{
-			this->bits_.set(this->toindex(_file, _rank));
-		};
-		
-		void reset(Position _pos)
-		{
-			this->bits_.reset(this->toindex(_pos));
+			return size_type(1) << _index;
 		};
-		void reset(File _file, Rank _rank)
+		constexpr static size_type bitmask(Position _pos)
 		{
-			this->bits_.reset(this->toindex(_file, _rank));
+			return bitmask(toindex(_pos));
 		};
-		void reset()
+		constexpr static size_type bitmask(File _file, Rank _rank)
 		{
-			this->bits_.reset();
+			return bitmask(toindex(_file, _rank));
 		};
 
-		void set(Position _pos, bool _value)
+		constexpr static size_type rank1_bits_v = 0x0101'0101'0101'0101;
+		constexpr static size_type rank8_bits_v = rank1_bits_v << 7;
+		constexpr static size_type file_a_bits_v = 0xFF;
+
+	public:
+
+		/**
+		 * @brief Iterates the positions of the set bits, lowest index first.
+		*/
+		class iterator
 		{
-			if (_value)
-			{
-				this->set(_pos);
-			}
-			else
+		public:
+			using value_type = Position;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			constexpr Position operator*() const noexcept
 			{
-				this->reset(_pos);
+				return Position::from_bits(static_cast<uint8_t>(std::countr_zero(this->bits_)));
 			};
-		};
-		void set(File _file, Rank _rank, bool _value)
-		{
-			if (_value)
+
+			constexpr iterator& operator++() noexcept
 			{
-				this->set(_file, _rank);
-			}
-			else
+				this->bits_ &= this->bits_ - 1;
+				return *this;
+			};
+			constexpr iterator operator++(int) noexcept
 			{
-				this->reset(_file, _rank);
+				auto _old = *this;
+				++(*this);
+				return _old;
 			};
-		};
 
-		bool test(Position _pos) const
-		{
-			return this->bits_.test(this->toindex(_pos));
-		};
-		bool test(File _file, Rank _rank) const
-		{
-			return this->bits_.test(this->toindex(_file, _rank));
-		};
+			constexpr bool operator==(const iterator& rhs) const noexcept = default;
 
-		bool all() const
-		{
-			return this->bits_.all();
+			constexpr iterator() = default;
+			constexpr explicit iterator(uint64_t _bits) noexcept :
+				bits_(_bits)
+			{};
+
+		private:
+			uint64_t bits_ = 0;
 		};
-		bool any() const
+
+		constexpr iterator begin() const noexcept
 		{
-			return this->bits_.any();
+			return iterator(this->bits_);
 		};
-		bool none() const
+		constexpr iterator end() const noexcept
 		{
-			return this->bits_.none();
+			return iterator(0);
 		};
 
-		BitBoard operator~() const
-		{
-			auto& lhs = *this;
-			return BitBoard(~lhs.bits_);
-		};
 
-		BitBoard operator|(const BitBoard& rhs) const
-		{
-			auto& lhs = *this;
-			return BitBoard(lhs.bits_ | rhs.bits_);
-		};
-		BitBoard operator&(const BitBoard& rhs) const
+
+		constexpr void set(File _file, Rank _rank)
 		{
-			auto& lhs = *this;
-			return BitBoard(lhs.bits_ & rhs.bits_);
+			this->bits_ |= bitmask(_file, _rank);
 		};
-		BitBoard operator^(const BitBoard& rhs) const
+		constexpr void set(Position _pos)
 		{
-			auto& lhs = *this;
-			return BitBoard(lhs.bits_ ^ rhs.bits_);
+			this->bits_ |= bitmask(_pos);
 		};
 
-		BitBoard& operator|=(const BitBoard& rhs)
+		constexpr void reset(File _file, Rank _rank)
 		{
-			auto& lhs = *this;
-			lhs.bits_ |= rhs.bits_;
-			return lhs;
+			this->bits_ &= ~bitmask(_file, _rank);
 		};
-		BitBoard& operator&=(const BitBoard& rhs)
+		constexpr void reset(Position _pos)
 		{
-			auto& lhs = *this;
-			lhs.bits_ &= rhs.bits_;
-			return lhs;
+			this->bits_ &= ~bitmask(_pos);
 		};
-		BitBoard& operator^=(const BitBoard& rhs)
+		constexpr void reset()
 		{
-			auto& lhs = *this;
-			lhs.bits_ ^= rhs.bits_;
-			return lhs;
+			this->bits_ = 0;
 		};
 
-		bool operator==(const BitBoard& rhs) const
+		constexpr void set(File _file, Rank _rank, bool _value)
 		{
-			auto& lhs = *this;
-			return lhs.bits_ == rhs.bits_;
+			if (_value)
+			{
+				this->set(_file, _rank);
+			}
+			else
+			{
+				this->reset(_file, _rank);
+			};
 		};
-		bool operator!=(const BitBoard& rhs) const
+		constexpr void set(Position _pos, bool _value)
 		{
-			auto& lhs = *this;
-			return lhs.bits_ != rhs.bits_;
+			if (_value)
+			{
+				this->set(_pos);
+			}
+			else
+			{
+				this->reset(_pos);
+			};
 		};
 
-		BitBoard() = default;
-	private:
-		explicit BitBoard(std::bitset<64> _bits) :
-			bits_(_bits)
-		{};
-
-		std::bitset<64> bits_;
-	};
-
-	std::ostream& operator<<(std::ostream& _ostr, const BitBoard& _value);
-
-
-
-	class BitBoardCX
-	{
-	private:
-		using size_type = uint64_t;
-		
-		constexpr size_type toindex(Position _pos) const
-		{
-			return static_cast<size_type>(_pos);
-		};
-		constexpr size_type toindex(File _file, Rank _rank) const
+		constexpr bool test(File _file, Rank _rank) const
 		{
-			return this->toindex(Position(_file, _rank));
+			return (this->bits_ & bitmask(_file, _rank)) != 0;
 		};
-		
-
-		constexpr Position topos(size_type _index) const
+		constexpr bool test(Position _pos) const
 		{
-			const auto _rank = Rank(_index  & 0b0000'0111);
-			const auto _file = File((_index & 0b0011'1000) >> 3);
-			return Position(_file, _rank);
+			return (this->bits_ & bitmask(_pos)) != 0;
 		};
 
-		constexpr size_type bitmask(size_type _index) const
+		constexpr bool all() const
 		{
-			return size_type(1) << _index;
+			return this->bits_ == 0xFFFF'FFFF'FFFF'FFFF;
 		};
-		constexpr size_type bitmask(Position _pos) const
+		constexpr bool any() const
 		{
-			return this->bitmask(this->toindex(_pos));
+			return this->bits_ != 0;
 		};
-		constexpr size_type bitmask(File _file, Rank _rank) const
+		constexpr bool none() const
 		{
-			return this->bitmask(this->toindex(_file, _rank));
+			return this->bits_ == 0;
 		};
 
-	public:
-
-		operator BitBoard() const noexcept
+		/**
+		 * @brief Gets the number of set bits.
+		*/
+		constexpr int count() const noexcept
 		{
-			return BitBoard(this->bits_);
+			return std::popcount(this->bits_);
 		};
 
-		constexpr void set(File _file, Rank _rank)
+		/**
+		 * @brief Gets the set position with the lowest index, must not be empty.
+		*/
+		constexpr Position lsb() const
 		{
-			this->bits_ |= this->bitmask(_file, _rank);
+			SCREEPFISH_ASSERT(this->any());
+			return Position::from_bits(static_cast<uint8_t>(std::countr_zero(this->bits_)));
 		};
-		constexpr void set(Position _pos)
+
+		/**
+		 * @brief Gets the set position with the highest index, must not be empty.
+		*/
+		constexpr Position msb() const
 		{
-			this->bits_ |= this->bitmask(_pos);
+			SCREEPFISH_ASSERT(this->any());
+			return Position::from_bits(static_cast<uint8_t>(63 - std::countl_zero(this->bits_)));
 		};
 
-		constexpr void reset(File _file, Rank _rank)
+		/**
+		 * @brief Removes the set position with the lowest index and returns it, must not be empty.
+		*/
+		constexpr Position pop_lsb()
 		{
-			this->bits_ &= ~this->bitmask(_file, _rank);
+			const auto _pos = this->lsb();
+			this->bits_ &= this->bits_ - 1;
+			return _pos;
 		};
-		constexpr void reset()
+
+		/**
+		 * @brief Moves every set position one square in a direction, positions moved off the board are dropped.
+		 * @tparam Dir Direction to move in.
+		*/
+		template <DirectionBit Dir>
+		constexpr BitBoard shift() const noexcept
 		{
-			this->bits_ = 0;
+			using enum DirectionBit;
+			const auto b = this->bits_;
+			if constexpr (Dir == u) { return BitBoard((b << 1) & ~rank1_bits_v); }
+			else if constexpr (Dir == d) { return BitBoard((b >> 1) & ~rank8_bits_v); }
+			else if constexpr (Dir == r) { return BitBoard(b << 8); }
+			else if constexpr (Dir == l) { return BitBoard(b >> 8); }
+			else if constexpr (Dir == ur) { return BitBoard((b << 9) & ~rank1_bits_v); }
+			else if constexpr (Dir == ul) { return BitBoard((b >> 7) & ~rank1_bits_v); }
+			else if constexpr (Dir == dr) { return BitBoard((b << 7) & ~rank8_bits_v); }
+			else if constexpr (Dir == dl) { return BitBoard((b >> 9) & ~rank8_bits_v); }
+			else { return *this; };
 		};
 
-		constexpr void set(File _file, Rank _rank, bool _value)
+		/**
+		 * @brief Moves every set position one square in a direction, positions moved off the board are dropped.
+		 * @param _dir Direction to move in.
+		*/
+		constexpr BitBoard shift(DirectionBit _dir) const noexcept
 		{
-			if (_value)
+			using enum DirectionBit;
+			switch (_dir)
 			{
-				this->set(_file, _rank);
-			}
-			else
-			{
-				this->reset(_file, _rank);
+			case u: return this->shift<u>();
+			case d: return this->shift<d>();
+			case r: return this->shift<r>();
+			case l: return this->shift<l>();
+			case ur: return this->shift<ur>();
+			case ul: return this->shift<ul>();
+			case dr: return this->shift<dr>();
+			case dl: return this->shift<dl>();
+			default: return *this;
 			};
 		};
-	
-		constexpr bool test(File _file, Rank _rank) const
-		{
-			return this->bits_ & this->bitmask(_file, _rank);
-		};
-		constexpr bool test(Position _pos) const
+
+		/**
+		 * @brief Gets every position on a file.
+		*/
+		constexpr static BitBoard file_mask(File _file) noexcept
 		{
-			return this->bits_ & this->bitmask(_pos);
+			return BitBoard(file_a_bits_v << (jc::to_underlying(_file) * 8));
 		};
 
-		constexpr bool all() const
+		/**
+		 * @brief Gets every position on a rank.
+		*/
+		constexpr static BitBoard rank_mask(Rank _rank) noexcept
 		{
-			return this->bits_ == 0xFFFF'FFFF'FFFF'FFFF;
+			return BitBoard(rank1_bits_v << jc::to_underlying(_rank));
 		};
-		constexpr bool any() const
-		{
-			return this->bits_ != 0;
-		};
-		constexpr bool none() const
+
+		/**
+		 * @brief Gets a bitboard with only one position set.
+		*/
+		constexpr static BitBoard from_position(Position _pos) noexcept
 		{
-			return this->bits_ == 0;
+			return BitBoard(bitmask(_pos));
 		};
 
-		constexpr BitBoardCX operator~() const
+
+
+		constexpr BitBoard operator~() const
 		{
 			auto& lhs = *this;
-			return BitBoardCX(~lhs.bits_);
+			return BitBoard(~lhs.bits_);
 		};
 
-		constexpr BitBoardCX operator|(const BitBoardCX& rhs) const
+		constexpr BitBoard operator|(const BitBoard& rhs) const
 		{
 			auto& lhs = *this;
-			return BitBoardCX(lhs.bits_ | rhs.bits_);
+			return BitBoard(lhs.bits_ | rhs.bits_);
 		};
-		constexpr BitBoardCX operator&(const BitBoardCX& rhs) const
+		constexpr BitBoard operator&(const BitBoard& rhs) const
 		{
 			auto& lhs = *this;
-			return BitBoardCX(lhs.bits_ & rhs.bits_);
+			return BitBoard(lhs.bits_ & rhs.bits_);
 		};
-		constexpr BitBoardCX operator^(const BitBoardCX& rhs) const
+		constexpr BitBoard operator^(const BitBoard& rhs) const
 		{
 			auto& lhs = *this;
-			return BitBoardCX(lhs.bits_ ^ rhs.bits_);
+			return BitBoard(lhs.bits_ ^ rhs.bits_);
 		};
 
-		constexpr BitBoardCX& operator|=(const BitBoardCX& rhs)
+		constexpr BitBoard& operator|=(const BitBoard& rhs)
 		{
 			auto& lhs = *this;
 			lhs.bits_ |= rhs.bits_;
 			return lhs;
 		};
-		constexpr BitBoardCX& operator&=(const BitBoardCX& rhs)
+		constexpr BitBoard& operator&=(const BitBoard& rhs)
 		{
 			auto& lhs = *this;
 			lhs.bits_ &= rhs.bits_;
 			return lhs;
 		};
-		constexpr BitBoardCX& operator^=(const BitBoardCX& rhs)
+		constexpr BitBoard& operator^=(const BitBoard& rhs)
 		{
 			auto& lhs = *this;
 			lhs.bits_ ^= rhs.bits_;
 			return lhs;
 		};
 
-		constexpr bool operator==(const BitBoardCX& rhs) const
+		constexpr bool operator==(const BitBoard& rhs) const
 		{
 			auto& lhs = *this;
 			return lhs.bits_ == rhs.bits_;
 		};
-		constexpr bool operator!=(const BitBoardCX& rhs) const
+		constexpr bool operator!=(const BitBoard& rhs) const
 		{
 			auto& lhs = *this;
 			return lhs.bits_ != rhs.bits_;
 		};
 
-		constexpr BitBoardCX() = default;
-	private:
-		constexpr explicit BitBoardCX(uint64_t _bits) :
+		/**
+		 * @brief Gets the raw bits, bit n is set for position index n.
+		*/
+		constexpr uint64_t to_uint64() const noexcept
+		{
+			return this->bits_;
+		};
+
+		constexpr BitBoard() = default;
+		constexpr explicit BitBoard(uint64_t _bits) :
 			bits_(_bits)
 		{};
-		
-		uint64_t bits_;
+
+	private:
+		uint64_t bits_ = 0;
 	};
-}
 
+	std::ostream& operator<<(std::ostream& _ostr, const BitBoard& _value);
+}
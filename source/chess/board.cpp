@@ -8,8 +8,44 @@ namespace chess
 {
 	void BoardPieceAttackData::clear()
 	{
-		this->wattack_.reset();
-		this->battack_.reset();
+		for (auto& _planes : this->attackers_)
+		{
+			_planes.fill(0);
+		};
+	};
+
+	void BoardPieceAttackData::add_attacks(Color _player, BitBoard _attacks)
+	{
+		// Ripple carry add of one to every attacked position at once
+		auto _carry = _attacks.to_uint64();
+		for (auto& _plane : this->attackers_[static_cast<size_t>(_player)])
+		{
+			if (_carry == 0)
+			{
+				break;
+			};
+			const auto _next = _plane & _carry;
+			_plane ^= _carry;
+			_carry = _next;
+		};
+		SCREEPFISH_ASSERT(_carry == 0);
+	};
+
+	void BoardPieceAttackData::remove_attacks(Color _player, BitBoard _attacks)
+	{
+		// Ripple borrow subtract of one from every attacked position at once
+		auto _borrow = _attacks.to_uint64();
+		for (auto& _plane : this->attackers_[static_cast<size_t>(_player)])
+		{
+			if (_borrow == 0)
+			{
+				break;
+			};
+			const auto _next = ~_plane & _borrow;
+			_plane ^= _borrow;
+			_borrow = _next;
+		};
+		SCREEPFISH_ASSERT(_borrow == 0);
 	};
 
 	void BoardPieceAttackData::sync(const Board& _board)
@@ -17,41 +53,133 @@ namespace chess
 		// Clear old state
 		this->clear();
 
-		// Loop over pieces and set attacking positions.
-		const auto pend = _board.pend();
-		for (auto it = _board.pbegin(); it != pend; ++it)
+		const auto _occupied = _board.get_occupied_bitboard();
+		for (const auto _pos : _occupied)
 		{
-			const auto& _piece = *it;
-			
-			// Grab the attacking bitboard for the given player.
-			auto& _attackBB =
-				(_piece.color() == Color::white) ? this->wattack_ : this->battack_;
-
-			// Determine attacking squares and add to bitboard.
-			if (_piece == Piece::pawn)
-			{
-				const auto pa = get_pawn_attacking_squares(_piece.position(), _piece.color());
-				_attackBB |= pa;
-			};
+			const auto _piece = _board.get(_pos);
+			this->add_attacks(_piece.color(), get_piece_attacks(_piece, _pos, _occupied));
 		};
 	};
 
 	void BoardPieceAttackData::move(const Board& _previousBoard, Move _move)
 	{
-		// TODO : Prevent full resync.
+		this->update(_previousBoard, _move, false);
+	};
+	void BoardPieceAttackData::unmove(const Board& _previousBoard, Move _move)
+	{
+		this->update(_previousBoard, _move, true);
+	};
+
+	void BoardPieceAttackData::update(const Board& _previousBoard, Move _move, bool _undo)
+	{
+		if (!_move)
+		{
+			return;
+		};
+
+		const auto _fromPos = _move.from();
+		const auto _toPos = _move.to();
+		const auto _moved = _previousBoard.get(_fromPos);
+		SCREEPFISH_ASSERT(_moved);
+
+		// Positions the move changes along with the piece left on each, this follows Board::make()
+		auto _changedPositions = std::array<Position, 4>{};
+		auto _changedPieces = std::array<Piece, 4>{};
+		size_t _changeCount = 0;
+		const auto _change = [&](Position _pos, Piece _piece)
+		{
+			_changedPositions[_changeCount] = _pos;
+			_changedPieces[_changeCount] = _piece;
+			++_changeCount;
+		};
 
-		if (_previousBoard.get_toplay() == Color::white)
+		auto _placed = _moved;
+		if (_moved == PieceType::pawn && (_toPos.rank() == Rank::r1 || _toPos.rank() == Rank::r8))
 		{
+			_placed = Piece((_move.promotion() == PieceType::none) ? PieceType::queen : _move.promotion(), _moved.color());
+		};
+		_change(_fromPos, Piece());
+		_change(_toPos, _placed);
 
+		if (_moved == PieceType::king)
+		{
+			const auto _backRank = (_moved.color() == Color::white) ? Rank::r1 : Rank::r8;
+			if (_fromPos == Position(File::e, _backRank) && _toPos == Position(File::g, _backRank))
+			{
+				_change(Position(File::h, _backRank), Piece());
+				_change(Position(File::f, _backRank), Piece(PieceType::rook, _moved.color()));
+			}
+			else if (_fromPos == Position(File::e, _backRank) && _toPos == Position(File::c, _backRank))
+			{
+				_change(Position(File::a, _backRank), Piece());
+				_change(Position(File::d, _backRank), Piece(PieceType::rook, _moved.color()));
+			};
 		}
-		else
+		else if (_moved == PieceType::pawn && _previousBoard.has_enpassant_target() &&
+			_previousBoard.enpassant_target() == _toPos)
 		{
+			const auto _enemyPos = Position(_toPos.file(), _fromPos.rank());
+			if (_previousBoard.has_enemy_piece(_enemyPos, _moved.color()))
+			{
+				_change(_enemyPos, Piece());
+			};
+		};
 
+		auto _changed = BitBoard();
+		const auto _occupiedBefore = _previousBoard.get_occupied_bitboard();
+		auto _occupiedAfter = _occupiedBefore;
+		for (size_t n = 0; n != _changeCount; ++n)
+		{
+			_changed.set(_changedPositions[n]);
+			_occupiedAfter.set(_changedPositions[n], (bool)_changedPieces[n]);
 		};
 
-		auto nb = _previousBoard;
-		nb.move(_move);
-		this->sync(nb);
+		// Any sliding piece whose attacks change can see a position that was emptied or filled before the move
+		const auto _queens = _previousBoard.get_piece_bitboard(PieceType::queen);
+		const auto _straights = (_previousBoard.get_piece_bitboard(PieceType::rook) | _queens) & ~_changed;
+		const auto _diagonals = (_previousBoard.get_piece_bitboard(PieceType::bishop) | _queens) & ~_changed;
+		auto _sliders = BitBoard();
+		for (const auto _pos : _occupiedBefore ^ _occupiedAfter)
+		{
+			_sliders |= get_rook_attacks(_pos, _occupiedBefore) & _straights;
+			_sliders |= get_bishop_attacks(_pos, _occupiedBefore) & _diagonals;
+		};
+
+		// Undoing takes away exactly what playing the move added and adds back what it took away
+		const auto _gain = [this, _undo](Color _player, BitBoard _attacks)
+		{
+			(_undo) ? this->remove_attacks(_player, _attacks) : this->add_attacks(_player, _attacks);
+		};
+		const auto _lose = [this, _undo](Color _player, BitBoard _attacks)
+		{
+			(_undo) ? this->add_attacks(_player, _attacks) : this->remove_attacks(_player, _attacks);
+		};
+
+		// Sliders stay put so only the difference in their attacks needs counting
+		for (const auto _pos : _sliders)
+		{
+			const auto _piece = _previousBoard.get(_pos);
+			const auto _before = get_piece_attacks(_piece, _pos, _occupiedBefore);
+			const auto _after = get_piece_attacks(_piece, _pos, _occupiedAfter);
+			_lose(_piece.color(), _before & ~_after);
+			_gain(_piece.color(), _after & ~_before);
+		};
+
+		// Swap out the attacks of the pieces on the changed positions
+		for (const auto _pos : _changed)
+		{
+			if (const auto _piece = _previousBoard.get(_pos); _piece)
+			{
+				_lose(_piece.color(), get_piece_attacks(_piece, _pos, _occupiedBefore));
+			};
+		};
+		for (size_t n = 0; n != _changeCount; ++n)
+		{
+			if (const auto _piece = _changedPieces[n]; _piece)
+			{
+				_gain(_piece.color(), get_piece_attacks(_piece, _changedPositions[n], _occupiedAfter));
+			};
+		};
 	};
 
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "board.hpp"
 #include "chess.hpp"
+#include "sliding.hpp"
+#include "precompute.hpp"
 
 #include <jclib/algorithm.h>
 
@@ -12,7 +14,7 @@ namespace chess
 		std::array<std::array<char, 8>, 8> _grid{};
 		for (auto& vx : _grid) { std::ranges::fill(vx, ' '); };
 
-		for (auto& _piece : _value.pieces())
+		for (const auto _piece : _value.pieces())
 		{
 			const auto f = _piece.file();
 			const auto r = _piece.rank();
@@ -61,24 +63,85 @@ namespace chess
 
 namespace chess
 {
-	void Board::move(const Move& _move)
+	bool Board::can_capture_enpassant(Position _target) const
 	{
+		const auto _player = (_target.rank() == Rank::r3) ? Color::black : Color::white;
+		const auto _pawns = get_pawn_attacking_squares(_target, !_player) & this->get_piece_bitboard(PieceType::pawn, _player);
+		if (_pawns.none())
+		{
+			return false;
+		};
+
+		const auto _kings = this->get_piece_bitboard(PieceType::king, _player);
+		if (_kings.none())
+		{
+			return true;
+		};
+		const auto _kingPos = *_kings.begin();
+
+		// Both pawns leave the rank at once, so look for attacks on the king with the board as it would be after
+		// the capture. This also covers the capturing pawn being pinned and the king already being in check.
+		const auto _enemy = !_player;
+		const auto _pushed = Position(_target.file(), (_player == Color::black) ? Rank::r4 : Rank::r5);
+		const auto _queens = this->get_piece_bitboard(PieceType::queen, _enemy);
+		const auto _straights = this->get_piece_bitboard(PieceType::rook, _enemy) | _queens;
+		const auto _diagonals = this->get_piece_bitboard(PieceType::bishop, _enemy) | _queens;
+		auto _enemyPawns = this->get_piece_bitboard(PieceType::pawn, _enemy);
+		_enemyPawns.reset(_pushed);
+
+		for (const auto _from : _pawns)
+		{
+			auto _after = this->get_occupied_bitboard();
+			_after.reset(_from);
+			_after.reset(_pushed);
+			_after.set(_target);
+
+			const auto _attackers =
+				(get_rook_attacks(_kingPos, _after) & _straights) |
+				(get_bishop_attacks(_kingPos, _after) & _diagonals) |
+				(get_knight_attack_squares(_kingPos) & this->get_piece_bitboard(PieceType::knight, _enemy)) |
+				(get_pawn_attacking_squares(_kingPos, _player) & _enemyPawns) |
+				(get_king_attack_squares(_kingPos) & this->get_piece_bitboard(PieceType::king, _enemy));
+			if (_attackers.none())
+			{
+				return true;
+			};
+		};
+		return false;
+	};
+
+	UndoInfo Board::make(const Move& _move)
+	{
+		auto _undo = UndoInfo{};
+		_undo.enpassant_target_ = this->enpassant_target_;
+		_undo.halfmove_count_ = this->halfmove_count_;
+		_undo.castle_bits_ = this->castle_bits_;
+		_undo.last_move_ = this->last_move_;
+		_undo.hash_ = this->hash_;
+
 		// Exit early on null move
 		if (!_move) JCLIB_UNLIKELY
 		{
-			return;
+			return _undo;
 		};
 
+		// Update the extras while this is still the previous board
+		this->extras_.move(*this, _move);
+
 		// Aliasing parts to keep compatability
 		const auto _fromPos = _move.from();
 		const auto _toPos = _move.to();
 
 		const auto _oldEnpassantTarget = this->enpassant_target_;
-		this->enpassant_target_.reset();
+		this->reset_enpassant_target();
+
+		// Set once the pushed pawn is on its new square, as whether it can be captured depends on the board after the push
+		auto _newEnpassantTarget = std::optional<Position>();
 
 		{
 			const auto _from = this->get(_fromPos);
 			const auto _to = this->get(_toPos);
+			_undo.moved_ = _from;
 
 			// Castling move handling
 			if (_from == PieceType::king)
@@ -118,8 +181,8 @@ namespace chess
 				{
 					const auto _promotion = (_move.promotion() == PieceType::none) ?
 						PieceType::queen : _move.promotion();
-					this->pieces_by_pos_.at(toindex(_fromPos)) = _promotion;
-					*this->pfind(_fromPos) = _promotion;
+					this->remove_piece(_fromPos);
+					this->put_piece(Piece(_promotion, _from.color()), _fromPos);
 				};
 
 				// Enpassant
@@ -128,7 +191,7 @@ namespace chess
 					if (_fromPos.rank() == Rank::r2 &&
 						_toPos.rank() == Rank::r4)
 					{
-						this->enpassant_target_ = Position(_fromPos.file(), Rank::r3);
+						_newEnpassantTarget = Position(_fromPos.file(), Rank::r3);
 					};
 				}
 				else
@@ -136,7 +199,7 @@ namespace chess
 					if (_fromPos.rank() == Rank::r7 &&
 						_toPos.rank() == Rank::r5)
 					{
-						this->enpassant_target_ = Position(_fromPos.file(), Rank::r6);
+						_newEnpassantTarget = Position(_fromPos.file(), Rank::r6);
 					};
 				};
 			};
@@ -179,8 +242,10 @@ namespace chess
 						this->reset_castle_flag(CastleBit::bqueen);
 					};
 				};
-			}
-			else if (_to == PieceType::rook)
+			};
+
+			// Capturing a rook on its starting square removes that side's castling right
+			if (_to == PieceType::rook)
 			{
 				if (_to.color() == Color::white)
 				{
@@ -228,15 +293,26 @@ namespace chess
 			const auto _enemyPos = (_toPos == Rank::r6) ?
 				(_toPos.file(), Rank::r5) :
 				(_toPos.file(), Rank::r4);
-			if (this->pfind(_enemyPos)->color() != it->color())
+			const auto _enemy = this->get(_enemyPos);
+			if (_enemy && _enemy.color() != it->color())
 			{
-				this->erase(_enemyPos);
+				_undo.captured_ = BoardPiece(_enemy, _enemyPos);
+				this->remove_piece(_enemyPos);
 			};
 		};
 
 		// Set new piece position
+		if (const auto _captured = this->get(_toPos); _captured)
+		{
+			_undo.captured_ = BoardPiece(_captured, _toPos);
+		};
 		this->just_move_piece(_fromPos, _toPos);
 
+		if (_newEnpassantTarget)
+		{
+			this->set_enpassant_target(*_newEnpassantTarget);
+		};
+
 		// Increment move counter
 		if (this->toplay_ == Color::black)
 		{
@@ -245,32 +321,117 @@ namespace chess
 
 		// Swap to play flag
 		this->toplay_ = !this->toplay_;
+		this->hash_ ^= zobrist_keys_v.black_to_move_;
 
 		// Set the played move as the last move
 		this->set_last_move(_move);
+
+		return _undo;
 	};
 
-	void Board::set_previous_board_hash(const Board& _board)
+	void Board::unmake(const Move& _move, const UndoInfo& _undo)
 	{
-		//auto& _storage = this->last_board_hashes_;
-		//std::shift_right(_storage.begin(), _storage.end(), 1);
-		//_storage.front() = hash(_board);
+		// Null moves only touched the move history
+		if (!_move) JCLIB_UNLIKELY
+		{
+			return;
+		};
+
+		const auto _fromPos = _move.from();
+		const auto _toPos = _move.to();
+
+		// Swap back to play flag and move counter
+		this->toplay_ = !this->toplay_;
+		if (this->toplay_ == Color::black)
+		{
+			this->fullmove_count_ -= 1;
+		};
+
+		// Restore the last move
+		this->last_move_ = _undo.last_move_;
+
+		// Put the rook back if this was a castling move
+		if (_undo.moved_ == PieceType::king)
+		{
+			if (_undo.moved_.color() == Color::white && _fromPos == (File::e, Rank::r1))
+			{
+				if (_toPos == (File::c, Rank::r1))
+				{
+					this->just_move_piece((File::d, Rank::r1), (File::a, Rank::r1));
+				}
+				else if (_toPos == (File::g, Rank::r1))
+				{
+					this->just_move_piece((File::f, Rank::r1), (File::h, Rank::r1));
+				};
+			}
+			else if (_undo.moved_.color() == Color::black && _fromPos == (File::e, Rank::r8))
+			{
+				if (_toPos == (File::c, Rank::r8))
+				{
+					this->just_move_piece((File::d, Rank::r8), (File::a, Rank::r8));
+				}
+				else if (_toPos == (File::g, Rank::r8))
+				{
+					this->just_move_piece((File::f, Rank::r8), (File::h, Rank::r8));
+				};
+			};
+		};
+
+		// Move the piece back, undoing any promotion
+		this->remove_piece(_toPos);
+		this->put_piece(_undo.moved_, _fromPos);
+
+		// Put back the captured piece, en passant captures are not on the destination square
+		if (_undo.captured_)
+		{
+			this->put_piece(_undo.captured_, _undo.captured_.position());
+		};
+
+		this->enpassant_target_ = _undo.enpassant_target_;
+		this->halfmove_count_ = _undo.halfmove_count_;
+		this->castle_bits_ = _undo.castle_bits_;
+		this->hash_ = _undo.hash_;
+
+		// Now that this is the previous board again the extras can take the move back
+		this->extras_.unmove(*this, _move);
 	};
 
-	bool Board::is_repeated_move(Move _move) const
+	UndoInfo Board::make_null()
 	{
-		auto& _storage = this->last_moves_;
-		return jc::contains(_storage, _move);
+		auto _undo = UndoInfo{};
+		_undo.enpassant_target_ = this->enpassant_target_;
+		_undo.halfmove_count_ = this->halfmove_count_;
+		_undo.castle_bits_ = this->castle_bits_;
+		_undo.last_move_ = this->last_move_;
+		_undo.hash_ = this->hash_;
+
+		// No pieces move so the extras stay as they are
+		this->reset_enpassant_target();
+		++this->halfmove_count_;
+		if (this->toplay_ == Color::black)
+		{
+			this->fullmove_count_ += 1;
+		};
+		this->toplay_ = !this->toplay_;
+		this->hash_ ^= zobrist_keys_v.black_to_move_;
+		this->set_last_move(Move());
+
+		return _undo;
 	};
-	bool Board::is_last_move_repeated_move() const
+
+	void Board::unmake_null(const UndoInfo& _undo)
 	{
-		auto& _storage = this->last_moves_;
+		this->toplay_ = !this->toplay_;
+		if (this->toplay_ == Color::black)
+		{
+			this->fullmove_count_ -= 1;
+		};
 
-		// If last move is null we can return false early
-		if (!_storage.front()) { return false; };
+		this->last_move_ = _undo.last_move_;
 
-		// Just check if the player's last move is the same
-		return _storage.at(2) == _storage.front();
+		this->enpassant_target_ = _undo.enpassant_target_;
+		this->halfmove_count_ = _undo.halfmove_count_;
+		this->hash_ = _undo.hash_;
 	};
 
 }
@@ -6,7 +6,9 @@
 #include "piece.hpp"
 #include "rating.hpp"
 #include "bitboard.hpp"
+#include "zobrist.hpp"
 #include "position.hpp"
+#include "board_extras.hpp"
 
 #include "utility/number.hpp"
 #include "utility/utility.hpp"
@@ -55,6 +57,36 @@ namespace chess
 
 
 
+	/**
+	 * @brief Holds the state a move destroys so it can be taken back with Board::unmake().
+	*/
+	struct UndoInfo
+	{
+		/**
+		 * @brief Piece that was captured along with where it was, none if the move was not a capture.
+		*/
+		BoardPiece captured_{};
+
+		/**
+		 * @brief Piece that was moved, as it was before any promotion.
+		*/
+		Piece moved_{};
+
+		std::optional<Position> enpassant_target_{};
+		uint16_t halfmove_count_ = 0;
+		CastleBit castle_bits_{};
+
+		/**
+		 * @brief Last move played before the move, null if there was none.
+		*/
+		Move last_move_{};
+
+		/**
+		 * @brief Zobrist hash as it was before the move.
+		*/
+		uint64_t hash_ = 0;
+	};
+
 	/**
 	 * @brief Represents a chess board with only enough info to track game state.
 	*/
@@ -102,216 +134,197 @@ namespace chess
 			return this->pieces_by_pos_.end();
 		};
 
-	private:
+		/**
+		 * @brief Iterates the pieces on the board as BoardPieces, in position order.
+		 *
+		 * This is a view over the piece bitboards kept for code written against the old piece list,
+		 * the pieces are built on the fly so they cannot be modified through the iterator.
+		*/
+		class const_piterator
+		{
+		public:
+			using value_type = BoardPiece;
+			using reference = BoardPiece;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			/**
+			 * @brief Lets operator-> hand out a piece that only lives as long as the expression.
+			*/
+			struct pointer
+			{
+				BoardPiece piece_;
+				const BoardPiece* operator->() const noexcept
+				{
+					return &this->piece_;
+				};
+			};
+
+			BoardPiece operator*() const
+			{
+				const auto _pos = this->bits_.lsb();
+				return BoardPiece(this->board_->get(_pos), _pos);
+			};
+			pointer operator->() const
+			{
+				return pointer{ **this };
+			};
 
-		// Pieces vec iterator access
+			const_piterator& operator++() noexcept
+			{
+				this->bits_.pop_lsb();
+				return *this;
+			};
+			const_piterator operator++(int) noexcept
+			{
+				auto _old = *this;
+				++(*this);
+				return _old;
+			};
 
-		using pcontainer_type = std::array<BoardPiece, 32>;
+			bool operator==(const const_piterator& rhs) const noexcept
+			{
+				return this->bits_ == rhs.bits_;
+			};
+			bool operator!=(const const_piterator& rhs) const noexcept
+			{
+				return this->bits_ != rhs.bits_;
+			};
 
-	public:
-		using piterator = typename pcontainer_type::iterator;
-		using const_piterator = typename pcontainer_type::const_iterator;
+			const_piterator() = default;
+			const_piterator(const Board& _board, BitBoard _bits) noexcept :
+				board_(&_board),
+				bits_(_bits)
+			{};
 
-		piterator pbegin() noexcept
-		{
-			return this->pieces_.begin();
+		private:
+			const Board* board_ = nullptr;
+			BitBoard bits_{};
 		};
+		using piterator = const_piterator;
+
 		const_piterator pbegin() const noexcept
 		{
-			return this->pieces_.begin();
-		};
-		piterator pend() noexcept
-		{
-			return std::find(this->pbegin(), this->pieces_.end(), PieceType::none);
+			return const_piterator(*this, this->get_occupied_bitboard());
 		};
 		const_piterator pend() const noexcept
 		{
-			return std::find(this->pbegin(), this->pieces_.end(), PieceType::none);
+			return const_piterator(*this, BitBoard());
 		};
 
-		auto& pback()
-		{
-			return *(this->pend() - 1);
-		};
-		const auto& pback() const
+		/**
+		 * @brief Gets the piece of a particular type and color with the lowest position.
+		 * @return Iterator to the piece, or pend() if there is no such piece.
+		*/
+		const_piterator pfind(const Piece& _piece) const
 		{
-			return *(this->pend() - 1);
-		};
+			const auto _bits = this->get_piece_bitboard(_piece);
+			if (_bits.none())
+			{
+				return this->pend();
+			};
 
-		// Gets the king piece
-		const BoardPiece& get_white_king() const
-		{
-			return this->pieces_.at(0);
+			// Continue on from the found piece over the rest of the occupied positions
+			const auto _from = static_cast<uint64_t>(_bits.lsb());
+			return const_piterator(*this, this->get_occupied_bitboard() & BitBoard(~uint64_t(0) << _from));
 		};
-		const BoardPiece& get_black_king() const
+		const_piterator pfind(PieceType _type, Color _color) const
 		{
-			return this->pieces_.at(1);
+			return this->pfind(Piece(_type, _color));
 		};
-		const BoardPiece& get_king(Color _color) const
+		const_piterator pfind(const Position& _pos) const
 		{
-			if (_color == Color::white)
+			if (!this->has_piece(_pos))
 			{
-				return this->get_white_king();
-			}
-			else
-			{
-				return this->get_black_king();
+				return this->pend();
 			};
+			const auto _from = static_cast<uint64_t>(_pos);
+			return const_piterator(*this, this->get_occupied_bitboard() & BitBoard(~uint64_t(0) << _from));
 		};
 
-		// find for pieces container
-		piterator pfind(const Piece& _piece)
+		// Gets the king piece
+		BoardPiece get_white_king() const
 		{
-			if (_piece == Piece::black_king)
-			{
-				return this->pbegin() + 1;
-			}
-			else if (_piece == Piece::white_king)
-			{
-				return this->pbegin();
-			};
-			return std::find(this->pbegin(), this->pend(), _piece);
+			return this->get_king(Color::white);
 		};
-		// find for pieces container
-		const_piterator pfind(const Piece& _piece) const
+		BoardPiece get_black_king() const
 		{
-			if (_piece == Piece::black_king)
-			{
-				return this->pbegin() + 1;
-			}
-			else if (_piece == Piece::white_king)
+			return this->get_king(Color::black);
+		};
+
+		/**
+		 * @brief Gets a player's king.
+		 * @return King piece, or a null piece if the player has no king.
+		*/
+		BoardPiece get_king(Color _color) const
+		{
+			const auto _bits = this->get_piece_bitboard(PieceType::king, _color);
+			if (_bits.none())
 			{
-				return this->pbegin();
+				return BoardPiece();
 			};
-			return std::find(this->pbegin(), this->pend(), _piece);
+			return BoardPiece(PieceType::king, _color, _bits.lsb());
 		};
 
-		// find for pieces container
-		piterator pfind(PieceType _type, Color _color)
+	private:
+
+		BitBoard& color_bitboard(Color _color) noexcept
 		{
-			return this->pfind(Piece(_type, _color));
+			return (_color == Color::white) ? this->wpieces_ : this->bpieces_;
 		};
-		// find for pieces container
-		const_piterator pfind(PieceType _type, Color _color) const
+		BitBoard& type_bitboard(PieceType _type) noexcept
 		{
-			return this->pfind(Piece(_type, _color));
+			SCREEPFISH_ASSERT(_type != PieceType::none);
+			return this->type_pieces_[jc::to_underlying(_type) - 1];
 		};
 
-		// find for pieces container
-		piterator pfind(const Position& _pos)
-		{
-			return std::find(this->pbegin(), this->pend(), _pos);
-		};
-		// find for pieces container
-		const_piterator pfind(const Position& _pos) const
+		/**
+		 * @brief Places a piece on an empty position.
+		*/
+		void put_piece(Piece _piece, Position _pos)
 		{
-			return std::find(this->pbegin(), this->pend(), _pos);
+			SCREEPFISH_ASSERT(_piece && !this->has_piece(_pos));
+			this->pieces_by_pos_[this->toindex(_pos)] = _piece;
+			this->type_bitboard(_piece.type()).set(_pos);
+			this->color_bitboard(_piece.color()).set(_pos);
+			this->hash_ ^= zobrist_piece_key(_piece, _pos);
 		};
 
-	private:
-
-		void perase(piterator it)
+		/**
+		 * @brief Removes the piece on an occupied position.
+		*/
+		void remove_piece(Position _pos)
 		{
-			const auto n = this->pend() - this->pbegin();
-
-			if (it == this->pend() - 1)
-			{
-				this->pback() = BoardPiece();
-			}
-			else
-			{
-				const auto b = this->pback();
-				this->pback() = BoardPiece();
-				*it = b;
-			};
-
-			const auto n2 = this->pend() - this->pbegin();
-			if (n2 != (n - 1))
-			{
-				abort();
-			};
+			auto& _piece = this->pieces_by_pos_[this->toindex(_pos)];
+			SCREEPFISH_ASSERT(_piece);
+			this->type_bitboard(_piece.type()).reset(_pos);
+			this->color_bitboard(_piece.color()).reset(_pos);
+			this->hash_ ^= zobrist_piece_key(_piece, _pos);
+			_piece = Piece{};
 		};
 
-		void erase(const Position& _pos, piterator pIt)
+		void erase(const Position& _pos)
 		{
-			this->pieces_by_pos_.at(this->toindex(_pos)) = Piece{};
-			if (pIt != this->pend())
+			if (this->has_piece(_pos))
 			{
-				if (pIt->color() == Color::white)
-				{
-					this->wpieces_.reset(_pos);
-				}
-				else
-				{
-					this->bpieces_.reset(_pos);
-				};
-
-				this->perase(pIt);
+				this->remove_piece(_pos);
 			};
 		};
-		void erase(const Position& _pos)
-		{
-			return this->erase(_pos, this->pfind(_pos));
-		};
-
 
-		void just_move_piece(Position _from, Position _to, piterator pIt)
+		/**
+		 * @brief Moves a piece, removing any piece on the destination position.
+		*/
+		void just_move_piece(Position _from, Position _to)
 		{
-			assert(pIt != this->pend());
+			const auto _piece = this->get(_from);
+			SCREEPFISH_ASSERT(_piece);
 
-			auto& f = this->pieces_by_pos_.at(this->toindex(_from));
-			auto& t = this->pieces_by_pos_.at(this->toindex(_to));
-
-			// Remove old piece bit
-			if (pIt->color() == Color::white)
-			{
-				this->wpieces_.reset(_from);
-			}
-			else
+			if (this->has_piece(_to))
 			{
-				this->bpieces_.reset(_from);
+				this->remove_piece(_to);
 			};
-
-			// Check if destination position has a piece
-			if (t)
-			{
-				const auto toIt = this->pfind(_to);
-
-				// Remove captured piece bit
-				if (toIt->color() == Color::white)
-				{
-					this->wpieces_.reset(_to);
-				}
-				else
-				{
-					this->bpieces_.reset(_to);
-				};
-				pIt->set_position(_to);
-				this->perase(toIt);
-			}
-			else
-			{
-				pIt->set_position(_to);
-			};
-
-			// Set new piece bit
-			if (pIt->color() == Color::white)
-			{
-				this->wpieces_.set(_to);
-			}
-			else
-			{
-				this->bpieces_.set(_to);
-			};
-
-			t = f;
-			f = Piece{};
-		};
-		void just_move_piece(Position _from, Position _to)
-		{
-			const auto pIt = this->pfind(_from);
-			assert(pIt != this->pend());
-			return this->just_move_piece(_from, _to, pIt);
+			this->remove_piece(_from);
+			this->put_piece(_piece, _to);
 		};
 
 	public:
@@ -354,44 +367,20 @@ namespace chess
 			this->fullmove_count_ = 1;
 			this->halfmove_count_ = 0;
 
-			this->pieces_.fill(BoardPiece{});
+			this->type_pieces_.fill(BitBoard());
 			this->bpieces_.reset();
 			this->wpieces_.reset();
 
-			this->last_moves_.fill(jc::null);
+			this->last_move_ = jc::null;
+			this->hash_ = 0;
+			this->extras_.clear();
 		};
 
 		void new_piece(Piece _piece, Position _pos)
 		{
-			if (_piece == Piece::white_king && this->pieces_.size() > 1)
-			{
-				const auto o = this->pieces_.front();
-				assert(o != Piece::white_king);
-				this->new_piece(o, o.position());
-				this->pieces_.front() = BoardPiece(_piece, _pos);
-			}
-			else if (_piece == Piece::black_king && this->pieces_.size() > 2)
-			{
-				const auto o = this->pieces_.at(1);
-				assert(o != Piece::black_king);
-				this->new_piece(o, o.position());
-				this->pieces_.at(1) = BoardPiece(_piece, _pos);
-			}
-			else
-			{
-				*this->pend() = BoardPiece(_piece, _pos);
-			};
-
-			this->pieces_by_pos_.at(this->toindex(_pos)) = _piece;
-
-			if (_piece.color() == Color::white)
-			{
-				this->wpieces_.set(_pos);
-			}
-			else
-			{
-				this->bpieces_.set(_pos);
-			};
+			this->erase(_pos);
+			this->put_piece(_piece, _pos);
+			this->extras_.sync(*this);
 		};
 		void new_piece(PieceType _piece, Color _color, Position _pos)
 		{
@@ -453,6 +442,10 @@ namespace chess
 
 		void set_toplay(Color _toplay)
 		{
+			if (_toplay != this->toplay_)
+			{
+				this->hash_ ^= zobrist_keys_v.black_to_move_;
+			};
 			this->toplay_ = _toplay;
 		};
 
@@ -503,9 +496,42 @@ namespace chess
 		void erase_piece(Position _position)
 		{
 			this->erase(_position);
+			this->extras_.sync(*this);
 		};
 
-		void move(const Move& _move);
+		/**
+		 * @brief Plays a move, recording what is needed to take it back.
+		 * @param _move Move to play, must be legal for the player to move.
+		 * @return Undo record to pass to unmake().
+		*/
+		UndoInfo make(const Move& _move);
+
+		/**
+		 * @brief Takes back a move played with make().
+		 * @param _move Move that was played, must be the last move made.
+		 * @param _undo Undo record returned when the move was made.
+		*/
+		void unmake(const Move& _move, const UndoInfo& _undo);
+
+		/**
+		 * @brief Passes the turn to the other player without moving a piece, used by null move pruning.
+		 * 
+		 * The null move is recorded as the last move and any en passant target is lost.
+		 * 
+		 * @return Undo record to pass to unmake_null().
+		*/
+		UndoInfo make_null();
+
+		/**
+		 * @brief Takes back a null move played with make_null().
+		 * @param _undo Undo record returned when the null move was made.
+		*/
+		void unmake_null(const UndoInfo& _undo);
+
+		void move(const Move& _move)
+		{
+			this->make(_move);
+		};
 
 		void move(const PieceMove& _move)
 		{
@@ -525,9 +551,32 @@ namespace chess
 		{
 			return this->enpassant_target_.value();
 		};
+
+		/**
+		 * @brief Sets the en passant target left behind by a double pawn push.
+		 *
+		 * The target is only kept, and only hashed, when the other player can legally capture onto it. Otherwise
+		 * the same position reached with and without the double push would not share a hash or repeat.
+		 * The pieces must already be where they are after the push.
+		 *
+		 * @param _pos Position the pushed pawn skipped over.
+		*/
 		void set_enpassant_target(Position _pos)
 		{
-			this->enpassant_target_ = _pos;
+			this->reset_enpassant_target();
+			if (this->can_capture_enpassant(_pos))
+			{
+				this->hash_ ^= zobrist_enpassant_key(_pos);
+				this->enpassant_target_ = _pos;
+			};
+		};
+		void reset_enpassant_target()
+		{
+			if (this->enpassant_target_)
+			{
+				this->hash_ ^= zobrist_enpassant_key(*this->enpassant_target_);
+				this->enpassant_target_.reset();
+			};
 		};
 
 		bool get_castle_kingside_flag(Color _player) const
@@ -555,13 +604,24 @@ namespace chess
 
 	private:
 
+		/**
+		 * @brief Checks if a pawn can legally capture en passant onto a position.
+		 * @param _target Position the pushed pawn skipped over, the capturing player is the one it is in front of.
+		*/
+		bool can_capture_enpassant(Position _target) const;
+
+		void change_castle_bits(CastleBit _bits)
+		{
+			this->hash_ ^= zobrist_castle_key(this->castle_bits_) ^ zobrist_castle_key(_bits);
+			this->castle_bits_ = _bits;
+		};
 		void reset_castle_flag(CastleBit _bits)
 		{
-			this->castle_bits_ = CastleBit(this->castle_bits_ & ~_bits);
+			this->change_castle_bits(CastleBit(this->castle_bits_ & ~_bits));
 		};
 		void set_castle_flag(CastleBit _bits)
 		{
-			this->castle_bits_ = CastleBit(this->castle_bits_ | _bits);
+			this->change_castle_bits(CastleBit(this->castle_bits_ | _bits));
 		};
 		void set_castle_flag(CastleBit _bits, bool _state)
 		{
@@ -626,6 +686,62 @@ namespace chess
 		{
 			return this->wpieces_;
 		};
+		BitBoard get_occupied_bitboard() const
+		{
+			return this->wpieces_ | this->bpieces_;
+		};
+		BitBoard get_color_bitboard(Color _color) const
+		{
+			return (_color == Color::white) ? this->wpieces_ : this->bpieces_;
+		};
+
+		/**
+		 * @brief Gets the positions of a piece type for both players.
+		*/
+		BitBoard get_piece_bitboard(PieceType _type) const
+		{
+			SCREEPFISH_ASSERT(_type != PieceType::none);
+			return this->type_pieces_[jc::to_underlying(_type) - 1];
+		};
+
+		/**
+		 * @brief Gets the positions of one player's pieces of a type.
+		*/
+		BitBoard get_piece_bitboard(PieceType _type, Color _color) const
+		{
+			return this->get_piece_bitboard(_type) & this->get_color_bitboard(_color);
+		};
+		BitBoard get_piece_bitboard(Piece _piece) const
+		{
+			return this->get_piece_bitboard(_piece.type(), _piece.color());
+		};
+
+		/**
+		 * @brief Gets the zobrist hash of the position.
+		 *
+		 * Covers the pieces, the player to move, castling rights and the en passant file. It is kept
+		 * up to date as the board changes so reading it is free.
+		*/
+		uint64_t get_hash() const noexcept
+		{
+			return this->hash_;
+		};
+
+		/**
+		 * @brief Gets the additional data tracked alongside the board.
+		*/
+		const BoardExtras& get_extras() const noexcept
+		{
+			return this->extras_;
+		};
+
+		/**
+		 * @brief Gets the positions attacked by a player's pieces.
+		*/
+		BitBoard get_attacked_bitboard(Color _player) const
+		{
+			return this->extras_.get<BoardPieceAttackData>().get_direct_attacking(_player);
+		};
 
 	private:
 		
@@ -635,13 +751,9 @@ namespace chess
 		*/
 		void set_last_move(const Move& _move)
 		{
-			auto& _storage = this->last_moves_;
-			std::shift_right(_storage.begin(), _storage.end(), 1);
-			_storage.front() = _move;
+			this->last_move_ = _move;
 		};
 
-		void set_previous_board_hash(const Board& _board);
-
 	public:
 
 		/**
@@ -650,19 +762,44 @@ namespace chess
 		*/
 		Move get_last_move() const
 		{
-			return this->last_moves_.front();
+			return this->last_move_;
 		};
 
-		bool is_repeated_move(Move _move) const;
-		bool is_last_move_repeated_move() const;
 
 
 
 
 
-		const std::span<const BoardPiece> pieces() const
+		/**
+		 * @brief Range over the pieces on the board, see const_piterator.
+		*/
+		class PieceView
+		{
+		public:
+			const_piterator begin() const noexcept
+			{
+				return const_piterator(*this->board_, this->board_->get_occupied_bitboard());
+			};
+			const_piterator end() const noexcept
+			{
+				return const_piterator(*this->board_, BitBoard());
+			};
+			size_t size() const noexcept
+			{
+				return static_cast<size_t>(this->board_->get_occupied_bitboard().count());
+			};
+
+			explicit PieceView(const Board& _board) noexcept :
+				board_(&_board)
+			{};
+
+		private:
+			const Board* board_;
+		};
+
+		PieceView pieces() const
 		{
-			return std::span<const BoardPiece>(this->pbegin(), this->pend());
+			return PieceView(*this);
 		};
 		
 
@@ -671,9 +808,12 @@ namespace chess
 		Board() = default;
 
 	private:
-		//container_type pieces_;
 		std::array<Piece, 64> pieces_by_pos_{};
-		std::array<BoardPiece, 32> pieces_{};
+
+		/**
+		 * @brief Positions of each piece type for both players, indexed by piece type - 1.
+		*/
+		std::array<BitBoard, 6> type_pieces_{};
 
 		BitBoard bpieces_;
 		BitBoard wpieces_;
@@ -681,8 +821,7 @@ namespace chess
 		/**
 		 * @brief Holds the last move that was played on the board.
 		*/
-		std::array<Move, 5> last_moves_{};
-		//std::array<uint32_t, 6> last_board_hashes_{};
+		Move last_move_{};
 
 
 		std::optional<Position> enpassant_target_;
@@ -705,8 +844,18 @@ namespace chess
 		*/
 		Color toplay_ = Color::white;
 
+		/**
+		 * @brief Zobrist hash of the position, see get_hash().
+		*/
+		uint64_t hash_ = 0;
+
+		/**
+		 * @brief Additional board data, kept in step by make() and unmake().
+		*/
+		BoardExtras extras_{};
+
 	};
 
 	constexpr static auto p0 = sizeof(Board);
 
-}
\ No newline at end of file
+}
\ No newline at end of file
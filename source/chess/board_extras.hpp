@@ -0,0 +1,242 @@
+#pragma once
+
+/** @file */
+
+#include "piece.hpp"
+#include "bitboard.hpp"
+#include "position.hpp"
+
+#include <array>
+#include <tuple>
+#include <cstdint>
+
+namespace chess
+{
+	class Board;
+
+	/**
+	 * @brief Fufilled by types that can be used to track additional board info.
+	*/
+	template <typename T>
+	concept cx_additional_board_info = requires(T& v, const T& cv, const Board& _board, Move _move)
+	{
+		v.clear();
+		v.sync(_board);
+		v.move(_board, _move);
+		v.unmove(_board, _move);
+	};
+
+	/**
+	 * @brief Provides additional tracking for where pieces are attacking on a chess board.
+	 *
+	 * Each player has a map of the squares they attack along with how many of their pieces attack
+	 * each square. Playing a move only recomputes the attacks of the pieces it moves or captures and
+	 * of the sliding pieces that can see one of the squares it changes.
+	*/
+	class BoardPieceAttackData
+	{
+	public:
+
+		/**
+		 * @brief Resets the attack data to an initial state.
+		*/
+		void clear();
+
+		/**
+		 * @brief Syncs the attack data with a new board.
+		 * @param _board Board to sync with.
+		*/
+		void sync(const Board& _board);
+
+		/**
+		 * @brief Updates the tracked data to reflect a played move.
+		 *
+		 * Move legality is not checked.
+		 *
+		 * @param _previousBoard The previous board state.
+		 * @param _move Move to play.
+		*/
+		void move(const Board& _previousBoard, Move _move);
+
+		/**
+		 * @brief Takes back a move, the reverse of move().
+		 * @param _previousBoard Board state from before the move, as it is once the move is taken back.
+		 * @param _move Move being taken back.
+		*/
+		void unmove(const Board& _previousBoard, Move _move);
+
+		BitBoard get_black_direct_attacking() const
+		{
+			return this->get_direct_attacking(Color::black);
+		};
+		BitBoard get_white_direct_attacking() const
+		{
+			return this->get_direct_attacking(Color::white);
+		};
+
+		/**
+		 * @brief Gets the positions attacked by at least one of a player's pieces.
+		*/
+		BitBoard get_direct_attacking(Color _player) const
+		{
+			const auto& _planes = this->attackers_[static_cast<size_t>(_player)];
+			return BitBoard(_planes[0] | _planes[1] | _planes[2] | _planes[3] | _planes[4]);
+		};
+
+		/**
+		 * @brief Gets the number of a player's pieces attacking a position.
+		*/
+		uint8_t get_attacker_count(Color _player, Position _pos) const
+		{
+			const auto& _planes = this->attackers_[static_cast<size_t>(_player)];
+			uint8_t _count = 0;
+			for (size_t n = 0; n != _planes.size(); ++n)
+			{
+				_count |= static_cast<uint8_t>(((_planes[n] >> static_cast<size_t>(_pos)) & 1) << n);
+			};
+			return _count;
+		};
+
+
+		BoardPieceAttackData() = default;
+
+	private:
+
+		/**
+		 * @brief Applies the changes a move makes to the attacks, or takes them away again when undoing it.
+		*/
+		void update(const Board& _previousBoard, Move _move, bool _undo);
+
+		/**
+		 * @brief Counts a piece's attacks for a player.
+		*/
+		void add_attacks(Color _player, BitBoard _attacks);
+
+		/**
+		 * @brief Takes away a piece's attacks for a player.
+		*/
+		void remove_attacks(Color _player, BitBoard _attacks);
+
+		/**
+		 * @brief Number of pieces attacking each position, indexed by color.
+		 *
+		 * The counts are bit sliced : bit n of a position's count is held in plane n at the position's
+		 * bit, so a whole attack set is counted with a few bitwise operations per plane.
+		*/
+		std::array<std::array<uint64_t, 5>, 2> attackers_{};
+
+	};
+
+	namespace impl
+	{
+		/**
+		 * @brief Helper type for holding onto additional board data.
+		*/
+		template <cx_additional_board_info... Ts>
+		class BoardExtrasImpl
+		{
+		public:
+
+			/**
+			 * @brief Resets the extra data to an initial state.
+			*/
+			void clear()
+			{
+				(std::get<Ts>(this->extras_).clear(), ...);
+			};
+
+			/**
+			 * @brief Syncs the extra data with a new board.
+			 * @param _board Board to sync with.
+			*/
+			void sync(const Board& _board)
+			{
+				(std::get<Ts>(this->extras_).sync(_board), ...);
+			};
+
+			/**
+			 * @brief Updates the extra data to reflect a played move.
+			 *
+			 * Move legality is not checked.
+			 *
+			 * @param _previousBoard The previous board state.
+			 * @param _move Move to play.
+			*/
+			void move(const Board& _previousBoard, Move _move)
+			{
+				(std::get<Ts>(this->extras_).move(_previousBoard, _move), ...);
+			};
+
+			/**
+			 * @brief Takes back a move, the reverse of move().
+			 * @param _previousBoard Board state from before the move, as it is once the move is taken back.
+			 * @param _move Move being taken back.
+			*/
+			void unmove(const Board& _previousBoard, Move _move)
+			{
+				(std::get<Ts>(this->extras_).unmove(_previousBoard, _move), ...);
+			};
+
+			template <typename T>
+			auto& get() { return std::get<T>(this->extras_); };
+			template <typename T>
+			const auto& get() const { return std::get<T>(this->extras_); };
+
+			BoardExtrasImpl() = default;
+
+		private:
+			std::tuple<Ts...> extras_{};
+		};
+
+		template <>
+		class BoardExtrasImpl<>
+		{
+		public:
+
+			/**
+			 * @brief Resets the extra data to an initial state.
+			*/
+			void clear()
+			{
+			};
+
+			/**
+			 * @brief Syncs the extra data with a new board.
+			*/
+			void sync(const Board&)
+			{
+			};
+
+			/**
+			 * @brief Updates the extra data to reflect a played move.
+			 *
+			 * Move legality is not checked.
+			*/
+			void move(const Board&, Move)
+			{
+			};
+
+			/**
+			 * @brief Takes back a move, the reverse of move().
+			*/
+			void unmove(const Board&, Move)
+			{
+			};
+
+			BoardExtrasImpl() = default;
+
+		private:
+		};
+	};
+
+	/**
+	 * @brief Additional board data storage / tracking.
+	 *
+	 * The board keeps these in step with every change made to it.
+	*/
+	using BoardExtras = impl::BoardExtrasImpl
+	<
+		BoardPieceAttackData
+	>;
+
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+/** @file */
+
+#include "board.hpp"
+
+#include "utility/utility.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace chess
+{
+	/**
+	 * @brief Half-moves without a capture or pawn move after which the game is drawn.
+	*/
+	constexpr uint16_t fifty_move_rule_half_moves_v = 100;
+
+	/**
+	 * @brief Zobrist hashes of the positions that led up to a board, used to find repetitions.
+	 *
+	 * Holds the hashes of the positions before the current one, oldest first. A position can only
+	 * repeat one reached since the last capture or pawn move with the same player to move, so only
+	 * every other hash within the board's half-move clock is ever looked at. The scan starts four
+	 * half-moves back as the other player cannot undo a move, so two half-moves back never matches.
+	*/
+	class PositionHistory
+	{
+	public:
+
+		/**
+		 * @brief Adds a position, call before playing a move from it.
+		*/
+		void push(uint64_t _hash)
+		{
+			this->hashes_.push_back(_hash);
+		};
+		void push(const Board& _board)
+		{
+			this->push(_board.get_hash());
+		};
+
+		/**
+		 * @brief Removes the most recently added position, call after taking back a move.
+		*/
+		void pop()
+		{
+			SCREEPFISH_ASSERT(!this->hashes_.empty());
+			this->hashes_.pop_back();
+		};
+
+		void clear() noexcept
+		{
+			this->hashes_.clear();
+		};
+
+		size_t size() const noexcept { return this->hashes_.size(); };
+		bool empty() const noexcept { return this->hashes_.empty(); };
+
+		/**
+		 * @brief Counts how many times a board's position occurred before.
+		 * @param _board Board that follows the held positions.
+		 * @param _limit Count to stop looking at once reached.
+		 * @return Number of earlier occurrences, at most _limit.
+		*/
+		size_t count_repetitions(const Board& _board, size_t _limit = SIZE_MAX) const
+		{
+			const auto _hash = _board.get_hash();
+			const auto _reversible = std::min<size_t>(_board.get_half_move_count(), this->hashes_.size());
+			size_t _count = 0;
+			for (size_t n = 4; n <= _reversible && _count != _limit; n += 2)
+			{
+				if (this->hashes_[this->hashes_.size() - n] == _hash)
+				{
+					++_count;
+				};
+			};
+			return _count;
+		};
+
+		/**
+		 * @brief Checks if a board's position occurred before.
+		 *
+		 * Search treats a single repetition as a draw, the side that could avoid it would have done so already.
+		 *
+		 * @param _board Board that follows the held positions.
+		*/
+		bool is_repetition(const Board& _board) const
+		{
+			return this->count_repetitions(_board, 1) != 0;
+		};
+
+		/**
+		 * @brief Checks if a board is drawn by threefold repetition or the fifty move rule.
+		 * @param _board Board that follows the held positions.
+		*/
+		bool is_draw(const Board& _board) const
+		{
+			return _board.get_half_move_count() >= fifty_move_rule_half_moves_v ||
+				this->count_repetitions(_board, 2) == 2;
+		};
+
+		PositionHistory() = default;
+
+	private:
+
+		/**
+		 * @brief Hashes of the held positions, oldest first.
+		*/
+		std::vector<uint64_t> hashes_{};
+	};
+};
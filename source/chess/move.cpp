@@ -1,10 +1,12 @@
 #include "move.hpp"
 
 #include "precompute.hpp"
+#include "sliding.hpp"
 
 #include <iostream>
 
 #include <algorithm>
+#include <bit>
 
 namespace chess
 {
@@ -18,79 +20,35 @@ namespace chess
 		constexpr auto CASTLE_ABILITY_RATING = 0.001f;
 		constexpr auto DEVELOPMENT_RATING = 0.005f;
 		constexpr auto KING_MOVE_RATING = 0.0f;
+		constexpr auto KING_ZONE_ATTACK_RATING = 0.002f;
 		constexpr auto STALEMATE_RATING = 0.0f;
 
-		// Disincentivize repeating moves
-		constexpr auto REPEATED_MOVE_RATING = -0.1f;
-
 		// Draw
 		constexpr auto FIFTY_MOVE_RULE_RATING = 0.0f;
 
 	};
 
 
-	inline chess::Position find_next_piece_in_direction(const chess::Board& _board, const chess::Position& _startPos,
-		const int df, const int dr)
-	{
-		using namespace chess;
-
-		auto f = _startPos.file() + df;
-		auto r = _startPos.rank() + dr;
-
-		while (f <= File::h && r <= Rank::r8)
-		{
-			const auto p = (f, r);
-			if (!_board.is_empty(p))
-			{
-				return p;
-			};
-
-			f += df;
-			r += dr;
-		};
-
-		return _startPos;
-	};
-
-	inline void find_legal_positions_in_direction(const chess::Board& _board, const chess::Position& _startPos,
-		chess::Color _myColor, const int df, const int dr, MoveBuffer& _buffer)
+	/**
+	 * @brief Writes a move from a position to each set square in a bitboard.
+	 * @param _from Position the piece is moving from.
+	 * @param _targets Squares the piece may move to.
+	 * @param _buffer Buffer to write the moves into.
+	*/
+	inline void write_moves_to_targets(Position _from, BitBoard _targets, MoveBuffer& _buffer)
 	{
-		using namespace chess;
-
-		auto f = _startPos.file() + df;
-		auto r = _startPos.rank() + dr;
-
-		while (f <= File::h && r <= Rank::r8)
+		for (const auto _to : _targets)
 		{
-			const auto pos = (f, r);
-			if (const auto p = _board.get(pos); p)
-			{
-				if (p.color() == _myColor)
-				{
-					break;
-				}
-				else
-				{
-					_buffer.write(_startPos, pos);
-					break;
-				};
-			}
-			else
-			{
-				_buffer.write(_startPos, pos);
-			};
-
-			f += df;
-			r += dr;
+			_buffer.write(_from, _to);
 		};
 	};
 
 
 	
 	
-	consteval BitBoardCX compute_pawn_move_squares(Position _pos, Color _color)
+	consteval BitBoard compute_pawn_move_squares(Position _pos, Color _color)
 	{
-		auto bb = BitBoardCX();
+		auto bb = BitBoard();
 		if (_color == Color::white)
 		{
 			if (_pos.rank() == Rank::r2)
@@ -112,7 +70,7 @@ namespace chess
 	};
 	consteval auto compute_pawn_move_squares(Color _color)
 	{
-		std::array<BitBoardCX, 64> bbs{};
+		std::array<BitBoard, 64> bbs{};
 		for (auto& v : positions_v)
 		{
 			if (v.rank() == Rank::r1 || v.rank() == Rank::r8)
@@ -142,53 +100,6 @@ namespace chess
 
 
 
-	consteval BitBoardCX compute_knight_attack_squares(Position _pos)
-	{
-		auto bb = BitBoardCX();
-		constexpr auto _deltaPairs = std::array
-		{
-			std::pair{ 1, 2 },
-			std::pair{ 1, -2 },
-
-			std::pair{ 2, 1 },
-			std::pair{ 2, -1 },
-
-			std::pair{ -1, 2 },
-			std::pair{ -1, -2 },
-
-			std::pair{ -2, -1 },
-			std::pair{ -2, 1 },
-		};
-
-		bool _possible = false;
-		Position _nextPos{};
-		for (const auto& [df, dr] : _deltaPairs)
-		{
-			_nextPos = trynext(_pos, df, dr, _possible);
-			if (_possible)
-			{
-				bb.set(_nextPos);
-			};
-		};
-
-		return bb;
-	};
-	consteval auto compute_knight_attack_squares()
-	{
-		std::array<BitBoardCX, 64> bbs{};
-		for (auto& v : positions_v)
-		{
-			bbs[static_cast<size_t>(v)] = compute_knight_attack_squares(v);
-		};
-		return bbs;
-	};
-
-	// Precompute attack squares
-	constexpr inline auto knight_attack_squares_v = compute_knight_attack_squares();
-	constexpr inline auto get_knight_attack_squares(Position _pos)
-	{
-		return knight_attack_squares_v[static_cast<size_t>(_pos)];
-	};
 
 
 
@@ -281,7 +192,7 @@ namespace chess
 
 
 
-	consteval BitBoardCX compute_queen_attack_squares(Position _pos)
+	consteval BitBoard compute_queen_attack_squares(Position _pos)
 	{
 		return	make_rank_bits(_pos.rank()) |
 				make_file_bits(_pos.file()) |
@@ -289,7 +200,7 @@ namespace chess
 	};
 	consteval auto compute_queen_attack_squares()
 	{
-		auto _bbs = std::array<BitBoardCX, 64>{};
+		auto _bbs = std::array<BitBoard, 64>{};
 		for (const auto& _position : positions_v)
 		{
 			_bbs[static_cast<size_t>(_position)] = compute_queen_attack_squares(_position);
@@ -298,19 +209,19 @@ namespace chess
 		return _bbs;
 	};
 	constexpr inline auto queen_attack_squares_v = compute_queen_attack_squares();
-	constexpr BitBoardCX get_queen_attack_squares(Position _pos)
+	constexpr BitBoard get_queen_attack_squares(Position _pos)
 	{
 		return queen_attack_squares_v[static_cast<size_t>(_pos)];
 	};
 
 
-	consteval BitBoardCX compute_bishop_attack_squares(Position _pos)
+	consteval BitBoard compute_bishop_attack_squares(Position _pos)
 	{
 		return make_diagonal_bits(_pos);
 	};
 	consteval auto compute_bishop_attack_squares()
 	{
-		auto _bbs = std::array<BitBoardCX, 64>{};
+		auto _bbs = std::array<BitBoard, 64>{};
 		for (const auto& _position : positions_v)
 		{
 			_bbs[static_cast<size_t>(_position)] = compute_bishop_attack_squares(_position);
@@ -319,20 +230,20 @@ namespace chess
 		return _bbs;
 	};
 	constexpr inline auto bishop_attack_squares_v = compute_bishop_attack_squares();
-	constexpr BitBoardCX get_bishop_attack_squares(Position _pos)
+	constexpr BitBoard get_bishop_attack_squares(Position _pos)
 	{
 		return bishop_attack_squares_v[static_cast<size_t>(_pos)];
 	};
 
 
 
-	consteval BitBoardCX compute_rook_attack_squares(Position _pos)
+	consteval BitBoard compute_rook_attack_squares(Position _pos)
 	{
 		return make_rank_bits(_pos.rank()) | make_file_bits(_pos.file());
 	};
 	consteval auto compute_rook_attack_squares()
 	{
-		auto _bbs = std::array<BitBoardCX, 64>{};
+		auto _bbs = std::array<BitBoard, 64>{};
 		for (const auto& _position : positions_v)
 		{
 			_bbs[static_cast<size_t>(_position)] = compute_rook_attack_squares(_position);
@@ -341,7 +252,7 @@ namespace chess
 		return _bbs;
 	};
 	constexpr inline auto rook_attack_squares_v = compute_rook_attack_squares();
-	constexpr BitBoardCX get_rook_attack_squares(Position _pos)
+	constexpr BitBoard get_rook_attack_squares(Position _pos)
 	{
 		return rook_attack_squares_v[static_cast<size_t>(_pos)];
 	};
@@ -443,6 +354,7 @@ namespace chess
 
 
 
+
 	std::span<const Position> get_surrounding_positions(Position _pos)
 	{
 		return neighbors_v[static_cast<size_t>(_pos)];
@@ -505,217 +417,46 @@ namespace chess
 	{
 		using namespace chess;
 
-		// Calculate the offset from the piece to the bishop.
-		const auto _position = _byPiece.position();
-
 		// Exit early if the target piece is not on one of the attacking squares.
+		const auto _position = _byPiece.position();
+		const auto _targetPos = _piece.position();
+		if (!get_bishop_attack_squares(_position).test(_targetPos))
 		{
-			const auto _targetPos = _piece.position();
-			if (!get_bishop_attack_squares(_position).test(_targetPos))
-			{
-				return false;
-			};
-		};
-
-
-		const auto _offset = _piece.position() - _position;
-
-		// If both are the same magnitude then the bishop is on the same diagonal.
-		if (abs(_offset.delta_file()) == abs(_offset.delta_rank()))
-		{
-			const auto _dir = Offset(Direction(_offset));
-
-			auto f = _byPiece.file();
-			auto r = _byPiece.rank();
-
-			while (true)
-			{
-				f += _dir.delta_file();
-				r += _dir.delta_rank();
-				if (f > File::h || r > Rank::r8)
-				{
-					break;
-				};
-
-				const auto _nextPosition = Position(f, r);
-				if (_nextPosition == _piece.position())
-				{
-					return true;
-				}
-				else if (!_board.is_empty(_nextPosition))
-				{
-					break;
-				};
-			};
+			return false;
 		};
 
-		return false;
+		const auto _occupied = BitBoard(_board.get_occupied_bitboard());
+		return get_bishop_attacks(_position, _occupied).test(_targetPos);
 	};
 	bool is_piece_attacked_by_rook(const chess::Board& _board, const chess::BoardPiece& _piece, const chess::BoardPiece& _byPiece)
 	{
 		using namespace chess;
 
-		const auto _position = _byPiece.position();
-
 		// Exit early if not on same file / rank
-		if (!is_straight_line_between(_position, _piece.position()))
+		const auto _position = _byPiece.position();
+		const auto _targetPos = _piece.position();
+		if (!is_straight_line_between(_position, _targetPos))
 		{
 			return false;
 		};
-		
-		constexpr auto _directionPairs = std::array
-		{
-			std::pair{  0,  1 },
-			std::pair{  0, -1 },
-			std::pair{  1,  0 },
-			std::pair{ -1,  0 },
-		};
-
-		for (const auto& _direction : _directionPairs)
-		{
-			auto [df, dr] = _direction;
-			auto f = _byPiece.file();
-			auto r = _byPiece.rank();
-
-			while (true)
-			{
-				f += df;
-				r += dr;
-				if (f > File::h || r > Rank::r8)
-				{
-					break;
-				};
-
-				const auto _nextPosition = Position(f, r);
-				if (_nextPosition == _piece.position())
-				{
-					return true;
-				}
-				else if (!_board.is_empty(_nextPosition))
-				{
-					break;
-				};
-			};
-		};
-		return false;
-	};
-	
-	inline bool is_piece_attacked_by_enemy_queen(const Board& _board, const Position& _pos, const Position _enemyPos)
-	{
-		using namespace chess;
-
-		const auto _position = _pos;
-		auto _nextPosition = Position();
-		bool _possible = true;
-
-		constexpr auto _directionPairs = std::array
-		{
-			std::pair{  1,  0 },
-			std::pair{ -1,  0 },
-			std::pair{  0,  1 },
-			std::pair{  0, -1 },
-
-			std::pair{  1,  1 },
-			std::pair{ -1,  1 },
-			std::pair{  1, -1 },
-			std::pair{ -1, -1 },
-		};
-
-		for (const auto& _direction : _directionPairs)
-		{
-			int n = 1;
-			while (true)
-			{
-				auto [df, dr] = _direction;
-				df *= n;
-				dr *= n;
 
-				_nextPosition = trynext(_pos, df, dr, _possible);
-				if (_possible)
-				{
-					if (_nextPosition == _pos)
-					{
-						return true;
-					};
-
-					if (!_board.is_empty(_nextPosition))
-					{
-						break;
-					};
-				}
-				else
-				{
-					break;
-				};
-
-				++n;
-			};
-		};
-		return false;
+		const auto _occupied = BitBoard(_board.get_occupied_bitboard());
+		return get_rook_attacks(_position, _occupied).test(_targetPos);
 	};
-	
 	bool is_piece_attacked_by_queen(const chess::Board& _board, const chess::BoardPiece& _piece, const chess::BoardPiece& _byPiece)
 	{
 		using namespace chess;
 
-		const auto _position = _byPiece.position();
-		
 		// Exit early if the target piece is not on one of the attacking squares.
+		const auto _position = _byPiece.position();
+		const auto _targetPos = _piece.position();
+		if (!get_queen_attack_squares(_position).test(_targetPos))
 		{
-			const auto _targetPos = _piece.position();
-			if (!get_queen_attack_squares(_position).test(_targetPos))
-			{
-				return false;
-			};
-		};
-		
-		auto _nextPosition = Position();
-		bool _possible = true;
-
-		constexpr auto _directionPairs = std::array
-		{
-			std::pair{  1,  0 },
-			std::pair{ -1,  0 },
-			std::pair{  0,  1 },
-			std::pair{  0, -1 },
-
-			std::pair{  1,  1 },
-			std::pair{ -1,  1 },
-			std::pair{  1, -1 },
-			std::pair{ -1, -1 },
+			return false;
 		};
 
-		for (const auto& _direction : _directionPairs)
-		{
-			int n = 1;
-			while (true)
-			{
-				auto [df, dr] = _direction;
-				df *= n;
-				dr *= n;
-
-				_nextPosition = trynext(_position, df, dr, _possible);
-				if (_possible)
-				{
-					if (_nextPosition == _piece.position())
-					{
-						return true;
-					};
-
-					if (!_board.is_empty(_nextPosition))
-					{
-						break;
-					};
-				}
-				else
-				{
-					break;
-				};
-
-				++n;
-			};
-		};
-		return false;
+		const auto _occupied = BitBoard(_board.get_occupied_bitboard());
+		return get_queen_attacks(_position, _occupied).test(_targetPos);
 	};
 	bool is_piece_attacked_by_king(const chess::Board& _board, const chess::BoardPiece& _piece, const chess::BoardPiece& _byPiece)
 	{
@@ -925,64 +666,50 @@ namespace chess
 	look_on_rank:
 #endif
 
-		constexpr auto _directions = std::array
+		const auto _enemyColor = !_piece.color();
+		const auto _occupied = BitBoard(_board.get_occupied_bitboard());
+		const auto _enemies = BitBoard((_enemyColor == Color::white) ?
+			_board.get_white_piece_bitboard() : _board.get_black_piece_bitboard());
+
+		// Look along files and ranks for rooks or queens
 		{
-			std::make_pair(1, 0),
-			std::make_pair(0, 1),
-			std::make_pair(-1, 0),
-			std::make_pair(0, -1),
-			std::make_pair(1, 1),
-			std::make_pair(-1, 1),
-			std::make_pair(1, -1),
-			std::make_pair(-1, -1)
+			for (const auto _found : get_rook_attacks(_pos, _occupied) & _enemies)
+			{
+				const auto _type = _board.get(_found).type();
+				if (_type == Piece::rook || _type == Piece::queen)
+				{
+					return true;
+				};
+			};
 		};
-		constexpr size_t _diagonalsStartIndex = 4;
 
-
-		for (size_t dn = 0; dn != _directions.size(); ++dn)
+		// Look along diagonals for bishops or queens
 		{
-			const auto [df, dr] = _directions[dn];
-			const auto _found = find_next_piece_in_direction(_board, _piece.position(), df, dr);
-			if ((_found != _piece.position()) &&
-				_board.has_enemy_piece(_found, _piece.color()))
+			for (const auto _found : get_bishop_attacks(_pos, _occupied) & _enemies)
 			{
-				const auto _enemyPiece = _board.get(_found);
-
-				switch (_enemyPiece.type())
+				const auto _type = _board.get(_found).type();
+				if (_type == Piece::bishop || _type == Piece::queen)
 				{
-				case Piece::pawn:
-					if (get_pawn_attacking_squares(_found, _enemyPiece.color()).test(_pos))
-					{
-						return true;
-					};
-					break;
-				case Piece::knight:
-					break;
-				case Piece::bishop:
-					if (dn >= _diagonalsStartIndex)
-					{
-						return true;
-					};
-					break;
-				case Piece::rook:
-					if (dn < _diagonalsStartIndex)
-					{
-						return true;
-					};
-					break;
-				case Piece::queen:
 					return true;
-				case Piece::king:
-					if (is_neighboring_position(_pos, _found))
-					{
-						const auto q = is_neighboring_position(_pos, _found);
-						return true;
-					};
-					break;
 				};
 			};
 		};
 
+		// Check for neighboring pawns and kings
+		for (auto& v : get_surrounding_positions(_pos))
+		{
+			const auto _enemyPiece = _board.get(v);
+			if (_enemyPiece == Piece(Piece::king, _enemyColor))
+			{
+				return true;
+			}
+			else if (_enemyPiece == Piece(Piece::pawn, _enemyColor) &&
+				get_pawn_attacking_squares(v, _enemyColor).test(_pos))
+			{
+				return true;
+			};
+		};
+
 		// Check for knights
 		{
 			const auto _enemyKnightThreatBits = get_knight_attack_positions(_pos);
@@ -1316,6 +1043,10 @@ namespace chess
 					_buffer.write(Move(_position, _newPos, PieceType::knight));
 					_buffer.write(Move(_position, _newPos, PieceType::queen));
 				}
+				else if (_board.has_enpassant_target() && _board.enpassant_target() == _newPos)
+				{
+					_buffer.write(Move::en_passant(_position, _newPos));
+				}
 				else
 				{
 					_buffer.write(Move(_position, _newPos));
@@ -1336,6 +1067,10 @@ namespace chess
 					_buffer.write(Move(_position, _newPos, PieceType::knight));
 					_buffer.write(Move(_position, _newPos, PieceType::queen));
 				}
+				else if (_board.has_enpassant_target() && _board.enpassant_target() == _newPos)
+				{
+					_buffer.write(Move::en_passant(_position, _newPos));
+				}
 				else
 				{
 					_buffer.write(Move(_position, _newPos));
@@ -1348,21 +1083,11 @@ namespace chess
 		using namespace chess;
 
 		const auto _position = _piece.position();
-		const auto _rank = _position.rank();
-		const auto _file = _position.file();
+		const auto _friendly = BitBoard((_piece.color() == Color::white) ?
+			_board.get_white_piece_bitboard() : _board.get_black_piece_bitboard());
+		const auto _occupied = BitBoard(_board.get_occupied_bitboard());
 
-		const auto _directions = std::array
-		{
-			std::pair{ 0, 1 },
-			std::pair{ 0, -1 },
-			std::pair{ 1, 0 },
-			std::pair{ -1, 0 }
-		};
-		
-		for (auto& _direction : _directions)
-		{
-			find_legal_positions_in_direction(_board, _piece.position(), _piece.color(), _direction.first, _direction.second, _buffer);
-		};
+		write_moves_to_targets(_position, get_rook_attacks(_position, _occupied) & ~_friendly, _buffer);
 	};
 	void get_knight_moves(const chess::Board& _board, const chess::BoardPiece& _piece, MoveBuffer& _buffer, const bool _isCheck)
 	{
@@ -1437,7 +1162,7 @@ namespace chess
 			{
 				_dest = Position(File::g, Rank::r8);
 			};
-			_buffer.write(_position, _dest);
+			_buffer.write(Move::castle(_position, _dest));
 		}
 		if (can_castle_queenside(_board, _piece.color()))
 		{
@@ -1450,7 +1175,7 @@ namespace chess
 			{
 				_dest = Position(File::c, Rank::r8);
 			};
-			_buffer.write(_position, _dest);
+			_buffer.write(Move::castle(_position, _dest));
 		};
 	};
 	void get_bishop_moves(const chess::Board& _board, const chess::BoardPiece& _piece, MoveBuffer& _buffer, const bool _isCheck)
@@ -1458,46 +1183,22 @@ namespace chess
 		using namespace chess;
 
 		const auto _position = _piece.position();
-		auto _nextPosition = Position();
-		bool _possible = true;
+		const auto _friendly = BitBoard((_piece.color() == Color::white) ?
+			_board.get_white_piece_bitboard() : _board.get_black_piece_bitboard());
+		const auto _occupied = BitBoard(_board.get_occupied_bitboard());
 
-		constexpr auto _directionPairs = std::array
-		{
-			std::pair{  1,  1 },
-			std::pair{ -1,  1 },
-			std::pair{  1, -1 },
-			std::pair{ -1, -1 },
-		};
-
-		for (const auto& _direction : _directionPairs)
-		{
-			find_legal_positions_in_direction(_board, _piece.position(), _piece.color(), _direction.first, _direction.second, _buffer);
-		};
+		write_moves_to_targets(_position, get_bishop_attacks(_position, _occupied) & ~_friendly, _buffer);
 	};
 	void get_queen_moves(const chess::Board& _board, const chess::BoardPiece& _piece, MoveBuffer& _buffer, const bool _isCheck)
 	{
 		using namespace chess;
 
 		const auto _position = _piece.position();
-		auto _nextPosition = Position();
-		bool _possible = true;
-
-		constexpr auto _directionPairs = std::array
-		{
-			std::pair{  1,  0 },
-			std::pair{ -1,  0 },
-			std::pair{  0,  1 },
-			std::pair{  0, -1 },
-			std::pair{  1,  1 },
-			std::pair{ -1,  1 },
-			std::pair{  1, -1 },
-			std::pair{ -1, -1 },
-		};
+		const auto _friendly = BitBoard((_piece.color() == Color::white) ?
+			_board.get_white_piece_bitboard() : _board.get_black_piece_bitboard());
+		const auto _occupied = BitBoard(_board.get_occupied_bitboard());
 
-		for (const auto& _direction : _directionPairs)
-		{
-			find_legal_positions_in_direction(_board, _piece.position(), _piece.color(), _direction.first, _direction.second, _buffer);
-		};
+		write_moves_to_targets(_position, get_queen_attacks(_position, _occupied) & ~_friendly, _buffer);
 	};
 
 	void get_piece_moves(const chess::Board& _board, const chess::BoardPiece& _piece,
@@ -1542,183 +1243,904 @@ namespace chess
 	};
 
 
-	void get_moves(const chess::Board& _board, const chess::Color _forPlayer, MoveBuffer& _buffer, const bool _isCheck)
+	/**
+	 * @brief Bitboards for a player's pieces grouped by the way they attack.
+	*/
+	struct AttackerBits
 	{
-		auto _bufferData = std::array<chess::Move, max_moves_possible_in_any_position_v>{};
-		auto _movesBuffer = MoveBuffer(_bufferData.data(), _bufferData.data() + _bufferData.size());
+		uint64_t pawns_ = 0;
+		uint64_t knights_ = 0;
 
-		using namespace chess;
+		/**
+		 * @brief Bishops and queens.
+		*/
+		uint64_t diagonals_ = 0;
+
+		/**
+		 * @brief Rooks and queens.
+		*/
+		uint64_t straights_ = 0;
+
+		uint64_t king_ = 0;
+	};
+
+	inline AttackerBits get_attacker_bits(const chess::Board& _board, chess::Color _player)
+	{
+		const auto _queens = _board.get_piece_bitboard(PieceType::queen, _player).to_uint64();
+
+		auto _bits = AttackerBits{};
+		_bits.pawns_ = _board.get_piece_bitboard(PieceType::pawn, _player).to_uint64();
+		_bits.knights_ = _board.get_piece_bitboard(PieceType::knight, _player).to_uint64();
+		_bits.diagonals_ = _board.get_piece_bitboard(PieceType::bishop, _player).to_uint64() | _queens;
+		_bits.straights_ = _board.get_piece_bitboard(PieceType::rook, _player).to_uint64() | _queens;
+		_bits.king_ = _board.get_piece_bitboard(PieceType::king, _player).to_uint64();
+		return _bits;
+	};
+
+	/**
+	 * @brief Gets the enemy pieces attacking a square.
+	 * @param _pos Square being attacked.
+	 * @param _defender Color of the player defending the square.
+	 * @param _attackers Bitboards of the attacking player's pieces.
+	 * @param _occupied Occupied squares used to block sliding pieces.
+	 * @return Bitboard with the position of each attacking piece.
+	*/
+	inline uint64_t get_attackers_of(Position _pos, Color _defender, const AttackerBits& _attackers, uint64_t _occupied)
+	{
+		const auto _occupiedBB = BitBoard(_occupied);
+		return
+			(get_knight_attack_squares(_pos).to_uint64() & _attackers.knights_) |
+			(get_king_attack_squares(_pos).to_uint64() & _attackers.king_) |
+			(get_pawn_attacking_squares(_pos, _defender).to_uint64() & _attackers.pawns_) |
+			(get_rook_attacks(_pos, _occupiedBB).to_uint64() & _attackers.straights_) |
+			(get_bishop_attacks(_pos, _occupiedBB).to_uint64() & _attackers.diagonals_);
+	};
+
+	/**
+	 * @brief Per color constants for move generation so the kernels need no color branches.
+	*/
+	template <Color C>
+	struct PlayerTraits;
+
+	template <>
+	struct PlayerTraits<Color::white>
+	{
+		constexpr static auto up_v = DirectionBit::u;
+		constexpr static auto up_left_v = DirectionBit::ul;
+		constexpr static auto up_right_v = DirectionBit::ur;
+
+		// Position index offsets of the directions above, positions are file major
+		constexpr static int up_delta_v = 1;
+		constexpr static int up_left_delta_v = -7;
+		constexpr static int up_right_delta_v = 9;
+
+		constexpr static auto back_rank_v = Rank::r1;
+		constexpr static auto promotion_rank_v = Rank::r8;
+
+		/**
+		 * @brief Rank a pawn lands on after a single push from its starting rank.
+		*/
+		constexpr static auto double_push_rank_v = Rank::r3;
+	};
+
+	template <>
+	struct PlayerTraits<Color::black>
+	{
+		constexpr static auto up_v = DirectionBit::d;
+		constexpr static auto up_left_v = DirectionBit::dl;
+		constexpr static auto up_right_v = DirectionBit::dr;
+
+		// Position index offsets of the directions above, positions are file major
+		constexpr static int up_delta_v = -1;
+		constexpr static int up_left_delta_v = -9;
+		constexpr static int up_right_delta_v = 7;
+
+		constexpr static auto back_rank_v = Rank::r8;
+		constexpr static auto promotion_rank_v = Rank::r1;
+
+		/**
+		 * @brief Rank a pawn lands on after a single push from its starting rank.
+		*/
+		constexpr static auto double_push_rank_v = Rank::r6;
+	};
 
-		if (_board.pfind(Piece::king, _forPlayer) == _board.pend())
+	template <Color C>
+	inline bool can_castle_kingside(const chess::Board& _board, uint64_t _occupied)
+	{
+		constexpr auto rank_v = PlayerTraits<C>::back_rank_v;
+		constexpr auto king_v = Position(File::e, rank_v);
+		constexpr auto path_v = BitBoard::from_position(Position(File::f, rank_v)) | BitBoard::from_position(Position(File::g, rank_v));
+
+		if (!_board.get_castle_kingside_flag(C))
 		{
-			return;
+			return false;
+		};
+
+		// Cannot castle through other pieces.
+		if (_occupied & path_v.to_uint64())
+		{
+			return false;
 		};
 
-		const auto _bufferStart = _movesBuffer.head();
+		// Cannot castle out of, through or into check
+		return (_board.get_attacked_bitboard(!C) & (path_v | BitBoard::from_position(king_v))).none();
+	};
+	template <Color C>
+	inline bool can_castle_queenside(const chess::Board& _board, uint64_t _occupied)
+	{
+		constexpr auto rank_v = PlayerTraits<C>::back_rank_v;
+		constexpr auto king_v = Position(File::e, rank_v);
+		constexpr auto checked_path_v = BitBoard::from_position(Position(File::d, rank_v)) | BitBoard::from_position(Position(File::c, rank_v));
+		constexpr auto path_v = checked_path_v | BitBoard::from_position(Position(File::b, rank_v));
+
+		if (!_board.get_castle_queenside_flag(C))
 		{
-			const auto _end = _board.pend();
-			for (auto it = _board.pbegin(); it != _end; ++it)
+			return false;
+		};
+
+		// Cannot castle through other pieces.
+		if (_occupied & path_v.to_uint64())
+		{
+			return false;
+		};
+
+		// Cannot castle out of, through or into check, the b-file square only needs to be empty
+		return (_board.get_attacked_bitboard(!C) & (checked_path_v | BitBoard::from_position(king_v))).none();
+	};
+
+	/**
+	 * @brief Writes a pawn move to each target square, the pawn is found by stepping back from the target.
+	 * @param _delta Position index offset the pawns moved by.
+	*/
+	inline void write_pawn_moves_to_targets(BitBoard _targets, int _delta, MoveBuffer& _buffer)
+	{
+		for (const auto _to : _targets)
+		{
+			const auto _from = Position::from_bits(static_cast<uint8_t>(static_cast<int>(_to) - _delta));
+			_buffer.write(Move(_from, _to));
+		};
+	};
+
+	/**
+	 * @brief Writes the promotions of a pawn move, queen promotions are generated with the captures and
+	 * underpromotions with the quiet moves.
+	*/
+	template <GenType G>
+	inline void write_pawn_promotions(BitBoard _targets, int _delta, MoveBuffer& _buffer)
+	{
+		for (const auto _to : _targets)
+		{
+			const auto _from = Position::from_bits(static_cast<uint8_t>(static_cast<int>(_to) - _delta));
+			if constexpr (G != GenType::captures)
+			{
+				_buffer.write(Move(_from, _to, PieceType::bishop));
+				_buffer.write(Move(_from, _to, PieceType::rook));
+				_buffer.write(Move(_from, _to, PieceType::knight));
+			};
+			if constexpr (G != GenType::quiets)
+			{
+				_buffer.write(Move(_from, _to, PieceType::queen));
+			};
+		};
+	};
+
+	/**
+	 * @brief Generates the legal moves for a set of pawns that share the same legal target squares.
+	 * @param _pawns Pawns to move.
+	 * @param _legal Squares the pawns may land on without leaving the king in check.
+	*/
+	template <Color C, GenType G>
+	inline void get_legal_pawn_moves(const chess::Board& _board, BitBoard _pawns, Position _kingPos,
+		const AttackerBits& _enemies, uint64_t _enemyBits, uint64_t _occupied, uint64_t _legal, MoveBuffer& _buffer)
+	{
+		using traits = PlayerTraits<C>;
+		constexpr auto promotion_rank_v = BitBoard::rank_mask(traits::promotion_rank_v);
+		constexpr auto double_push_rank_v = BitBoard::rank_mask(traits::double_push_rank_v);
+
+		const auto _empty = ~BitBoard(_occupied);
+		const auto _legalBB = BitBoard(_legal);
+		const auto _enemyBB = BitBoard(_enemyBits);
+
+		// Pushes, a double push must pass through an empty square
+		const auto _singlePushes = _pawns.shift<traits::up_v>() & _empty;
+		if constexpr (G != GenType::captures)
+		{
+			const auto _doublePushes = (_singlePushes & double_push_rank_v).template shift<traits::up_v>() & _empty;
+			write_pawn_moves_to_targets(_singlePushes & _legalBB & ~promotion_rank_v, traits::up_delta_v, _buffer);
+			write_pawn_moves_to_targets(_doublePushes & _legalBB, traits::up_delta_v * 2, _buffer);
+		};
+
+		// Captures
+		const auto _leftCaptures = _pawns.shift<traits::up_left_v>() & _enemyBB & _legalBB;
+		const auto _rightCaptures = _pawns.shift<traits::up_right_v>() & _enemyBB & _legalBB;
+		if constexpr (G != GenType::quiets)
+		{
+			write_pawn_moves_to_targets(_leftCaptures & ~promotion_rank_v, traits::up_left_delta_v, _buffer);
+			write_pawn_moves_to_targets(_rightCaptures & ~promotion_rank_v, traits::up_right_delta_v, _buffer);
+		};
+
+		// Promotions
+		write_pawn_promotions<G>(_singlePushes & _legalBB & promotion_rank_v, traits::up_delta_v, _buffer);
+		write_pawn_promotions<G>(_leftCaptures & promotion_rank_v, traits::up_left_delta_v, _buffer);
+		write_pawn_promotions<G>(_rightCaptures & promotion_rank_v, traits::up_right_delta_v, _buffer);
+
+		// Enpassant
+		if constexpr (G != GenType::quiets)
+		{
+			if (_board.has_enpassant_target())
 			{
-				if (it->color() == _forPlayer)
+				const auto _target = _board.enpassant_target();
+				const auto _targetBit = uint64_t(1) << static_cast<size_t>(_target);
+				const auto _capturedPos = Position::from_bits(static_cast<uint8_t>(static_cast<int>(_target) - traits::up_delta_v));
+				const auto _capturedBit = uint64_t(1) << static_cast<size_t>(_capturedPos);
+
+				// Must either block / capture the checking piece, the captured pawn may be the one giving check.
+				if (_legal & (_targetBit | _capturedBit))
 				{
-					get_piece_moves(_board, *it, _movesBuffer, _isCheck);
+					for (const auto _from : get_pawn_attacking_squares(_target, !C) & _pawns)
+					{
+						// Both pawns leave the rank at once, so look for a slider revealed on the king with the
+						// board as it would be after the capture. This also covers the moving pawn being pinned.
+						const auto _after = BitBoard((_occupied ^ (uint64_t(1) << static_cast<size_t>(_from)) ^ _capturedBit) | _targetBit);
+						const auto _revealed =
+							(get_rook_attacks(_kingPos, _after).to_uint64() & _enemies.straights_) |
+							(get_bishop_attacks(_kingPos, _after).to_uint64() & _enemies.diagonals_);
+						if (_revealed == 0)
+						{
+							_buffer.write(Move::en_passant(_from, _target));
+						};
+					};
 				};
 			};
 		};
-		const auto _bufferEnd = _movesBuffer.head();
+	};
+
+	/**
+	 * @brief Gets the squares a knight, bishop, rook or queen attacks.
+	*/
+	template <PieceType T>
+	inline BitBoard get_piece_attack_squares(Position _pos, BitBoard _occupied)
+	{
+		if constexpr (T == PieceType::knight)
+		{
+			return get_knight_attack_squares(_pos);
+		}
+		else if constexpr (T == PieceType::bishop)
+		{
+			return get_bishop_attacks(_pos, _occupied);
+		}
+		else if constexpr (T == PieceType::rook)
+		{
+			return get_rook_attacks(_pos, _occupied);
+		}
+		else
+		{
+			static_assert(T == PieceType::queen);
+			return get_queen_attacks(_pos, _occupied);
+		};
+	};
 
-		for (auto p = _bufferStart; p != _bufferEnd; ++p)
+	/**
+	 * @brief Generates the legal moves for each of a player's knights, bishops, rooks or queens.
+	 * @param _targets Squares the pieces may land on without leaving the king in check.
+	*/
+	template <Color C, PieceType T>
+	inline void get_legal_piece_moves(const chess::Board& _board, Position _kingPos, uint64_t _pinned,
+		BitBoard _occupied, BitBoard _targets, MoveBuffer& _buffer)
+	{
+		auto _pieces = _board.get_piece_bitboard(T, C);
+		if constexpr (T == PieceType::knight)
 		{
-			if (!would_move_cause_check(_board, *p, _forPlayer))
+			// A pinned knight can never stay on the line it is pinned on
+			_pieces &= ~BitBoard(_pinned);
+		};
+
+		for (const auto _position : _pieces)
+		{
+			// Pinned pieces may only move along the line they are pinned on
+			auto _legal = _targets;
+			if (_pinned & (uint64_t(1) << static_cast<size_t>(_position)))
 			{
-				_buffer.write(*p);
+				_legal &= get_line_through(_kingPos, _position);
 			};
+			write_moves_to_targets(_position, get_piece_attack_squares<T>(_position, _occupied) & _legal, _buffer);
 		};
 	};
-	
-	std::vector<Move> get_moves(const chess::Board& _board, const chess::Color _forPlayer)
+
+	/**
+	 * @brief Checks if any of a player's knights, bishops, rooks or queens has a legal move.
+	 * @param _pinned Pieces pinned to the king, these may only move along their pin line.
+	 * @param _frozen Pieces that cannot move at all.
+	 * @param _targets Squares the pieces may land on without leaving the king in check.
+	*/
+	template <Color C, PieceType T>
+	inline bool has_legal_piece_move(const chess::Board& _board, Position _kingPos, uint64_t _pinned, uint64_t _frozen,
+		BitBoard _occupied, BitBoard _targets)
 	{
-		auto _data = std::vector<Move>(max_moves_possible_in_any_position_v, Move{});
-		auto _buffer = chess::MoveBuffer(_data.data(), _data.data() + _data.size());
-		get_moves(_board, _forPlayer, _buffer);
-		_data.resize(_buffer.head() - _data.data());
-		return _data;
+		for (const auto _position : _board.get_piece_bitboard(T, C) & ~BitBoard(_frozen))
+		{
+			auto _legal = _targets;
+			if (_pinned & (uint64_t(1) << static_cast<size_t>(_position)))
+			{
+				_legal &= get_line_through(_kingPos, _position);
+			};
+			if ((get_piece_attack_squares<T>(_position, _occupied) & _legal).any())
+			{
+				return true;
+			};
+		};
+		return false;
 	};
 
+	template <Color C, GenType G>
+	void get_moves(const chess::Board& _board, MoveBuffer& _buffer)
+	{
+		using namespace chess;
 
+		if constexpr (G == GenType::checks)
+		{
+			// Checking moves are rare enough that they are picked out of the full move list
+			auto _movesData = std::array<Move, max_moves_possible_in_any_position_v>{};
+			auto _moves = MoveBuffer(_movesData);
+			get_moves<C, GenType::all>(_board, _moves);
+			for (auto it = _movesData.data(); it != _moves.head(); ++it)
+			{
+				if (gives_check(_board, *it))
+				{
+					_buffer.write(*it);
+				};
+			};
+			return;
+		};
 
+		const auto _kingBits = _board.get_piece_bitboard(PieceType::king, C);
+		if (_kingBits.none())
+		{
+			return;
+		};
 
-	bool has_legal_moves_from_check(const Board& _board, Color _player)
-	{
-		auto _bufferData = std::array<Move, 32>{};
-		for (auto& v : _board.pieces())
+		const auto _kingPos = _kingBits.lsb();
+		const auto _kingBit = _kingBits.to_uint64();
+
+		const auto _friendlyBits = _board.get_color_bitboard(C).to_uint64();
+		const auto _enemyBits = _board.get_color_bitboard(!C).to_uint64();
+		const auto _occupied = _friendlyBits | _enemyBits;
+
+		const auto _enemies = get_attacker_bits(_board, !C);
+		const auto _checkers = get_attackers_of(_kingPos, C, _enemies, _occupied);
+		SCREEPFISH_ASSERT(G != GenType::evasions || _checkers != 0);
+
+		// Squares each kind of generation may move onto, before taking checks and pins into account
+		auto _targets = ~_friendlyBits;
+		if constexpr (G == GenType::captures)
+		{
+			_targets = _enemyBits;
+		}
+		else if constexpr (G == GenType::quiets)
+		{
+			_targets = ~_occupied;
+		};
+
+		// King moves, the king is lifted off the board so it cannot step back along a checking slider's ray.
 		{
-			if (v.color() == _player)
+			const auto _occupiedWithoutKing = _occupied & ~_kingBit;
+			for (const auto _to : get_king_attack_squares(_kingPos) & BitBoard(_targets))
+			{
+				if (get_attackers_of(_to, C, _enemies, _occupiedWithoutKing) == 0)
+				{
+					_buffer.write(_kingPos, _to);
+				};
+			};
+
+			if constexpr (G == GenType::all || G == GenType::quiets)
 			{
-				auto _buffer = MoveBuffer(_bufferData.data(), _bufferData.data() + _bufferData.size());
-				const auto _bufferStart = _buffer.head();
-				get_piece_moves(_board, v, _buffer, true);
-				const auto _bufferEnd = _buffer.head();
-				for (auto p = _bufferStart; p != _bufferEnd; ++p)
+				if (_checkers == 0)
 				{
-					auto _futureBoard = _board;
-					_futureBoard.move(*p);
-					if (!is_check(_futureBoard, _player))
+					constexpr auto rank_v = PlayerTraits<C>::back_rank_v;
+					if (can_castle_kingside<C>(_board, _occupied))
 					{
-						return true;
+						_buffer.write(Move::castle(_kingPos, Position(File::g, rank_v)));
+					};
+					if (can_castle_queenside<C>(_board, _occupied))
+					{
+						_buffer.write(Move::castle(_kingPos, Position(File::c, rank_v)));
 					};
 				};
 			};
 		};
-		return false;
+
+		// Only the king can move out of double check
+		if (std::popcount(_checkers) > 1)
+		{
+			return;
+		};
+
+		// Squares that a non-king piece must land on to resolve a check
+		auto _checkMask = ~uint64_t(0);
+		if (_checkers != 0)
+		{
+			const auto _checkerPos = Position::from_bits(static_cast<uint8_t>(std::countr_zero(_checkers)));
+			_checkMask = _checkers | get_squares_between(_kingPos, _checkerPos).to_uint64();
+		};
+
+		// Find friendly pieces pinned to the king
+		auto _pinned = uint64_t(0);
+		{
+			const auto _empty = BitBoard(0);
+			const auto _snipers = BitBoard(
+				(get_rook_attacks(_kingPos, _empty).to_uint64() & _enemies.straights_) |
+				(get_bishop_attacks(_kingPos, _empty).to_uint64() & _enemies.diagonals_));
+			for (const auto _sniperPos : _snipers)
+			{
+				const auto _blockers = get_squares_between(_kingPos, _sniperPos).to_uint64() & _occupied;
+				if (std::popcount(_blockers) == 1)
+				{
+					_pinned |= _blockers & _friendlyBits;
+				};
+			};
+		};
+
+		// Pawns, the unpinned ones are moved all at once
+		{
+			const auto _pawns = _board.get_piece_bitboard(PieceType::pawn, C);
+			get_legal_pawn_moves<C, G>(_board, _pawns & ~BitBoard(_pinned), _kingPos, _enemies, _enemyBits, _occupied, _checkMask, _buffer);
+			for (const auto _position : _pawns & BitBoard(_pinned))
+			{
+				const auto _legal = _checkMask & get_line_through(_kingPos, _position).to_uint64();
+				get_legal_pawn_moves<C, G>(_board, BitBoard::from_position(_position), _kingPos, _enemies, _enemyBits, _occupied, _legal, _buffer);
+			};
+		};
+
+		const auto _occupiedBB = BitBoard(_occupied);
+		const auto _pieceTargets = BitBoard(_targets & _checkMask);
+		get_legal_piece_moves<C, PieceType::knight>(_board, _kingPos, _pinned, _occupiedBB, _pieceTargets, _buffer);
+		get_legal_piece_moves<C, PieceType::bishop>(_board, _kingPos, _pinned, _occupiedBB, _pieceTargets, _buffer);
+		get_legal_piece_moves<C, PieceType::rook>(_board, _kingPos, _pinned, _occupiedBB, _pieceTargets, _buffer);
+		get_legal_piece_moves<C, PieceType::queen>(_board, _kingPos, _pinned, _occupiedBB, _pieceTargets, _buffer);
 	};
 
+	template void get_moves<Color::white, GenType::all>(const chess::Board& _board, MoveBuffer& _buffer);
+	template void get_moves<Color::white, GenType::captures>(const chess::Board& _board, MoveBuffer& _buffer);
+	template void get_moves<Color::white, GenType::quiets>(const chess::Board& _board, MoveBuffer& _buffer);
+	template void get_moves<Color::white, GenType::evasions>(const chess::Board& _board, MoveBuffer& _buffer);
+	template void get_moves<Color::white, GenType::checks>(const chess::Board& _board, MoveBuffer& _buffer);
+	template void get_moves<Color::black, GenType::all>(const chess::Board& _board, MoveBuffer& _buffer);
+	template void get_moves<Color::black, GenType::captures>(const chess::Board& _board, MoveBuffer& _buffer);
+	template void get_moves<Color::black, GenType::quiets>(const chess::Board& _board, MoveBuffer& _buffer);
+	template void get_moves<Color::black, GenType::evasions>(const chess::Board& _board, MoveBuffer& _buffer);
+	template void get_moves<Color::black, GenType::checks>(const chess::Board& _board, MoveBuffer& _buffer);
 
+	template <Color C>
+	inline void get_moves_for(const chess::Board& _board, MoveBuffer& _buffer, GenType _type)
+	{
+		switch (_type)
+		{
+		case GenType::all:
+			get_moves<C, GenType::all>(_board, _buffer);
+			break;
+		case GenType::captures:
+			get_moves<C, GenType::captures>(_board, _buffer);
+			break;
+		case GenType::quiets:
+			get_moves<C, GenType::quiets>(_board, _buffer);
+			break;
+		case GenType::evasions:
+			get_moves<C, GenType::evasions>(_board, _buffer);
+			break;
+		case GenType::checks:
+			get_moves<C, GenType::checks>(_board, _buffer);
+			break;
+		default:
+			SCREEPFISH_UNREACHABLE;
+			break;
+		};
+	};
 
+	void get_moves(const chess::Board& _board, const chess::Color _forPlayer, MoveBuffer& _buffer, GenType _type)
+	{
+		if (_forPlayer == Color::white)
+		{
+			get_moves_for<Color::white>(_board, _buffer, _type);
+		}
+		else
+		{
+			get_moves_for<Color::black>(_board, _buffer, _type);
+		};
+	};
+	void get_moves(const chess::Board& _board, const chess::Color _forPlayer, MoveBuffer& _buffer, const bool _isCheck)
+	{
+		get_moves(_board, _forPlayer, _buffer, (_isCheck) ? GenType::evasions : GenType::all);
+	};
 
+	bool gives_check(const chess::Board& _board, const Move& _move)
+	{
+		const auto _from = _move.from();
+		const auto _to = _move.to();
+		const auto _moved = _board.get(_from);
+		const auto _player = _moved.color();
 
-	bool can_castle_kingside(const chess::Board& _board, chess::Color _player)
+		const auto _theirKing = _board.get_piece_bitboard(PieceType::king, !_player);
+		if (_theirKing.none())
+		{
+			return false;
+		};
+
+		const auto _fromBit = uint64_t(1) << static_cast<size_t>(_from);
+		const auto _toBit = uint64_t(1) << static_cast<size_t>(_to);
+
+		// Build our attackers and the occupancy as they will be after the move
+		auto _attackers = get_attacker_bits(_board, _player);
+		auto _occupied = (_board.get_occupied_bitboard().to_uint64() & ~_fromBit) | _toBit;
+		_attackers.pawns_ &= ~_fromBit;
+		_attackers.knights_ &= ~_fromBit;
+		_attackers.diagonals_ &= ~_fromBit;
+		_attackers.straights_ &= ~_fromBit;
+		_attackers.king_ &= ~_fromBit;
+
+		auto _type = _moved.type();
+		if (_type == PieceType::pawn)
+		{
+			if (_to.rank() == Rank::r1 || _to.rank() == Rank::r8)
+			{
+				_type = (_move.promotion() == PieceType::none) ? PieceType::queen : _move.promotion();
+			}
+			else if (_to.file() != _from.file() && _board.has_enpassant_target() && _to == _board.enpassant_target())
+			{
+				_occupied &= ~(uint64_t(1) << static_cast<size_t>(Position(_to.file(), _from.rank())));
+			};
+		}
+		else if (_type == PieceType::king && _from.file() == File::e &&
+			(_to.file() == File::g || _to.file() == File::c))
+		{
+			// Castling, the rook may be the one giving check
+			const auto _rookFrom = Position((_to.file() == File::g) ? File::h : File::a, _from.rank());
+			const auto _rookTo = Position((_to.file() == File::g) ? File::f : File::d, _from.rank());
+			const auto _rookFromBit = uint64_t(1) << static_cast<size_t>(_rookFrom);
+			const auto _rookToBit = uint64_t(1) << static_cast<size_t>(_rookTo);
+			_occupied = (_occupied & ~_rookFromBit) | _rookToBit;
+			_attackers.straights_ = (_attackers.straights_ & ~_rookFromBit) | _rookToBit;
+		};
+
+		switch (_type)
+		{
+		case PieceType::pawn:
+			_attackers.pawns_ |= _toBit;
+			break;
+		case PieceType::knight:
+			_attackers.knights_ |= _toBit;
+			break;
+		case PieceType::bishop:
+			_attackers.diagonals_ |= _toBit;
+			break;
+		case PieceType::rook:
+			_attackers.straights_ |= _toBit;
+			break;
+		case PieceType::queen:
+			_attackers.diagonals_ |= _toBit;
+			_attackers.straights_ |= _toBit;
+			break;
+		default:
+			break;
+		};
+
+		return get_attackers_of(_theirKing.lsb(), !_player, _attackers, _occupied) != 0;
+	};
+	
+	std::vector<Move> get_moves(const chess::Board& _board, const chess::Color _forPlayer)
 	{
-		if (!_board.get_castle_kingside_flag(_player))
+		auto _data = std::vector<Move>(max_moves_possible_in_any_position_v, Move{});
+		auto _buffer = chess::MoveBuffer(_data.data(), _data.data() + _data.size());
+		get_moves(_board, _forPlayer, _buffer);
+		_data.resize(_buffer.head() - _data.data());
+		return _data;
+	};
+
+
+
+
+	/**
+	 * @brief Checks if a player has a legal move without generating them, stopping at the first one found.
+	 *
+	 * Uses the same check and pin masks as get_moves<C, G>(). King steps are tried first, then captures
+	 * of a single checker and then the rest of the pieces against the check mask, which only leaves
+	 * interpositions when in check. En passant is the only move not covered set-wise and falls back to
+	 * generating the captures.
+	*/
+	template <Color C>
+	inline bool has_any_legal_move(const chess::Board& _board)
+	{
+		using traits = PlayerTraits<C>;
+
+		const auto _kingBits = _board.get_piece_bitboard(PieceType::king, C);
+		if (_kingBits.none())
 		{
 			return false;
 		};
 
-		// Check the squares that castling would occur across.
+		const auto _kingPos = _kingBits.lsb();
+		const auto _kingBit = _kingBits.to_uint64();
+
+		const auto _friendlyBits = _board.get_color_bitboard(C).to_uint64();
+		const auto _enemyBits = _board.get_color_bitboard(!C).to_uint64();
+		const auto _occupied = _friendlyBits | _enemyBits;
+
+		const auto _enemies = get_attacker_bits(_board, !C);
+		const auto _checkers = get_attackers_of(_kingPos, C, _enemies, _occupied);
+
+		// King steps, the attack map is exact unless a checking slider's ray runs through the king
 		{
-			auto _checkSquares = std::array<Position, 2>{};
-			if (_player == Color::white)
+			const auto _steps = get_king_attack_squares(_kingPos) & ~BitBoard(_friendlyBits) & ~_board.get_attacked_bitboard(!C);
+			if (_checkers == 0)
 			{
-				_checkSquares[0] = (File::f, Rank::r1);
-				_checkSquares[1] = (File::g, Rank::r1);
+				if (_steps.any())
+				{
+					return true;
+				};
 			}
 			else
 			{
-				_checkSquares[0] = (File::f, Rank::r8);
-				_checkSquares[1] = (File::g, Rank::r8);
+				const auto _occupiedWithoutKing = _occupied & ~_kingBit;
+				for (const auto _to : _steps)
+				{
+					if (get_attackers_of(_to, C, _enemies, _occupiedWithoutKing) == 0)
+					{
+						return true;
+					};
+				};
 			};
+		};
+
+		// Only the king can move out of double check
+		if (std::popcount(_checkers) > 1)
+		{
+			return false;
+		};
 
-			// Cannot castle through other pieces.
-			for (auto& v : _checkSquares)
+		// Find friendly pieces pinned to the king
+		auto _pinned = uint64_t(0);
+		{
+			const auto _empty = BitBoard(0);
+			const auto _snipers = BitBoard(
+				(get_rook_attacks(_kingPos, _empty).to_uint64() & _enemies.straights_) |
+				(get_bishop_attacks(_kingPos, _empty).to_uint64() & _enemies.diagonals_));
+			for (const auto _sniperPos : _snipers)
 			{
-				if (!_board.is_empty(v))
+				const auto _blockers = get_squares_between(_kingPos, _sniperPos).to_uint64() & _occupied;
+				if (std::popcount(_blockers) == 1)
 				{
-					return false;
+					_pinned |= _blockers & _friendlyBits;
 				};
 			};
+		};
+
+		// A pinned piece can never resolve a check, so only unpinned pieces are looked at while in check
+		auto _checkMask = ~uint64_t(0);
+		if (_checkers != 0)
+		{
+			const auto _checkerPos = Position::from_bits(static_cast<uint8_t>(std::countr_zero(_checkers)));
 
-			// Cannot castle out of check
-			if (is_check(_board, _player))
+			// Capture the checker
+			auto _defenders = get_attacker_bits(_board, C);
+			_defenders.king_ = 0;
+			if (get_attackers_of(_checkerPos, !C, _defenders, _occupied) & ~_pinned)
 			{
-				return false;
+				return true;
+			};
+
+			_checkMask = _checkers | get_squares_between(_kingPos, _checkerPos).to_uint64();
+		};
+
+		const auto _occupiedBB = BitBoard(_occupied);
+		const auto _targets = BitBoard(~_friendlyBits & _checkMask);
+
+		// Knights, a pinned knight can never move
+		if (has_legal_piece_move<C, PieceType::knight>(_board, _kingPos, _pinned, _pinned, _occupiedBB, _targets))
+		{
+			return true;
+		};
+
+		// Pawns, unpinned ones all at once and pinned ones along their pin line
+		{
+			constexpr auto double_push_rank_v = BitBoard::rank_mask(traits::double_push_rank_v);
+
+			const auto _empty = ~_occupiedBB;
+			const auto _enemyBB = BitBoard(_enemyBits);
+			const auto _pawnTargets = [&](BitBoard _pawns)
+			{
+				const auto _singlePushes = _pawns.shift<traits::up_v>() & _empty;
+				const auto _doublePushes = (_singlePushes & double_push_rank_v).template shift<traits::up_v>() & _empty;
+				return _singlePushes | _doublePushes |
+					((_pawns.shift<traits::up_left_v>() | _pawns.shift<traits::up_right_v>()) & _enemyBB);
 			};
 
-			// Cannot castle through / into check
-			for (auto& v : _checkSquares)
+			const auto _pawns = _board.get_piece_bitboard(PieceType::pawn, C);
+			if ((_pawnTargets(_pawns & ~BitBoard(_pinned)) & _targets).any())
 			{
-				auto b = _board;
-				b.move(b.get_king(_player).position(), v);
-				if (is_check(b, _player))
+				return true;
+			};
+			if (_checkers == 0)
+			{
+				for (const auto _position : _pawns & BitBoard(_pinned))
 				{
-					return false;
+					if ((_pawnTargets(BitBoard::from_position(_position)) & get_line_through(_kingPos, _position)).any())
+					{
+						return true;
+					};
 				};
 			};
 		};
 
-		return true;
+		// Sliders, pinned ones only while not in check
+		const auto _frozen = (_checkers == 0) ? uint64_t(0) : _pinned;
+		if (has_legal_piece_move<C, PieceType::queen>(_board, _kingPos, _pinned, _frozen, _occupiedBB, _targets) ||
+			has_legal_piece_move<C, PieceType::rook>(_board, _kingPos, _pinned, _frozen, _occupiedBB, _targets) ||
+			has_legal_piece_move<C, PieceType::bishop>(_board, _kingPos, _pinned, _frozen, _occupiedBB, _targets))
+		{
+			return true;
+		};
+
+		// En passant is rare and has its own discovered check rules, let the generator handle it
+		if (_board.has_enpassant_target())
+		{
+			auto _bufferData = std::array<Move, max_moves_possible_in_any_position_v>{};
+			auto _buffer = MoveBuffer(_bufferData);
+			get_moves<C, GenType::captures>(_board, _buffer);
+			return _buffer.head() != _bufferData.data();
+		};
+
+		return false;
 	};
-	bool can_castle_queenside(const chess::Board& _board, chess::Color _player)
+
+	template <Color C>
+	inline bool is_legal(const chess::Board& _board, const Move& _move)
 	{
-		if (!_board.get_castle_queenside_flag(_player))
+		const auto _from = _move.from();
+		const auto _to = _move.to();
+		const auto _moved = _board.get(_from);
+		if (!_moved || _moved.color() != C || _from == _to)
 		{
 			return false;
 		};
 
-		// Check the squares that castling would occur across.
+		const auto _kingBits = _board.get_piece_bitboard(PieceType::king, C);
+		if (_kingBits.none())
 		{
-			auto _checkSquares = std::array<Position, 3>{};
-			if (_player == Color::white)
-			{
-				_checkSquares[0] = (File::d, Rank::r1);
-				_checkSquares[1] = (File::c, Rank::r1);
-				_checkSquares[2] = (File::b, Rank::r1);
-			}
-			else
-			{
-				_checkSquares[0] = (File::d, Rank::r8);
-				_checkSquares[1] = (File::c, Rank::r8);
-				_checkSquares[2] = (File::b, Rank::r8);
-			};
+			return false;
+		};
 
-			// Cannot castle through other pieces.
-			for (auto& v : _checkSquares)
+		const auto _kingPos = _kingBits.lsb();
+		const auto _kingBit = _kingBits.to_uint64();
+		const auto _toBit = uint64_t(1) << static_cast<size_t>(_to);
+
+		const auto _friendlyBits = _board.get_color_bitboard(C).to_uint64();
+		const auto _enemyBits = _board.get_color_bitboard(!C).to_uint64();
+		const auto _occupied = _friendlyBits | _enemyBits;
+		if (_friendlyBits & _toBit)
+		{
+			return false;
+		};
+
+		const auto _enemies = get_attacker_bits(_board, !C);
+		const auto _checkers = get_attackers_of(_kingPos, C, _enemies, _occupied);
+
+		// King moves, the two square steps along the back rank are castling
+		if (_moved.type() == PieceType::king)
+		{
+			if (_move.promotion() != PieceType::none)
 			{
-				if (!_board.is_empty(v))
-				{
-					return false;
-				};
+				return false;
 			};
 
-			// Cannot castle out of check
-			if (is_check(_board, _player))
+			const auto _step = static_cast<int>(_to.file()) - static_cast<int>(_from.file());
+			if ((_step == 2 || _step == -2) && _to.rank() == _from.rank())
 			{
-				return false;
+				return _checkers == 0 && ((_step == 2) ?
+					can_castle_kingside<C>(_board, _occupied) :
+					can_castle_queenside<C>(_board, _occupied));
 			};
+			return (get_king_attack_squares(_kingPos).to_uint64() & _toBit) &&
+				get_attackers_of(_to, C, _enemies, _occupied & ~_kingBit) == 0;
+		};
+
+		// Only the king can move out of double check
+		if (std::popcount(_checkers) > 1)
+		{
+			return false;
+		};
 
-			// Cannot castle through / into check
-			for (size_t n = 0; n != 2; ++n)
+		// Squares the piece may land on to resolve a check and stay on its pin line
+		auto _legal = ~uint64_t(0);
+		if (_checkers != 0)
+		{
+			const auto _checkerPos = Position::from_bits(static_cast<uint8_t>(std::countr_zero(_checkers)));
+			_legal = _checkers | get_squares_between(_kingPos, _checkerPos).to_uint64();
+		};
+		{
+			const auto _fromBit = uint64_t(1) << static_cast<size_t>(_from);
+			const auto _empty = BitBoard(0);
+			const auto _snipers = BitBoard(
+				(get_rook_attacks(_kingPos, _empty).to_uint64() & _enemies.straights_) |
+				(get_bishop_attacks(_kingPos, _empty).to_uint64() & _enemies.diagonals_));
+			for (const auto _sniperPos : _snipers)
 			{
-				auto& v = _checkSquares[n];
-				auto b = _board;
-				b.move(b.get_king(_player).position(), v);
-				if (is_check(b, _player))
+				if ((get_squares_between(_kingPos, _sniperPos).to_uint64() & _occupied) == _fromBit)
 				{
-					return false;
+					_legal &= get_line_through(_kingPos, _from).to_uint64();
 				};
 			};
 		};
 
-		return true;
+		// Pawns have too many kinds of move to check by hand, generate the few this one has
+		if (_moved.type() == PieceType::pawn)
+		{
+			auto _bufferData = std::array<Move, 16>{};
+			auto _buffer = MoveBuffer(_bufferData);
+			get_legal_pawn_moves<C, GenType::all>(_board, BitBoard::from_position(_from), _kingPos, _enemies,
+				_enemyBits, _occupied, _legal, _buffer);
+			return std::find(_bufferData.data(), _buffer.head(), _move) != _buffer.head();
+		};
+
+		if (_move.promotion() != PieceType::none)
+		{
+			return false;
+		};
+
+		const auto _occupiedBB = BitBoard(_occupied);
+		auto _attacks = BitBoard(0);
+		switch (_moved.type())
+		{
+		case PieceType::knight:
+			_attacks = get_piece_attack_squares<PieceType::knight>(_from, _occupiedBB);
+			break;
+		case PieceType::bishop:
+			_attacks = get_piece_attack_squares<PieceType::bishop>(_from, _occupiedBB);
+			break;
+		case PieceType::rook:
+			_attacks = get_piece_attack_squares<PieceType::rook>(_from, _occupiedBB);
+			break;
+		case PieceType::queen:
+			_attacks = get_piece_attack_squares<PieceType::queen>(_from, _occupiedBB);
+			break;
+		default:
+			return false;
+		};
+		return (_attacks.to_uint64() & _legal & _toBit) != 0;
+	};
+
+	bool has_any_legal_move(const Board& _board, Color _player)
+	{
+		return (_player == Color::white) ?
+			has_any_legal_move<Color::white>(_board) :
+			has_any_legal_move<Color::black>(_board);
+	};
+	bool has_legal_moves_from_check(const Board& _board, Color _player)
+	{
+		return has_any_legal_move(_board, _player);
+	};
+	bool is_legal(const Board& _board, const Move& _move)
+	{
+		return (_board.get_toplay() == Color::white) ?
+			is_legal<Color::white>(_board, _move) :
+			is_legal<Color::black>(_board, _move);
+	};
+
+
+
+
+
+	bool can_castle_kingside(const chess::Board& _board, chess::Color _player)
+	{
+		const auto _occupied = _board.get_occupied_bitboard().to_uint64();
+		return (_player == Color::white) ?
+			can_castle_kingside<Color::white>(_board, _occupied) :
+			can_castle_kingside<Color::black>(_board, _occupied);
+	};
+	bool can_castle_queenside(const chess::Board& _board, chess::Color _player)
+	{
+		const auto _occupied = _board.get_occupied_bitboard().to_uint64();
+		return (_player == Color::white) ?
+			can_castle_queenside<Color::white>(_board, _occupied) :
+			can_castle_queenside<Color::black>(_board, _occupied);
 	};
 
 
@@ -1763,9 +2185,9 @@ namespace chess
 
 
 
-	consteval BitBoardCX calculate_threat_bitboard(Position _pos)
+	consteval BitBoard calculate_threat_bitboard(Position _pos)
 	{
-		auto bb = BitBoardCX();
+		auto bb = BitBoard();
 
 		// <--------->
 		bb |= make_rank_bits(_pos.rank());
@@ -1810,7 +2232,7 @@ namespace chess
 	};
 	consteval auto calculate_threat_bitboard()
 	{
-		std::array<BitBoardCX, 64> bbs{};
+		std::array<BitBoard, 64> bbs{};
 		for (auto& v : positions_v)
 		{
 			bbs[static_cast<size_t>(v)] = calculate_threat_bitboard(v);
@@ -1834,51 +2256,12 @@ namespace chess
 		using namespace chess;
 
 		const auto& p = _board.get_king(_forPlayer);
-
-		if (p)
+		if (!p)
 		{
-			// Quick check that an enemy pieces is in one of the threat positions
-			auto _threatPositions = BitBoard(get_threat_bitboard(p.position()));
-
-			if (_forPlayer == Color::white)
-			{
-				// If a piece is directly above us, remove the whole file above the king
-				if (p.rank() != Rank::r8)
-				{
-					if (_board.has_friendy_piece(next(p.position(), 0, 1), _forPlayer))
-					{
-						_threatPositions &= ~make_file_bits(p.file(), p.rank(), Rank::r8);
-					};
-				};
-
-				auto _threats = _threatPositions & _board.get_black_piece_bitboard();
-				if (_threats.none())
-				{
-					// No threats, cannot be in check
-					return false;
-				};
-			}
-			else
-			{
-				// If a piece is directly below us, remove the whole file below the king
-				if (p.rank() != Rank::r1 && _board.has_friendy_piece(next(p.position(), 0, -1), _forPlayer))
-				{
-					_threatPositions &= ~make_file_bits(p.file(), Rank::r1, p.rank());
-				};
-				_board.pieces_on_file(p.file());
-
-				auto _threats = _threatPositions & _board.get_white_piece_bitboard();
-				if (_threats.none())
-				{
-					// No threats, cannot be in check
-					//std::cout << "Prevented check check\n";
-					return false;
-				};
-			};
-
-			return is_piece_attacked(_board, p);
+			return true;
 		};
-		return true;
+
+		return _board.get_attacked_bitboard(!_forPlayer).test(p.position());
 	};
 
 	bool would_move_cause_check(const chess::Board& _board, const Move& _move, Color _player)
@@ -1905,33 +2288,120 @@ namespace chess
 			return false;
 		};
 
-		return !has_legal_moves_from_check(_board, _forPlayer);
+		return !has_any_legal_move(_board, _forPlayer);
+	};
+	bool is_stalemate(const chess::Board& _board, const chess::Color _forPlayer)
+	{
+		return !is_check(_board, _forPlayer) && !has_any_legal_move(_board, _forPlayer);
 	};
 
 
 
-	constexpr inline chess::Rating material_value(const chess::PieceType& _piece)
+	BitBoard get_attackers_to(const Board& _board, Position _pos, BitBoard _occupied)
+	{
+		const auto _diagonal = _board.get_piece_bitboard(PieceType::bishop) | _board.get_piece_bitboard(PieceType::queen);
+		const auto _straight = _board.get_piece_bitboard(PieceType::rook) | _board.get_piece_bitboard(PieceType::queen);
+
+		// A pawn attacks a square if a pawn of the other colour there would attack it back
+		const auto _attackers =
+			(get_pawn_attacking_squares(_pos, Color::black) & _board.get_piece_bitboard(PieceType::pawn, Color::white)) |
+			(get_pawn_attacking_squares(_pos, Color::white) & _board.get_piece_bitboard(PieceType::pawn, Color::black)) |
+			(get_knight_attack_squares(_pos) & _board.get_piece_bitboard(PieceType::knight)) |
+			(get_king_attack_squares(_pos) & _board.get_piece_bitboard(PieceType::king)) |
+			(get_bishop_attacks(_pos, _occupied) & _diagonal) |
+			(get_rook_attacks(_pos, _occupied) & _straight);
+		return _attackers & _occupied;
+	};
+
+	Rating static_exchange(const Board& _board, const Move& _move)
 	{
-		switch (_piece)
+		constexpr auto least_valuable_first_v = std::array
 		{
-		case chess::PieceType::pawn:
-			return 1.0f;
-		case chess::PieceType::knight:
-			return 2.0f;
-		case chess::PieceType::bishop:
-			return 2.0f;
-		case chess::PieceType::rook:
-			return 5.0f;
-		case chess::PieceType::queen:
-			return 10.0f;
-		case chess::PieceType::king:
-			return 1000.0f;
-		default:
-			SCREEPFISH_UNREACHABLE;
+			PieceType::pawn, PieceType::knight, PieceType::bishop, PieceType::rook, PieceType::queen, PieceType::king
+		};
+
+		const auto _from = _move.from();
+		const auto _to = _move.to();
+		const auto _moved = _board.get(_from);
+		SCREEPFISH_ASSERT(_moved);
+
+		auto _occupied = _board.get_occupied_bitboard();
+		auto _captured = _board.get(_to).type();
+		if (_move.is_en_passant())
+		{
+			// The captured pawn is beside the destination square, not on it
+			_captured = PieceType::pawn;
+			_occupied.reset(Position(_to.file(), _from.rank()));
+		};
+
+		// Material each capture wins for the side making it, if the other side stops there
+		auto _gains = std::array<Rating, 32>{};
+		_gains[0] = (_captured == PieceType::none) ? Rating(0) : material_value(_captured);
+
+		// Piece left standing on the square, a promoting pawn is worth its promoted piece from then on
+		auto _onSquare = _moved.type();
+		if (_onSquare == PieceType::pawn && (_to.rank() == Rank::r1 || _to.rank() == Rank::r8))
+		{
+			_onSquare = (_move.promotion() == PieceType::none) ? PieceType::queen : _move.promotion();
+			_gains[0] += material_value(_onSquare) - material_value(PieceType::pawn);
 		};
+
+		const auto _diagonal = _board.get_piece_bitboard(PieceType::bishop) | _board.get_piece_bitboard(PieceType::queen);
+		const auto _straight = _board.get_piece_bitboard(PieceType::rook) | _board.get_piece_bitboard(PieceType::queen);
+
+		_occupied.reset(_from);
+		auto _attackers = get_attackers_to(_board, _to, _occupied);
+		auto _side = !_moved.color();
+		size_t _depth = 0;
+		while (_depth + 1 != _gains.size())
+		{
+			// Each side recaptures with its least valuable piece
+			const auto _sideAttackers = _attackers & _board.get_color_bitboard(_side);
+			if (!_sideAttackers.any())
+			{
+				break;
+			};
+
+			auto _type = PieceType::none;
+			auto _candidates = BitBoard();
+			for (const auto _candidateType : least_valuable_first_v)
+			{
+				_candidates = _sideAttackers & _board.get_piece_bitboard(_candidateType);
+				if (_candidates.any())
+				{
+					_type = _candidateType;
+					break;
+				};
+			};
+
+			// The king can only take a piece that is no longer defended
+			if (_type == PieceType::king && (_attackers & _board.get_color_bitboard(!_side)).any())
+			{
+				break;
+			};
+
+			++_depth;
+			_gains[_depth] = material_value(_onSquare) - _gains[_depth - 1];
+			_onSquare = _type;
+
+			// Moving the capturing piece off its square may uncover a slider lined up behind it
+			_occupied.reset(_candidates.lsb());
+			_attackers |= (get_bishop_attacks(_to, _occupied) & _diagonal) | (get_rook_attacks(_to, _occupied) & _straight);
+			_attackers &= _occupied;
+			_side = !_side;
+		};
+
+		// Either side may stop capturing instead of losing material, work back from the last capture
+		while (_depth != 0)
+		{
+			--_depth;
+			_gains[_depth] = -std::max(-_gains[_depth], _gains[_depth + 1]);
+		};
+		return _gains[0];
 	};
 
 
+
 	constexpr inline auto white_distance_to_promote_v = std::array
 	{
 		7, // rank 1
@@ -1985,9 +2455,9 @@ namespace chess
 		constexpr auto& pawn_push_rating_v = PAWN_PUSH_RATING;
 		constexpr auto& castle_ability_rating_v = CASTLE_ABILITY_RATING;
 		constexpr auto& development_rating_v = DEVELOPMENT_RATING;
-		constexpr auto& repeated_move_rating_v = REPEATED_MOVE_RATING;
 		constexpr auto& fifty_move_rule_rating_v = FIFTY_MOVE_RULE_RATING;
 		constexpr auto& king_move_rating_v = KING_MOVE_RATING;
+		constexpr auto& king_zone_attack_rating_v = KING_ZONE_ATTACK_RATING;
 		constexpr auto& stalemate_rating_v = STALEMATE_RATING;
 
 		auto _rating = Rating(0);
@@ -2001,10 +2471,13 @@ namespace chess
 			_rating -= king_move_rating_v;
 		};
 		
-		// Checkmate
-		const auto _isCheckmate = is_checkmate(_board, _board.get_toplay());
-		if (_isCheckmate)
+		// Checkmate or stalemate, one legal move query covers both
+		if (!has_any_legal_move(_board, _board.get_toplay()))
 		{
+			if (!is_check(_board, _board.get_toplay()))
+			{
+				return stalemate_rating_v;
+			};
 			return (_board.get_toplay() == Player) ?
 				-checkmate_rating_v : checkmate_rating_v;
 		};
@@ -2046,156 +2519,48 @@ namespace chess
 
 		// Material value + Positional value
 
-		const auto _pEnd = _board.pend();
-		for (auto it = _board.pbegin(); it != _pEnd; ++it)
+		const auto _rateSide = [&](Color _color)
 		{
-			const auto& v = *it;
-			switch (v)
-			{
-			case Piece::white_pawn:
-			{
-				if constexpr (Player == Color::white)
-				{
-					_rating += white_pawn_promote_rating_v[jc::to_underlying(v.rank())];
-					_rating += material_value(Piece::pawn);
-				}
-				else
-				{
-					_rating -= white_pawn_promote_rating_v[jc::to_underlying(v.rank())];
-					_rating -= material_value(Piece::pawn);
-				};
-			};
-			break;
-			case Piece::black_pawn:
-			{
-				if constexpr (Player == Color::white)
-				{
-					_rating -= black_pawn_promote_rating_v[jc::to_underlying(v.rank())];
-					_rating -= material_value(Piece::pawn);
-				}
-				else
-				{
-					_rating += black_pawn_promote_rating_v[jc::to_underlying(v.rank())];
-					_rating += material_value(Piece::pawn);
-				};
-			};
-			break;
+			auto _sideRating = Rating(0);
 
-			case Piece::black_queen: [[fallthrough]];
-			case Piece::black_bishop: [[fallthrough]];
-			case Piece::black_rook:
+			// Pawns are worth more the closer they are to promoting
+			const auto& _promoteRatings = (_color == Color::white) ?
+				white_pawn_promote_rating_v : black_pawn_promote_rating_v;
+			for (const auto _pos : _board.get_piece_bitboard(PieceType::pawn, _color))
 			{
-				if (v.rank() != Rank::r8)
-				{
-					if constexpr (Player == Color::white)
-					{
-						_rating -= development_rating_v;
-					}
-					else
-					{
-						_rating += development_rating_v;
-					};
-				};
-
-				if constexpr (Player == Color::white)
-				{
-					_rating -= material_value(v.type());
-				}
-				else
-				{
-					_rating += material_value(v.type());
-				};
+				_sideRating += _promoteRatings[jc::to_underlying(_pos.rank())];
 			};
-			break;
 
-			case Piece::black_knight:
-			{
-				if constexpr (Player == Color::white)
-				{
-					_rating -= material_value(Piece::knight);
-				}
-				else
-				{
-					_rating += material_value(Piece::knight);
-				};
-			};
-			break;
+			// Bishops, rooks and queens that have left the back rank count as developed
+			const auto _developable =
+				_board.get_piece_bitboard(PieceType::bishop, _color) |
+				_board.get_piece_bitboard(PieceType::rook, _color) |
+				_board.get_piece_bitboard(PieceType::queen, _color);
+			_sideRating += development_rating_v * static_cast<Rating>((_developable & ~BitBoard::rank_mask(Rank::r8)).count());
 
-			case Piece::white_queen: [[fallthrough]];
-			case Piece::white_bishop: [[fallthrough]];
-			case Piece::white_rook:
+			// King safety, squares around the king the enemy attacks
+			if (const auto _king = _board.get_piece_bitboard(PieceType::king, _color); _king.any())
 			{
-				if (v.rank() != Rank::r8)
-				{
-					if constexpr (Player == Color::white)
-					{
-						_rating += development_rating_v;
-					}
-					else
-					{
-						_rating -= development_rating_v;
-					};
-				};
-				
-				if constexpr (Player == Color::white)
-				{
-					_rating += material_value(v.type());
-				}
-				else
-				{
-					_rating -= material_value(v.type());
-				};
+				const auto _kingZone = get_king_attack_squares(_king.lsb());
+				_sideRating -= king_zone_attack_rating_v * static_cast<Rating>((_kingZone & _board.get_attacked_bitboard(!_color)).count());
 			};
-			break;
 
-			case Piece::white_knight:
+			constexpr auto material_types_v = std::array
 			{
-				if constexpr (Player == Color::white)
-				{
-					_rating += material_value(Piece::knight);
-				}
-				else
-				{
-					_rating -= material_value(Piece::knight);
-				};
+				PieceType::pawn, PieceType::knight, PieceType::bishop,
+				PieceType::rook, PieceType::queen, PieceType::king,
 			};
-			break;
-
-			case Piece::white_king:
+			for (const auto _type : material_types_v)
 			{
-				if constexpr (Player == Color::white)
-				{
-					_rating += material_value(Piece::king);
-				}
-				else
-				{
-					_rating -= material_value(Piece::king);
-				};
-			};
-			break; 
-			case Piece::black_king:
-			{
-				if constexpr (Player == Color::white)
-				{
-					_rating -= material_value(Piece::king);
-				}
-				else
-				{
-					_rating += material_value(Piece::king);
-				};
+				_sideRating += material_value(_type) * static_cast<Rating>(_board.get_piece_bitboard(_type, _color).count());
 			};
-			break;
-			default:
-				break;
-			};
-		};
 
-		// Repeated move rating
-		if (_board.is_last_move_repeated_move())
-		{
-			_rating += repeated_move_rating_v;
+			return _sideRating;
 		};
 
+		_rating += _rateSide(Player);
+		_rating -= _rateSide(!Player);
+
 		return _rating;
 	};
 
@@ -2233,4 +2598,4 @@ namespace chess
 
 
 
-};
\ No newline at end of file
+};
\ No newline at end of file
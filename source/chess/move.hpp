@@ -109,6 +109,33 @@ namespace chess
 	using RatedMove = BasicRatedMove<Rating>;
 	using AbsoluteRatedMove = BasicRatedMove<AbsoluteRating>;
 
+	/**
+	 * @brief Packed move along with a 16 bit ordering score, small enough that sorting only shuffles 32 bit values.
+	*/
+	class ScoredMove
+	{
+	public:
+
+		constexpr Move move() const noexcept { return this->move_; };
+		constexpr int16_t score() const noexcept { return this->score_; };
+
+		constexpr auto operator<=>(const ScoredMove& rhs) const noexcept
+		{
+			return this->score() <=> rhs.score();
+		};
+
+		constexpr ScoredMove() = default;
+		constexpr ScoredMove(Move _move, int16_t _score) :
+			move_(_move), score_(_score)
+		{};
+
+	private:
+		Move move_{};
+		int16_t score_ = 0;
+	};
+
+	static_assert(sizeof(ScoredMove) == sizeof(uint32_t));
+
 
 
 	void get_piece_attacks_with_pawn(const chess::Board& _board, const chess::BoardPiece& _piece, const chess::BoardPiece& _byPiece, MoveBuffer& _buffer);
@@ -139,12 +166,76 @@ namespace chess
 	void get_queen_moves(const chess::Board& _board, const chess::BoardPiece& _piece, MoveBuffer& _buffer, const bool _isCheck = false);
 	void get_piece_moves(const chess::Board& _board, const chess::BoardPiece& _piece, MoveBuffer& _buffer, const bool _isCheck = false);
 
+	/**
+	 * @brief Kinds of moves the move generator can be limited to.
+	*/
+	enum class GenType : uint8_t
+	{
+		/**
+		 * @brief Every legal move.
+		*/
+		all,
+
+		/**
+		 * @brief Captures, en passant and queen promotions.
+		*/
+		captures,
+
+		/**
+		 * @brief Every legal move that is not in captures, including underpromotions and castling.
+		*/
+		quiets,
+
+		/**
+		 * @brief Every legal move out of check, the player to move must be in check.
+		*/
+		evasions,
+
+		/**
+		 * @brief Legal moves that put the opponent in check.
+		*/
+		checks,
+	};
+
+	/**
+	 * @brief Generates legal moves with the player and kind of move fixed at compile time.
+	 * @tparam C Player to generate moves for.
+	 * @tparam G Kind of moves to generate.
+	 * @param _board Board to generate moves on.
+	 * @param _buffer Buffer to write the moves into.
+	*/
+	template <Color C, GenType G>
+	void get_moves(const chess::Board& _board, MoveBuffer& _buffer);
+
+	/**
+	 * @brief Generates legal moves, dispatching to get_moves<C, G>().
+	 * @param _board Board to generate moves on.
+	 * @param _forPlayer Player to generate moves for.
+	 * @param _buffer Buffer to write the moves into.
+	 * @param _type Kind of moves to generate.
+	*/
+	void get_moves(const chess::Board& _board, const chess::Color _forPlayer, MoveBuffer& _buffer, GenType _type);
+
+	/**
+	 * @brief Generates every legal move, or only the evasions if the player is known to be in check.
+	*/
 	void get_moves(const chess::Board& _board, const chess::Color _forPlayer, MoveBuffer& _buffer, const bool _isCheck = false);
 	
 	std::vector<Move> get_moves(const chess::Board& _board, const chess::Color _forPlayer);
 
 
 
+	/**
+	 * @brief Checks if a player has at least one legal move, stopping at the first one found.
+	 *
+	 * Much cheaper than generating the moves, no boards are copied and nothing is written out.
+	 *
+	 * @param _board Board to look at.
+	 * @param _player Player to look for a legal move for.
+	 * @return True if has moves, false otherwise.
+	*/
+	bool has_any_legal_move(const Board& _board, Color _player);
+
 	/**
 	 * @brief Checks if the given player has any legal moves.
 	 * @param _board Checks if the board has legal moves to escape current check.
@@ -153,6 +244,27 @@ namespace chess
 	*/
 	bool has_legal_moves_from_check(const Board& _board, Color _player);
 
+	/**
+	 * @brief Checks if a move is legal for the player to move without generating the other moves.
+	 *
+	 * Meant for moves that come from somewhere other than move generation, such as the transposition table.
+	 *
+	 * @param _board Board the move would be played on.
+	 * @param _move Move to check, may come from a different position.
+	 * @return True if the move is legal, false otherwise.
+	*/
+	bool is_legal(const Board& _board, const Move& _move);
+
+
+
+	/**
+	 * @brief Checks if a legal move puts the opponent in check.
+	 * @param _board Board the move will be played on.
+	 * @param _move Legal move for the player to move.
+	 * @return True if the move gives check, directly or by discovery.
+	*/
+	bool gives_check(const chess::Board& _board, const Move& _move);
+
 
 
 	bool can_castle_kingside(const chess::Board& _board, chess::Color _player);
@@ -217,8 +329,42 @@ namespace chess
 	*/
 	bool is_checkmate(const chess::Board& _board, const chess::Color _forPlayer);
 
+	/**
+	 * @brief Checks if a player is stalemated for a given board position.
+	 * @param _board Current board position.
+	 * @param _forPlayer Player to see if is stalemated.
+	 * @return True if player given is not in check and has no legal moves, false otherwise.
+	*/
+	bool is_stalemate(const chess::Board& _board, const chess::Color _forPlayer);
+
 
 
+	/**
+	 * @brief Gets the material value of a piece used by the board rating.
+	 * @param _piece Piece type, must not be none.
+	 * @return Value in pawns.
+	*/
+	constexpr inline chess::Rating material_value(const chess::PieceType& _piece)
+	{
+		switch (_piece)
+		{
+		case chess::PieceType::pawn:
+			return 1.0f;
+		case chess::PieceType::knight:
+			return 2.0f;
+		case chess::PieceType::bishop:
+			return 2.0f;
+		case chess::PieceType::rook:
+			return 5.0f;
+		case chess::PieceType::queen:
+			return 10.0f;
+		case chess::PieceType::king:
+			return 1000.0f;
+		default:
+			SCREEPFISH_UNREACHABLE;
+		};
+	};
+
 	/**
 	 * @brief Calculates a quick rating for a board based solely on the current position.
 	 *
@@ -245,6 +391,28 @@ namespace chess
 
 
 
+	/**
+	 * @brief Gets every piece of either colour that attacks a square.
+	 * @param _board Board to look at.
+	 * @param _pos Square to find the attackers of.
+	 * @param _occupied Occupied squares, these block sliding pieces. Pieces outside it are left out.
+	 * @return Positions of the attacking pieces.
+	*/
+	BitBoard get_attackers_to(const Board& _board, Position _pos, BitBoard _occupied);
+
+	/**
+	 * @brief Works out the material a move wins once every capture back and forth on its destination square is played.
+	 * 
+	 * Static exchange evaluation. Both sides recapture with their least valuable piece, sliding pieces lined up
+	 * behind a capturing piece join in as it moves off, and either side may stop as soon as carrying on would
+	 * lose material. Pins and checks are ignored.
+	 * 
+	 * @param _board Board the move will be played on.
+	 * @param _move Move to evaluate, usually a capture or promotion.
+	 * @return Material won by the player making the move in pawns, negative if the move loses material.
+	*/
+	Rating static_exchange(const Board& _board, const Move& _move);
+
 	/**
 	 * @brief Checks if a move will result in a piece being captured.
 	 * 
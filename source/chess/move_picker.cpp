@@ -0,0 +1,283 @@
+#include "move_picker.hpp"
+
+#include <algorithm>
+
+namespace chess
+{
+	namespace
+	{
+		/**
+		 * @brief Piece values used for capture ordering, the king is free to capture with as any king capture is legal.
+		*/
+		constexpr int16_t capture_order_value(PieceType _type)
+		{
+			switch (_type)
+			{
+			case PieceType::pawn:
+				return 1;
+			case PieceType::knight:
+				return 3;
+			case PieceType::bishop:
+				return 3;
+			case PieceType::rook:
+				return 5;
+			case PieceType::queen:
+				return 9;
+			default:
+				return 0;
+			};
+		};
+
+		/**
+		 * @brief Checks if a move promotes to a queen, these are ordered along with the captures.
+		*/
+		inline bool is_queen_promotion(Piece _moved, const Move& _move)
+		{
+			return _moved == PieceType::pawn &&
+				(_move.to().rank() == Rank::r1 || _move.to().rank() == Rank::r8) &&
+				(_move.promotion() == PieceType::queen || _move.promotion() == PieceType::none);
+		};
+
+		/**
+		 * @brief Gets the value of the piece a move takes, a queen promotion counts as taking the pawn's worth of a queen.
+		*/
+		inline int16_t capture_victim_value(const Board& _board, Piece _moved, const Move& _move)
+		{
+			auto _victim = _board.get(_move.to()).type();
+			if (_move.is_en_passant())
+			{
+				_victim = PieceType::pawn;
+			};
+			const auto _promotion = (is_queen_promotion(_moved, _move)) ?
+				capture_order_value(PieceType::queen) - capture_order_value(PieceType::pawn) : 0;
+			return static_cast<int16_t>(capture_order_value(_victim) + _promotion);
+		};
+
+		/**
+		 * @brief Checks if a move is handed out with the captures, matches the moves in GenType::captures.
+		*/
+		inline bool is_capture_stage_move(const Board& _board, Piece _moved, const Move& _move)
+		{
+			if (is_queen_promotion(_moved, _move))
+			{
+				return true;
+			};
+			return _move.promotion() == PieceType::none &&
+				(_move.is_en_passant() || _board.get(_move.to()).type() != PieceType::none);
+		};
+	};
+
+
+
+	void MovePicker::generate(GenType _genType)
+	{
+		auto _generated = std::array<Move, 256>{};
+		auto _buffer = MoveBuffer(_generated);
+		get_moves(this->board_, this->board_.get_toplay(), _buffer, _genType);
+		const auto _generatedCount = static_cast<uint8_t>(_buffer.head() - _generated.data());
+
+		// Captures are laid out first, most valuable victim first and least valuable attacker breaking ties
+		SCREEPFISH_ASSERT(this->count_ == this->captures_end_);
+		for (uint8_t n = 0; n != _generatedCount; ++n)
+		{
+			const auto _move = _generated[n];
+			const auto _moved = this->board_.get(_move.from());
+			if (is_capture_stage_move(this->board_, _moved, _move))
+			{
+				const auto _score = capture_victim_value(this->board_, _moved, _move) * 16 - capture_order_value(_moved.type());
+				this->moves_[this->captures_end_++] = ScoredMove(_move, static_cast<int16_t>(_score));
+			};
+		};
+
+		// Then the quiets, scored by history if there is any
+		const auto _player = this->board_.get_toplay();
+		this->count_ = this->captures_end_;
+		for (uint8_t n = 0; n != _generatedCount && this->count_ != this->captures_end_ + _generatedCount; ++n)
+		{
+			const auto _move = _generated[n];
+			if (!is_capture_stage_move(this->board_, this->board_.get(_move.from()), _move))
+			{
+				const auto _score = (this->heuristics_) ? this->heuristics_->history(_player, _move) : int16_t(0);
+				this->moves_[this->count_++] = ScoredMove(_move, _score);
+			};
+		};
+
+		this->quiet_at_ = this->captures_end_;
+	};
+
+	bool MovePicker::is_handed_out(Move _move) const
+	{
+		if (_move == this->hash_move_)
+		{
+			return true;
+		};
+		const auto _end = this->killers_.begin() + this->killer_at_;
+		return std::find(this->killers_.begin(), _end, _move) != _end;
+	};
+
+	Move MovePicker::select_best(uint8_t& _at, uint8_t _end)
+	{
+		auto _best = _at;
+		for (auto n = _at + 1; n < _end; ++n)
+		{
+			if (this->moves_[n] > this->moves_[_best])
+			{
+				_best = static_cast<uint8_t>(n);
+			};
+		};
+		std::swap(this->moves_[_at], this->moves_[_best]);
+		return this->moves_[_at++].move();
+	};
+
+	size_t MovePicker::size()
+	{
+		if (!this->captures_generated_)
+		{
+			this->generate((this->gen_type_ == GenType::all) ? GenType::captures : this->gen_type_);
+			this->captures_generated_ = true;
+			this->quiets_generated_ = this->gen_type_ != GenType::all;
+		};
+		if (!this->quiets_generated_)
+		{
+			this->generate(GenType::quiets);
+			this->quiets_generated_ = true;
+		};
+		return this->count_;
+	};
+
+	Move MovePicker::next()
+	{
+		switch (this->stage_)
+		{
+		case Stage::hash_move:
+			this->stage_ = Stage::generate_captures;
+			if (this->hash_move_)
+			{
+				// The hash move may come from a different position, only hand it out if it is legal here
+				if (is_legal(this->board_, this->hash_move_))
+				{
+					return this->hash_move_;
+				};
+				this->hash_move_ = Move();
+			};
+			[[fallthrough]];
+
+		case Stage::generate_captures:
+			if (!this->captures_generated_)
+			{
+				this->generate((this->gen_type_ == GenType::all) ? GenType::captures : this->gen_type_);
+				this->captures_generated_ = true;
+				this->quiets_generated_ = this->gen_type_ != GenType::all;
+			};
+			this->stage_ = Stage::good_captures;
+			[[fallthrough]];
+
+		case Stage::good_captures:
+			while (this->good_capture_at_ < this->captures_end_)
+			{
+				const auto _move = this->select_best(this->good_capture_at_, this->captures_end_);
+				if (_move == this->hash_move_)
+				{
+					continue;
+				};
+
+				// Taking something worth at least the attacker can not lose material, anything else has to
+				// survive the exchange that follows. Losing captures are kept for last in the order they came out.
+				const auto _moved = this->board_.get(_move.from());
+				if (capture_victim_value(this->board_, _moved, _move) < capture_order_value(_moved.type()) &&
+					static_exchange(this->board_, _move) < 0)
+				{
+					this->moves_[this->bad_captures_end_++] = this->moves_[this->good_capture_at_ - 1];
+					continue;
+				};
+				return _move;
+			};
+			this->stage_ = Stage::killers;
+			[[fallthrough]];
+
+		case Stage::killers:
+			while (this->killer_at_ < this->killers_.size())
+			{
+				// Only quiet moves can be killers, a pawn stepping sideways onto an empty square is en passant
+				auto& _killer = this->killers_[this->killer_at_];
+				const auto _moved = (_killer) ? this->board_.get(_killer.from()) : Piece();
+				const bool _isQuiet = _killer && _moved &&
+					this->board_.get(_killer.to()).type() == PieceType::none &&
+					!(_moved == PieceType::pawn && _killer.from().file() != _killer.to().file()) &&
+					!is_queen_promotion(_moved, _killer);
+				if (!_isQuiet || this->is_handed_out(_killer) || !is_legal(this->board_, _killer))
+				{
+					_killer = Move();
+					++this->killer_at_;
+					continue;
+				};
+				++this->killer_at_;
+				return _killer;
+			};
+			this->stage_ = Stage::generate_quiets;
+			[[fallthrough]];
+
+		case Stage::generate_quiets:
+			if (!this->quiets_generated_)
+			{
+				this->generate(GenType::quiets);
+				this->quiets_generated_ = true;
+			};
+			this->stage_ = Stage::quiets;
+			[[fallthrough]];
+
+		case Stage::quiets:
+			while (this->quiet_at_ < this->count_)
+			{
+				const auto _move = (this->heuristics_) ?
+					this->select_best(this->quiet_at_, this->count_) :
+					this->moves_[this->quiet_at_++].move();
+				if (!this->is_handed_out(_move))
+				{
+					return _move;
+				};
+			};
+			this->stage_ = Stage::bad_captures;
+			[[fallthrough]];
+
+		case Stage::bad_captures:
+			if (this->bad_capture_at_ < this->bad_captures_end_)
+			{
+				return this->moves_[this->bad_capture_at_++].move();
+			};
+			this->stage_ = Stage::done;
+			[[fallthrough]];
+
+		case Stage::done:
+			[[fallthrough]];
+		default:
+			return Move();
+		};
+	};
+
+	MovePicker::MovePicker(const Board& _board, Move _hashMove, std::span<const Move> _killers) :
+		board_(_board),
+		hash_move_(_hashMove)
+	{
+		const auto _killerCount = std::min(_killers.size(), this->killers_.size());
+		std::copy_n(_killers.begin(), _killerCount, this->killers_.begin());
+	};
+	MovePicker::MovePicker(const Board& _board, Move _hashMove, const SearchHeuristics& _heuristics,
+		size_t _ply, Move _previous) :
+		board_(_board),
+		hash_move_(_hashMove),
+		heuristics_(&_heuristics)
+	{
+		const auto _killers = _heuristics.killers(_ply);
+		std::copy(_killers.begin(), _killers.end(), this->killers_.begin());
+		if (_previous)
+		{
+			this->killers_.back() = _heuristics.counter_move(_previous);
+		};
+	};
+	MovePicker::MovePicker(const Board& _board, GenType _genType) :
+		board_(_board),
+		hash_move_(),
+		gen_type_(_genType)
+	{};
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+/** @file */
+
+#include "move.hpp"
+#include "search_heuristics.hpp"
+
+#include <span>
+#include <array>
+#include <cstdint>
+
+namespace chess
+{
+	/**
+	 * @brief Hands out the legal moves for a position one at a time in the order they should be searched.
+	 *
+	 * Moves come out in stages : the hash move, captures that do not lose material (MVV-LVA), killer moves and
+	 * the counter move, quiet moves and then captures that lose material by static exchange evaluation. The hash
+	 * move and killers are checked for legality on their own, captures are only generated once the hash move is
+	 * searched and quiets once the killers are, and a capture is only run through static exchange evaluation when
+	 * it is selected. Each call to next() only selects the single best remaining move, so a node that cuts off
+	 * early skips the work for everything it never searches. Given search heuristics, quiet moves come out by
+	 * history score.
+	*/
+	class MovePicker
+	{
+	public:
+
+		enum class Stage : uint8_t
+		{
+			hash_move,
+			generate_captures,
+			good_captures,
+			killers,
+			generate_quiets,
+			quiets,
+			bad_captures,
+			done,
+		};
+
+		/**
+		 * @brief Gets the next move to search.
+		 * @return Next move, or a null move once every legal move has been handed out.
+		*/
+		Move next();
+
+		/**
+		 * @brief Gets the stage the picker is currently handing out moves from.
+		*/
+		Stage stage() const noexcept
+		{
+			return this->stage_;
+		};
+
+		/**
+		 * @brief Gets the number of legal moves in the position, generating every one of them if that has not happened yet.
+		 * @return Legal move count.
+		*/
+		size_t size();
+
+		/**
+		 * @brief Creates a move picker for the player to move.
+		 * @param _board Board to pick moves for, must outlive the picker and not change while picking.
+		 * @param _hashMove Move to try first, ignored if null or not legal.
+		 * @param _killers Quiet moves that caused cutoffs in sibling nodes, tried before the other quiets.
+		*/
+		explicit MovePicker(const Board& _board, Move _hashMove = Move(), std::span<const Move> _killers = {});
+
+		/**
+		 * @brief Creates a move picker that orders quiet moves with the tables learnt by the search.
+		 * @param _board Board to pick moves for, must outlive the picker and not change while picking.
+		 * @param _hashMove Move to try first, ignored if null or not legal.
+		 * @param _heuristics Search tables, must outlive the picker.
+		 * @param _ply Plies from the root of the search to the board.
+		 * @param _previous Move that led to the board, may be null.
+		*/
+		MovePicker(const Board& _board, Move _hashMove, const SearchHeuristics& _heuristics, size_t _ply, Move _previous);
+
+		/**
+		 * @brief Creates a move picker that only hands out one kind of move, used by the quiescence search for captures.
+		 * @param _board Board to pick moves for, must outlive the picker and not change while picking.
+		 * @param _genType Kind of moves to hand out.
+		*/
+		MovePicker(const Board& _board, GenType _genType);
+
+	private:
+
+		/**
+		 * @brief Generates legal moves, adding captures to the end of the capture list and quiets after them.
+		 * @param _genType Kind of moves to generate, captures must be generated before any quiets.
+		*/
+		void generate(GenType _genType);
+
+		/**
+		 * @brief Checks if a move was already handed out by the hash move or killer stages.
+		*/
+		bool is_handed_out(Move _move) const;
+
+		/**
+		 * @brief Swaps the best scored move in [at, end) to the front and returns it.
+		*/
+		Move select_best(uint8_t& _at, uint8_t _end);
+
+		/**
+		 * @brief Maximum number of killer moves checked, the counter move takes the last slot.
+		*/
+		constexpr static size_t max_killers_v = SearchHeuristics::killer_count_v + 1;
+
+		const Board& board_;
+
+		// Moves are laid out as [captures][quiets], captures found to lose material are moved to the front
+		// of the capture list once they have been selected
+		std::array<ScoredMove, 256> moves_;
+
+		std::array<Move, max_killers_v> killers_{};
+
+		Move hash_move_;
+
+		/**
+		 * @brief Orders the quiet moves by history if set.
+		*/
+		const SearchHeuristics* heuristics_ = nullptr;
+
+		uint8_t count_ = 0;
+		uint8_t captures_end_ = 0;
+		uint8_t bad_captures_end_ = 0;
+
+		uint8_t good_capture_at_ = 0;
+		uint8_t bad_capture_at_ = 0;
+		uint8_t quiet_at_ = 0;
+		uint8_t killer_at_ = 0;
+
+		Stage stage_ = Stage::hash_move;
+		GenType gen_type_ = GenType::all;
+		bool captures_generated_ = false;
+		bool quiets_generated_ = false;
+	};
+};
@@ -1,9 +1,17 @@
 #include "move_tree.hpp"
 
+#include "search.hpp"
+
 #include "fen.hpp"
+#include "move_picker.hpp"
 
 #include "utility/logging.hpp"
 
+#include <new>
+#include <cmath>
+#include <array>
+#include <mutex>
+#include <memory>
 #include <iostream>
 
 #include <jclib/type.h>
@@ -16,24 +24,97 @@ namespace chess
 	*/
 	constexpr inline bool disable_culling_repeated_positions_v = true;
 
+	/**
+	 * @brief Fewest plies left to search below a node for the parallel search to split its moves between threads.
+	*/
+	constexpr inline uint8_t parallel_split_min_depth_v = 3;
+
 
 
 	namespace impl
 	{
+		namespace
+		{
+			/**
+			 * @brief Placed in front of every block of nodes so the block can be freed the way it was allocated.
+			*/
+			struct alignas(MoveTreeNode) BlockHeader
+			{
+				uint32_t count_ = 0;
+				bool in_arena_ = false;
+			};
+
+			/**
+			 * @brief Alignment of the nodes in a block, blocks start on a cache line.
+			*/
+			constexpr inline size_t block_alignment_v = 64;
+
+			/**
+			 * @brief Arena the calling thread allocates node blocks from, null to allocate them from the heap.
+			*/
+			thread_local sch::MonotonicArena* this_thread_arena_ = nullptr;
+
+			/**
+			 * @brief Allocates node blocks on the calling thread from an arena for as long as it lives.
+			*/
+			class ArenaScope
+			{
+			public:
+				explicit ArenaScope(sch::MonotonicArena* _arena) noexcept :
+					previous_(std::exchange(this_thread_arena_, _arena))
+				{};
+				~ArenaScope()
+				{
+					this_thread_arena_ = this->previous_;
+				};
+
+				ArenaScope(const ArenaScope&) = delete;
+				ArenaScope& operator=(const ArenaScope&) = delete;
+
+			private:
+				sch::MonotonicArena* previous_;
+			};
+
+			MoveTreeNode* block_nodes(BlockHeader* _header) noexcept
+			{
+				return reinterpret_cast<MoveTreeNode*>(_header + 1);
+			};
+		};
+
 		MoveTreeNodeBlockAllocator::pointer MoveTreeNodeBlockAllocator::allocate(size_t n) const
 		{
-			auto _mem = new value_type[n]{};
-			SCREEPFISH_ASSERT(_mem);
-			return _mem;
+			const auto _bytes = sizeof(BlockHeader) + n * sizeof(value_type);
+			const auto _arena = this_thread_arena_;
+			const auto _mem = (_arena) ?
+				_arena->allocate(_bytes, block_alignment_v, sizeof(BlockHeader)) :
+				::operator new(_bytes);
+
+			auto _header = new (_mem) BlockHeader{ static_cast<uint32_t>(n), _arena != nullptr };
+			auto _nodes = block_nodes(_header);
+			std::uninitialized_value_construct_n(_nodes, n);
+			return _nodes;
+		};
+		size_t MoveTreeNodeBlockAllocator::block_size(const value_type* p) noexcept
+		{
+			return (reinterpret_cast<const BlockHeader*>(p) - 1)->count_;
 		};
 		void MoveTreeNodeBlockAllocator::deallocate(pointer p) const
 		{
 			SCREEPFISH_ASSERT(p);
-			delete[] p;
+			auto _header = reinterpret_cast<BlockHeader*>(p) - 1;
+			if (_header->in_arena_)
+			{
+				// Freed with the rest of the arena, the nodes below it live there too
+				return;
+			};
+			std::destroy_n(p, _header->count_);
+			_header->~BlockHeader();
+			::operator delete(_header);
 		};
 	};
 
 
+
 	void MoveTreeNode::resort_children()
 	{
 		// Sort children by rating
@@ -98,78 +179,13 @@ namespace chess
 
 
 
-	inline NodeEvalResult get_interesting_lines(
-		const MoveTreeNode& _node,
-		const Board& _previousBoard, const Board& _newBoard, Move _move,
-		const MoveTreeProfile& _profile, MoveTreeSearchData _data)
-	{
-		// Profile aliasing
-		const auto& _followChecks = _profile.follow_checks_;
-		const auto& _followCaptures = _profile.follow_captures_;
-
-		auto _result = NodeEvalResult();
-
-		// Follow captures if set.
-		if (_data.can_go_deeper())
-		{
-			// Follow captures if set.
-			if (_followCaptures && is_piece_capture(_previousBoard, _move))
-			{
-				_result.follow_capture_ = true;
-			}
-			// Follow checks if set.
-			else if (_followChecks && is_check(_newBoard, _newBoard.get_toplay()))
-			{
-				_result.follow_check_ = true;
-			};
-		};
-
-		return _result;
-	};
-
-	inline void follow_move_lines_with_profile(
-		MoveTreeNode& _node,
-		const Board& _previousBoard, const Board& _newBoard, Move _move,
-		const MoveTreeProfile& _profile, MoveTreeSearchData _data)
-	{
-		// Profile aliasing
-		const auto& _followChecks = _profile.follow_checks_;
-		const auto& _followCaptures = _profile.follow_captures_;
-
-		// Follow captures if set.
-		if (_data.can_go_deeper())
-		{
-			// Follow captures if set.
-			if (_followCaptures && is_piece_capture(_previousBoard, _move))
-			{
-				auto _nestedProf = _profile;
-				_nestedProf.follow_captures_ = false;
-				_node.evaluate_next(_previousBoard, _nestedProf, _data.with_next_depth());
-			}
-			// Follow checks if set.
-			else if (_followChecks && is_check(_newBoard, _newBoard.get_toplay()))
-			{
-				_node.evaluate_next(_previousBoard, _profile, _data.with_next_depth());
-			};
-		};
-	};
-
-
-
-
-	NodeEvalResult MoveTreeNode::evaluate_next_with_board(const Board& _board,
+	void MoveTreeNode::evaluate_next_with_board(Board& _board,
 		const MoveTreeProfile& _profile, MoveTreeSearchData _data, bool _autoProp)
 	{
-		// Profile aliasing
-		const auto& _followChecks = _profile.follow_checks_;
-		const auto& _followCaptures = _profile.follow_captures_;
-
 		// Grab the opponents color and our color.
 		const auto _opponentColor = _board.get_toplay();
 		const auto _myColor = !_opponentColor;
 
-		auto _evalResult = NodeEvalResult();
-
 		if (!this->was_evaluated() && _data.can_go_deeper())
 		{
 			// Get the possible responses
@@ -184,11 +200,10 @@ namespace chess
 			{
 				// Apply the move to the board with our move played.
 				const auto& _move = *p;
-				auto _newBoard = _board;
-				_newBoard.move(_move);
+				const auto _undo = _board.make(_move);
 
 				// Lightning fast rating.
-				const auto _rating = quick_rate(_newBoard, _opponentColor);
+				const auto _rating = quick_rate(_board, _opponentColor);
 
 				// Assign values
 				it->set_move(
@@ -197,8 +212,8 @@ namespace chess
 				);
 				it->depth_ = this->depth_ + 1;
 
-				// Follow lines based on profile.
-				_evalResult = get_interesting_lines(*it, _board, _newBoard, _move, _profile, _data);
+				// Take the move back for the next response
+				_board.unmake(_move, _undo);
 
 				// Next
 				++it;
@@ -218,16 +233,14 @@ namespace chess
 
 			//SCREEPFISH_BREAK();
 		};
-
-		return _evalResult;
 	};
 
-	NodeEvalResult MoveTreeNode::evaluate_next(const Board& _previousBoard,
+	void MoveTreeNode::evaluate_next(Board& _previousBoard,
 		const MoveTreeProfile& _profile, MoveTreeSearchData _data, bool _autoProp)
 	{
-		auto _board = _previousBoard;
-		_board.move(this->move_);
-		return this->evaluate_next_with_board(_board, _profile, _data, _autoProp);
+		const auto _undo = _previousBoard.make(this->move_);
+		this->evaluate_next_with_board(_previousBoard, _profile, _data, _autoProp);
+		_previousBoard.unmake(this->move_, _undo);
 	};
 
 
@@ -293,32 +306,32 @@ namespace chess
 
 
 
-	void MoveTreeNode::count_duplicates(Board _board, std::set<size_t>& _boards)
+	void MoveTreeNode::count_duplicates(Board& _board, std::set<size_t>& _boards)
 	{
 		// Apply our move.
 		for (auto it = this->begin(); it != this->end(); ++it)
 		{
 			auto& _move = *it;
-			auto b = _board;
-			b.move(_move.move_);
-			const auto h = hash(b, b.get_toplay() == Color::black);
+			const auto _undo = _board.make(_move.move_);
+			const auto h = hash(_board, _board.get_toplay() == Color::black);
 			_boards.insert(h);
-			_move.count_duplicates(b, _boards);
+			_move.count_duplicates(_board, _boards);
+			_board.unmake(_move.move_, _undo);
 		};
 	};
 
-	size_t MoveTreeNode::count_checks(Board _board) const
+	size_t MoveTreeNode::count_checks(Board& _board) const
 	{
 		size_t n = 0;
 		for (auto& m : *this)
 		{
-			auto b = _board;
-			b.move(m.move_);
-			if (is_check(b, Color::white) || is_check(b, Color::black))
+			const auto _undo = _board.make(m.move_);
+			if (is_check(_board, Color::white) || is_check(_board, Color::black))
 			{
 				++n;
 			};
-			n += m.count_checks(b);
+			n += m.count_checks(_board);
+			_board.unmake(m.move_, _undo);
 		};
 		return n;
 	};
@@ -457,7 +470,7 @@ namespace chess
 
 
 
-	inline Rating minimax(const Board& _board, MoveTreeNode& _node,
+	inline Rating minimax(Board& _board, MoveTreeNode& _node,
 		bool _isMaximizingPlayer)
 	{
 		if (_node.empty() || !_node.was_evaluated())
@@ -471,12 +484,12 @@ namespace chess
 			for (auto& _move : _node)
 			{
 				// Play the next move.
-				auto _newBoard = _board;
-				_newBoard.move(_move.move_);
+				const auto _undo = _board.make(_move.move_);
 					
 				// Find rating for response move.
 				const auto _newBoardRating =
-					minimax(_newBoard, _move, !_isMaximizingPlayer);
+					minimax(_board, _move, !_isMaximizingPlayer);
+				_board.unmake(_move.move_, _undo);
 				_value = std::max(_value, _newBoardRating);
 			};
 
@@ -496,7 +509,8 @@ namespace chess
 		//is_forced_mate(_node, _node.played_by());
 			
 		// Calculate the deep rating
-		const auto _deepRating = AbsoluteRating(minimax(_board, _node, true), _node.played_by());
+		auto _workingBoard = _board;
+		const auto _deepRating = AbsoluteRating(minimax(_workingBoard, _node, true), _node.played_by());
 
 
 
@@ -519,50 +533,53 @@ namespace chess
 
 
 
-	inline void alpha_beta_eval(MoveTreeNode& _node, const Board& _board,
-		MoveTreeProfile& _profile, MoveTreeSearchData& _searchData)
+#ifdef SCREEPFISH_DEBUG_ALPHABETA
+#define IF_SCREEPFISH_DEBUG_ALPHABETA(...) __VA_ARGS__
+#else
+#define IF_SCREEPFISH_DEBUG_ALPHABETA(...) 
+#endif
+
+#ifdef SCREEPFISH_DEBUG_ALPHABETA
+	/**
+	 * @brief Records the moves a cutoff skipped for debugging.
+	*/
+	inline void add_pruned_nodes(const Board& _board, MovePicker& _picker, std::vector<impl::PrunedNode>* _prunedNodes)
 	{
-		const auto _evalResult = _node.evaluate_next_with_board(_board, _profile, _searchData, false);
-		if (_evalResult.follow_capture_)
+		if (!_prunedNodes)
 		{
-			++_searchData.max_depth_;
-			_profile.follow_captures_ = false;
-		}
-		else if (_evalResult.follow_check_)
-		{
-			++_searchData.max_depth_;
-			_profile.follow_checks_ = false;
+			return;
 		};
 
-		//if (_node.was_evaluated())
-		//{
-		//	if (std::isfinite(_node.quick_rating()))
-		//	{
-		//		// STALEMATE
-		//		_node.set_rating(AbsoluteRating(0));
-		//	}
-		//	//else
-		//	//{
-		//		// CHECKMATE
-		//	//};
-		//};
-
-		// Sort children by quick evaluation rating
-		_node.resort_children_by_quick_rating();
+		for (auto _move = _picker.next(); _move; _move = _picker.next())
+		{
+			auto _pruned = MoveTreeNode();
+			_pruned.set_move(RatedMove(_move, 0), _board.get_toplay());
+			_pruned.set_pruned();
+			_prunedNodes->push_back(impl::PrunedNode{ _board, _pruned });
+		};
 	};
-
-#ifdef SCREEPFISH_DEBUG_ALPHABETA
-#define IF_SCREEPFISH_DEBUG_ALPHABETA(...) __VA_ARGS__
-#else
-#define IF_SCREEPFISH_DEBUG_ALPHABETA(...) 
 #endif
 
 	/**
 	 * @brief Fills a move tree using alpha-beta pruning.
 	 * 
-	 * Depth first.
+	 * Depth first. Moves are handed out by a MovePicker and a response node is only added and
+	 * rated once its move is actually searched, moves skipped by a cutoff cost nothing.
+	 * 
+	 * Principal variation search, only the first move is searched with the full window. Every later
+	 * move is expected to be worse and is searched with a null window that only proves it, a move
+	 * that turns out better than the bound is searched again with the full window.
 	 * 
-	 * @param _board Board with the given node's move played.
+	 * With pruning enabled in the profile, nodes searched with a null window may be cut off by a null move
+	 * or by their static rating, and quiet moves may be skipped near the leaves or searched less deeply
+	 * late in the move order.
+	 * 
+	 * @param _board Board with the given node's move played, restored before returning.
+	 * @param _history Positions played before the board, restored before returning.
+	 * @param _tt Transposition table to probe and fill, may be null.
+	 * @param _stop Polled at each node, once stopped the search unwinds with a meaningless rating. May be null.
+	 * @param _pool Threads to search sibling moves on in parallel, may be null to search serially.
+	 * @param _heuristics Move ordering tables to use and update, may be null.
 	 * @param _node Node to fill from.
 	 * @param _profile Move tree profile settings.
 	 * @param _searchData Search data.
@@ -571,7 +588,8 @@ namespace chess
 	 * 
 	 * @return Rating for the position.
 	*/
-	inline Rating alpha_beta(const Board& _board,
+	inline Rating alpha_beta(Board& _board, PositionHistory& _history, TranspositionTable* _tt, SearchStop* _stop,
+		WorkStealingPool* _pool, SearchHeuristics* _heuristics,
 		MoveTreeNode& _node, MoveTreeProfile _profile, MoveTreeSearchData _searchData,
 		MoveTreeAlphaBeta _alphaBeta, bool _isMaximizingPlayer = true
 		IF_SCREEPFISH_DEBUG_ALPHABETA(, std::vector<impl::PrunedNode>* _prunedNodes = nullptr)
@@ -579,33 +597,512 @@ namespace chess
 	{
 		if (!_searchData.can_go_deeper() /* or node is a terminal node */)
 		{
-			return (_isMaximizingPlayer)?
-				_node.player_rating() : -_node.player_rating();
+			// The node's rating is for the player that played its move, which is the
+			// minimizing player when it is the maximizing player's turn.
+			if (!_profile.quiescence_)
+			{
+				return (_isMaximizingPlayer)?
+					-_node.player_rating() : _node.player_rating();
+			};
+
+			// Quiescence works from the side to move's view like the table, the static rating was
+			// already found when the node was added
+			const auto _standPat = -_node.quick_rating();
+			const auto _value = (_isMaximizingPlayer) ?
+				quiescence(_board, _alphaBeta.alpha, _alphaBeta.beta, _standPat, _stop) :
+				-quiescence(_board, -_alphaBeta.beta, -_alphaBeta.alpha, _standPat, _stop);
+
+			// Stored on the leaf so the tree's minimax agrees with the search
+			_node.set_rating(AbsoluteRating((_isMaximizingPlayer) ? -_value : _value, _node.played_by()));
+			return _value;
 		};
 
 		SCREEPFISH_ASSERT(_board.get_last_move() == _node.move_);
-		alpha_beta_eval(_node, _board, _profile, _searchData);
-		
-		if (_isMaximizingPlayer)
+
+		if (_stop && _stop->poll())
 		{
-			auto _value = -Rating(std::numeric_limits<Rating>::infinity());// _alphaBeta.alpha;
+			return Rating(0);
+		};
+
+		// Leaves the node without responses, holding a rating found without searching them
+		const auto _setLeaf = [&](Rating _value)
+		{
+			// Left as a leaf so the tree's minimax agrees with the search
+			_node.clear();
+			_node.set_rating(AbsoluteRating((_isMaximizingPlayer) ? -_value : _value, _node.played_by()));
+			return _value;
+		};
+
+		// Table scores are for the side to move, the search's are for the maximizing player
+		const auto _depthLeft = static_cast<uint8_t>(_searchData.max_depth_ - _searchData.depth_);
+		const auto _hash = _board.get_hash();
+		auto _hashMove = Move();
+		if (const auto _entry = (_tt) ? _tt->probe(_hash) : std::nullopt; _entry)
+		{
+			_hashMove = _entry->move_;
+
+			// Never cut at the root, it needs its responses to pick a move from
+			if (_searchData.depth_ != 0 && _entry->depth_ >= _depthLeft)
+			{
+				const auto _value = (_isMaximizingPlayer) ? _entry->score_ : -_entry->score_;
+				const auto _isLower = _entry->bound_ == ((_isMaximizingPlayer) ? Bound::lower : Bound::upper);
+				const auto _isUpper = _entry->bound_ == ((_isMaximizingPlayer) ? Bound::upper : Bound::lower);
+				if (_entry->bound_ == Bound::exact ||
+					(_isLower && _value > _alphaBeta.beta) ||
+					(_isUpper && _value < _alphaBeta.alpha))
+				{
+					return _setLeaf(_value);
+				};
+			};
+		};
+
+		// Selective search only happens in nodes searched with a null window, the root and the principal
+		// variation are searched in full. Ratings and bounds below are from the side to move's view.
+		const auto _player = _board.get_toplay();
+		const auto _forMover = [&](Rating _value)
+		{
+			return (_isMaximizingPlayer) ? _value : -_value;
+		};
+		const auto _moverAlpha = (_isMaximizingPlayer) ? _alphaBeta.alpha : -_alphaBeta.beta;
+		const auto _moverBeta = (_isMaximizingPlayer) ? _alphaBeta.beta : -_alphaBeta.alpha;
+		const auto _staticRating = -_node.quick_rating();
+		const auto _pliesLeft = static_cast<uint8_t>(_depthLeft - 1);
+		const bool _inCheck = is_check(_board, _player);
+		const bool _isNullWindow =
+			_alphaBeta.beta <= std::nextafter(_alphaBeta.alpha, std::numeric_limits<Rating>::infinity());
+		const bool _canPrune = _profile.enable_pruning_ && _searchData.depth_ != 0 && _isNullWindow &&
+			!_inCheck && std::isfinite(_staticRating);
+
+		// Reverse futility, far enough above beta that no move is expected to bring the rating back down
+		if (_canPrune && _profile.futility_pruning_ && _pliesLeft <= reverse_futility_max_plies_v)
+		{
+			const auto _margin = futility_margin_v * static_cast<Rating>(_pliesLeft);
+			if (_staticRating - _margin > _moverBeta)
+			{
+				return _setLeaf(_forMover(_staticRating - _margin));
+			};
+		};
+
+		// Null move, if passing the turn still fails high then a real move surely would. Never twice in a row
+		// and never with only pawns left, where passing is often the best move there is.
+		if (_canPrune && _profile.null_move_pruning_ && _searchData.allow_null_move_ && _node.move_ &&
+			_pliesLeft >= null_move_min_plies_v && _staticRating > _moverBeta)
+		{
+			const auto _pieces = non_pawn_piece_count(_board, _player);
+			if (_pieces != 0)
+			{
+				const auto _reduction = static_cast<uint8_t>(null_move_reduction_v + (_pliesLeft >= 6));
+
+				// Null window just past beta
+				auto _nullAlphaBeta = _alphaBeta;
+				if (_isMaximizingPlayer)
+				{
+					_nullAlphaBeta.alpha = _alphaBeta.beta;
+					_nullAlphaBeta.beta = std::nextafter(_alphaBeta.beta, std::numeric_limits<Rating>::infinity());
+				}
+				else
+				{
+					_nullAlphaBeta.alpha = std::nextafter(_alphaBeta.alpha, -std::numeric_limits<Rating>::infinity());
+					_nullAlphaBeta.beta = _alphaBeta.alpha;
+				};
+
+				// The position is not added to the history, nothing after a null move can really repeat it
+				auto _nullNode = MoveTreeNode();
+				const auto _undo = _board.make_null();
+				_nullNode.set_move(RatedMove(Move(), quick_rate(_board, _player)), _player);
+				auto _value = alpha_beta(_board, _history, _tt, _stop, _pool, _heuristics, _nullNode,
+					_profile, _searchData.with_next_depth().with_reduced_depth(_reduction),
+					_nullAlphaBeta, !_isMaximizingPlayer
+					IF_SCREEPFISH_DEBUG_ALPHABETA(, nullptr)
+				);
+				_board.unmake_null(_undo);
+				if (_stop && _stop->stopped())
+				{
+					return Rating(0);
+				};
+
+				// Zugzwang is likely with so few pieces, make sure a normal search agrees
+				if (_forMover(_value) > _moverBeta && _pieces <= null_move_verify_max_pieces_v)
+				{
+					auto _verifyData = _searchData.with_reduced_depth(_reduction);
+					_verifyData.allow_null_move_ = false;
+					_value = alpha_beta(_board, _history, _tt, _stop, _pool, _heuristics, _node,
+						_profile, _verifyData, _alphaBeta, _isMaximizingPlayer
+						IF_SCREEPFISH_DEBUG_ALPHABETA(, _prunedNodes)
+					);
+					if (_stop && _stop->stopped())
+					{
+						return Rating(0);
+					};
+				};
 
-			auto it = _node.begin();
-			const auto _end = _node.end();
+				// A mate found after passing is not a mate the opponent can be forced into
+				if (_forMover(_value) > _moverBeta)
+				{
+					return _setLeaf((std::isfinite(_value)) ? _value : _forMover(_moverBeta));
+				};
+			};
+		};
+
+		const auto _initialAlphaBeta = _alphaBeta;
+		auto _bestMove = Move();
+		bool _cutoff = false;
+
+		// Quiet moves that cut off are remembered to order quiet moves in the rest of the search
+		const auto _ply = static_cast<size_t>(_searchData.depth_);
+		const auto _previousMove = static_cast<const Move&>(_node.move_);
+		auto _picker = (_heuristics) ?
+			MovePicker(_board, _hashMove, *_heuristics, _ply, _previousMove) :
+			MovePicker(_board, _hashMove);
+
+		// Mates and stalemates are already scored by the static rating
+		if (_picker.size() == 0 && _searchData.depth_ != 0)
+		{
+			return _setLeaf(_forMover(_staticRating));
+		};
+
+		auto _triedQuiets = std::array<Move, 64>{};
+		size_t _triedQuietCount = 0;
+		const auto _isQuiet = [&](Move _move)
+		{
+			return _move.promotion() == PieceType::none && !is_piece_capture(_board, _move);
+		};
+		const auto _recordTried = [&](Move _move)
+		{
+			if (_triedQuietCount != _triedQuiets.size() && _isQuiet(_move))
+			{
+				_triedQuiets[_triedQuietCount++] = _move;
+			};
+		};
+		const auto _recordCutoff = [&](Move _move, std::span<const Move> _tried)
+		{
+			if (_heuristics && _isQuiet(_move))
+			{
+				_heuristics->update_cutoff(_board.get_toplay(), _move, _ply, _previousMove, _tried, _depthLeft);
+			};
+		};
+
+		// Responses are rebuilt as they are searched
+		_node.reserve_responses(static_cast<MoveTreeNode::size_type>(_picker.size()));
 
-			for (; it != _end; ++it)
+		// Adds the response node for a move that was just made on the board, null if the move ends the line as a draw.
+		const auto _prepareMove = [&](Move _move) -> MoveTreeNode*
+		{
+			const auto _player = !_board.get_toplay();
+
+			// Repeating a position or running out the fifty move clock ends the line as a draw
+			if (_history.is_repetition(_board) || _board.get_half_move_count() >= fifty_move_rule_half_moves_v)
 			{
-				auto& _move = *it;
+				_node.add_response(RatedMove{ _move, Rating(0) }, _player);
+				return nullptr;
+			};
+
+			// Lightning fast rating, only done for moves that are searched.
+			return &_node.add_response(RatedMove{ _move, quick_rate(_board, _player) }, _player);
+		};
+
+		// Rating every futility pruned move is assumed to reach at most
+		const bool _canFutilityPrune = _canPrune && _profile.futility_pruning_ && _pliesLeft <= futility_max_plies_v &&
+			_staticRating + futility_margin_v * static_cast<Rating>(_pliesLeft) <= _moverAlpha;
+		const auto _futilityRating = _forMover(_staticRating + futility_margin_v * static_cast<Rating>(_pliesLeft));
 
-				auto _newBoard = _board;
-				_newBoard.move(_move.move_);
+		// Decides how deep to search a move that was just made on the board, given how many moves came before it
+		// and the stage of the move picker it came from. Returns the plies to reduce it by, or null to skip it.
+		const auto _selectMove = [&](Move _move, bool _isQuietMove, size_t _index, MovePicker::Stage _stage)
+			-> std::optional<uint8_t>
+		{
+			// Captures, promotions and checks are always searched in full
+			if (_index == 0 || !_profile.enable_pruning_ || _inCheck || !_isQuietMove ||
+				is_check(_board, _board.get_toplay()))
+			{
+				return 0;
+			};
+			if (_canFutilityPrune)
+			{
+				return std::nullopt;
+			};
+
+			// Killers and the counter move are not reduced, other quiets less so when they have a good history
+			if (!_profile.late_move_reductions_ || _stage != MovePicker::Stage::quiets ||
+				_index < late_move_min_index_v || _pliesLeft < late_move_min_plies_v)
+			{
+				return 0;
+			};
+			int _reduction = 1 + (_index >= 8) + (_index >= 16 && _pliesLeft >= 6);
+			if (_heuristics)
+			{
+				const auto _score = _heuristics->history(_player, _move);
+				if (_score > SearchHeuristics::max_history_v / 2)
+				{
+					--_reduction;
+				}
+				else if (_score < 0)
+				{
+					++_reduction;
+				};
+			};
+			return static_cast<uint8_t>(std::clamp(_reduction, 0, _pliesLeft - 1));
+		};
 
-				const auto _moveAB = alpha_beta(_newBoard, _move, _profile,
-					_searchData.with_next_depth(),
-					_alphaBeta, false
-					IF_SCREEPFISH_DEBUG_ALPHABETA(, _prunedNodes)
+		// Searches a response node with a null window first unless it is the first move, see above.
+		// Reduced moves are first searched with a null window at the reduced depth.
+		const auto _searchResponse = [&](Board& _moveBoard, PositionHistory& _moveHistory, SearchStop* _moveStop,
+			MoveTreeNode& _response, MoveTreeAlphaBeta _moveAlphaBeta, bool _isFirst, uint8_t _reduction
+			IF_SCREEPFISH_DEBUG_ALPHABETA(, std::vector<impl::PrunedNode>* _movePrunedNodes))
+		{
+			const auto _search = [&](MoveTreeAlphaBeta _window, uint8_t _plies = 0)
+			{
+				return alpha_beta(_moveBoard, _moveHistory, _tt, _moveStop, _pool, _heuristics, _response,
+					_profile, _searchData.with_next_depth().with_reduced_depth(_plies),
+					_window, !_isMaximizingPlayer
+					IF_SCREEPFISH_DEBUG_ALPHABETA(, _movePrunedNodes)
 				);
+			};
+
+			// There is nothing to prove against an unbounded side
+			const auto _bound = (_isMaximizingPlayer) ? _moveAlphaBeta.alpha : _moveAlphaBeta.beta;
+			if (_isFirst || !std::isfinite(_bound))
+			{
+				return _search(_moveAlphaBeta);
+			};
+
+			// Window just past the bound, cutoffs are strict so the next representable rating is needed
+			auto _nullWindow = _moveAlphaBeta;
+			if (_isMaximizingPlayer)
+			{
+				_nullWindow.beta = std::nextafter(_bound, std::numeric_limits<Rating>::infinity());
+			}
+			else
+			{
+				_nullWindow.alpha = std::nextafter(_bound, -std::numeric_limits<Rating>::infinity());
+			};
+
+			// A rating beyond the other bound cuts off anyway and needs no exact score
+			const auto _beatsBound = [&](Rating _value)
+			{
+				return (_isMaximizingPlayer) ?
+					(_value > _moveAlphaBeta.alpha && _value <= _moveAlphaBeta.beta) :
+					(_value < _moveAlphaBeta.beta && _value >= _moveAlphaBeta.alpha);
+			};
+			if (_reduction != 0)
+			{
+				const auto _value = _search(_nullWindow, _reduction);
+				if (!_beatsBound(_value) || (_moveStop && _moveStop->stopped()))
+				{
+					return _value;
+				};
+			};
+
+			const auto _value = _search(_nullWindow);
+			if (!_beatsBound(_value) || (_moveStop && _moveStop->stopped()))
+			{
+				return _value;
+			};
+			return _search(_moveAlphaBeta);
+		};
+
+		// Plays a move, adds its response node and searches it. Null if the move was pruned without searching it.
+		const auto _searchMove = [&](Move _move, MoveTreeAlphaBeta _moveAlphaBeta, bool _isFirst, size_t _index)
+			-> std::optional<Rating>
+		{
+			const auto _isQuietMove = _isQuiet(_move);
+			_history.push(_board);
+			const auto _undo = _board.make(_move);
+
+			auto _moveAB = std::optional<Rating>(Rating(0));
+			const auto _reduction = (_isFirst) ?
+				std::optional<uint8_t>(0) : _selectMove(_move, _isQuietMove, _index, _picker.stage());
+			if (!_reduction)
+			{
+				_moveAB.reset();
+			}
+			else if (const auto _response = _prepareMove(_move); _response)
+			{
+				_moveAB = _searchResponse(_board, _history, _stop, *_response, _moveAlphaBeta, _isFirst, *_reduction
+					IF_SCREEPFISH_DEBUG_ALPHABETA(, _prunedNodes));
+			};
+			_board.unmake(_move, _undo);
+			_history.pop();
+			return _moveAB;
+		};
+
+		// Young brothers wait, once the eldest move has been searched without a cutoff the remaining moves
+		// are searched in parallel. Each is searched with the bounds as they stand when it starts, a cutoff
+		// stops the ones still running and drops them from the node like a serial search never adding them.
+		const auto _searchSiblings = [&](Rating& _value)
+		{
+			struct Sibling
+			{
+				Move move_;
+				MoveTreeNode* response_;
+				uint8_t reduction_ = 0;
+				bool done_ = false;
+			};
+
+			// Pruned moves are left out like the serial loops leave them out
+			auto _siblings = std::vector<Sibling>();
+			for (auto _move = _picker.next(); _move; _move = _picker.next())
+			{
+				const auto _isQuietMove = _isQuiet(_move);
+				_history.push(_board);
+				const auto _undo = _board.make(_move);
+				if (const auto _reduction = _selectMove(_move, _isQuietMove, _siblings.size() + 1, _picker.stage()); _reduction)
+				{
+					_siblings.push_back(Sibling{ _move, _prepareMove(_move), *_reduction });
+				}
+				else
+				{
+					_value = (_isMaximizingPlayer) ? std::max(_value, _futilityRating) : std::min(_value, _futilityRating);
+				};
+				_board.unmake(_move, _undo);
+				_history.pop();
+			};
+
+			auto _splitStop = SearchStop(_stop);
+			const auto _arena = impl::this_thread_arena_;
+			auto _mtx = std::mutex();
+
+			// Folds a finished move into the node, same as the serial loops
+			const auto _finish = [&](Sibling& _sibling, Rating _moveAB)
+			{
+				const auto lck = std::unique_lock(_mtx);
+				_sibling.done_ = true;
+				if ((_isMaximizingPlayer) ? (_moveAB > _value) : (_moveAB < _value))
+				{
+					_bestMove = _sibling.move_;
+					_value = _moveAB;
+				};
+				if (!std::isfinite(_moveAB) || _cutoff)
+				{
+					return;
+				};
+
+				if ((_isMaximizingPlayer) ? (_value > _alphaBeta.beta) : (_value < _alphaBeta.alpha))
+				{
+					_cutoff = true;
+					_splitStop.stop();
+					_recordCutoff(_sibling.move_, {});
+				}
+				else if (_isMaximizingPlayer)
+				{
+					_alphaBeta.alpha = std::max(_alphaBeta.alpha, _value);
+				}
+				else
+				{
+					_alphaBeta.beta = std::min(_alphaBeta.beta, _value);
+				};
+			};
+
+			auto _group = TaskGroup();
+			for (auto& _sibling : _siblings)
+			{
+				if (!_sibling.response_)
+				{
+					_finish(_sibling, Rating(0));
+					continue;
+				};
+
+				_pool->submit(_group, [&, _current = &_sibling]()
+				{
+					auto _moveAlphaBeta = MoveTreeAlphaBeta();
+					{
+						const auto lck = std::unique_lock(_mtx);
+						if (_cutoff || _splitStop.stopped())
+						{
+							return;
+						};
+						_moveAlphaBeta = _alphaBeta;
+					};
+
+					// Each task works on its own copy of the board and history, its nodes go in the same arena
+					const auto _arenaScope = impl::ArenaScope(_arena);
+					auto _siblingBoard = _board;
+					auto _siblingHistory = _history;
+					_siblingHistory.push(_siblingBoard);
+					_siblingBoard.make(_current->move_);
+
+					const auto _moveAB = _searchResponse(_siblingBoard, _siblingHistory, &_splitStop,
+						*_current->response_, _moveAlphaBeta, false, _current->reduction_
+						IF_SCREEPFISH_DEBUG_ALPHABETA(, nullptr));
+					if (!_splitStop.stopped())
+					{
+						_finish(*_current, _moveAB);
+					};
+				});
+			};
+			_pool->wait(_group);
+
+			// Drop the responses that were cut off before they finished, the eldest is always kept
+			if (_cutoff)
+			{
+				MoveTreeNode::size_type _kept = 1;
+				for (MoveTreeNode::size_type n = 0; n != _siblings.size(); ++n)
+				{
+					if (_siblings[n].done_)
+					{
+						if (_kept != n + 1)
+						{
+							_node.at(_kept) = std::move(_node.at(n + 1));
+						};
+						++_kept;
+					};
+				};
+				for (auto n = static_cast<MoveTreeNode::size_type>(_siblings.size() + 1); n != _kept; --n)
+				{
+					_node.at(n - 1) = MoveTreeNode();
+				};
+			};
+		};
 
+		// Only split where there is enough left to search to pay for handing the moves out
+		const bool _canSplit = _pool && _depthLeft >= parallel_split_min_depth_v;
+
+		// Stores the node's result, bounds are flipped to the side to move's view like the score
+		const auto _storeResult = [&](Rating _value)
+		{
+			if (!_tt || !std::isfinite(_value) || (_stop && _stop->stopped()))
+			{
+				return;
+			};
+
+			auto _bound = Bound::exact;
+			if (_isMaximizingPlayer)
+			{
+				_bound = (_cutoff) ? Bound::lower :
+					(_value <= _initialAlphaBeta.alpha) ? Bound::upper : Bound::exact;
+			}
+			else
+			{
+				_bound = (_cutoff) ? Bound::lower :
+					(_value >= _initialAlphaBeta.beta) ? Bound::upper : Bound::exact;
+			};
+			_tt->store(_hash, _bestMove, (_isMaximizingPlayer) ? _value : -_value, _depthLeft, _bound);
+		};
+
+		if (_isMaximizingPlayer)
+		{
+			auto _value = -Rating(std::numeric_limits<Rating>::infinity());// _alphaBeta.alpha;
+
+			size_t _index = 0;
+			for (auto _move = _picker.next(); _move; _move = _picker.next(), ++_index)
+			{
+				const auto _searched = _searchMove(_move, _alphaBeta, !_bestMove, _index);
+				if (_stop && _stop->stopped())
+				{
+					break;
+				};
+				if (!_searched)
+				{
+					_value = std::max(_value, _futilityRating);
+					continue;
+				};
+				const auto _moveAB = *_searched;
+
+				const bool _isEldest = !_bestMove;
+				if (_moveAB > _value || !_bestMove)
+				{
+					_bestMove = _move;
+				};
 				_value = std::max
 				(
 					_value,
@@ -618,29 +1115,11 @@ namespace chess
 					{
 #ifdef SCREEPFISH_DEBUG_ALPHABETA
 						sch::log_info(str::concat_to_string("AB Pruning (Beta) : ",
-							_move.move_, " (fen) \"", get_fen(_board), "\""));
-
-
-
-						if (_prunedNodes)
-						{
-							bool _found = false;
-							for (auto& v : _node)
-							{
-								if (!_found)
-								{
-									if (static_cast<Move&>(v.move_) == static_cast<Move&>(_move.move_))
-									{
-										_found = true;
-									};
-								}
-								else
-								{
-									_prunedNodes->push_back(impl::PrunedNode{ _board, v });
-								};
-							};
-						};
+							_move, " (fen) \"", get_fen(_board), "\""));
+						add_pruned_nodes(_board, _picker, _prunedNodes);
 #endif
+						_recordCutoff(_move, std::span(_triedQuiets.data(), _triedQuietCount));
+						_cutoff = true;
 						break; // (*β cutoff*)
 					};
 					_alphaBeta.alpha = std::max(
@@ -648,34 +1127,43 @@ namespace chess
 						_value
 					);
 				};
-			};
-			for (; it != _end; ++it)
-			{
-				it->set_pruned();
+
+				_recordTried(_move);
+
+				if (_isEldest && _canSplit)
+				{
+					_searchSiblings(_value);
+					break;
+				};
 			};
 
+			_storeResult(_value);
 			return _value;
 		}
 		else
 		{
 			auto _value = Rating(std::numeric_limits<Rating>::infinity());//_alphaBeta.beta;
 
-			auto it = _node.begin();
-			const auto _end = _node.end();
-
-			for (; it != _end; ++it)
+			size_t _index = 0;
+			for (auto _move = _picker.next(); _move; _move = _picker.next(), ++_index)
 			{
-				auto& _move = *it;
-
-				auto _newBoard = _board;
-				_newBoard.move(_move.move_);
-
-				const auto _moveAB = alpha_beta(_newBoard, _move, _profile,
-					_searchData.with_next_depth(),
-					_alphaBeta, true
-					IF_SCREEPFISH_DEBUG_ALPHABETA(, _prunedNodes)
-				);
+				const auto _searched = _searchMove(_move, _alphaBeta, !_bestMove, _index);
+				if (_stop && _stop->stopped())
+				{
+					break;
+				};
+				if (!_searched)
+				{
+					_value = std::min(_value, _futilityRating);
+					continue;
+				};
+				const auto _moveAB = *_searched;
 
+				const bool _isEldest = !_bestMove;
+				if (_moveAB < _value || !_bestMove)
+				{
+					_bestMove = _move;
+				};
 				_value = std::min
 				(
 					_value,
@@ -688,26 +1176,11 @@ namespace chess
 					{
 #ifdef SCREEPFISH_DEBUG_ALPHABETA
 						sch::log_info(str::concat_to_string("AB Pruning (Alpha) : ",
-							_move.move_, " (fen) \"", get_fen(_board), "\""));
-						if (_prunedNodes)
-						{
-							bool _found = false;
-							for (auto& v : _node)
-							{
-								if (!_found)
-								{
-									if (static_cast<Move&>(v.move_) == static_cast<Move&>(_move.move_))
-									{
-										_found = true;
-									};
-								}
-								else
-								{
-									_prunedNodes->push_back(impl::PrunedNode{ _board, v });
-								};
-							};
-						};
+							_move, " (fen) \"", get_fen(_board), "\""));
+						add_pruned_nodes(_board, _picker, _prunedNodes);
 #endif
+						_recordCutoff(_move, std::span(_triedQuiets.data(), _triedQuietCount));
+						_cutoff = true;
 						break; // (*α cutoff*)
 					};
 					_alphaBeta.beta = std::min(
@@ -715,31 +1188,102 @@ namespace chess
 						_value
 					);
 				};
-			};
-			for (; it != _end; ++it)
-			{
-				it->set_pruned();
+
+				_recordTried(_move);
+
+				if (_isEldest && _canSplit)
+				{
+					_searchSiblings(_value);
+					break;
+				};
 			};
 
+			_storeResult(_value);
 			return _value;
 		};
 		::abort();
 	};
 
+	/**
+	 * @brief Fills a move tree using alpha-beta pruning from its root.
+	 * 
+	 * Given an expected rating the root is first searched with an aspiration window around it. A rating
+	 * that falls outside the window is only a bound, so the root is searched again with that side of
+	 * the window widened until the rating lands inside it.
+	 * 
+	 * @param _tree Tree to fill.
+	 * @param _profile Move tree profile settings.
+	 * @param _searchData Search data.
+	 * 
+	 * @return Rating for the side to move.
+	*/
 	inline Rating alpha_beta(MoveTree& _tree,
 		MoveTreeProfile _profile, MoveTreeSearchData _searchData
 		IF_SCREEPFISH_DEBUG_ALPHABETA(, std::vector<impl::PrunedNode>* _prunedNodes = nullptr)
 	)
 	{
+		constexpr auto infinity_v = std::numeric_limits<Rating>::infinity();
+
 		auto _alphaBeta = MoveTreeAlphaBeta();
-		_alphaBeta.alpha = -std::numeric_limits<Rating>::infinity();
-		_alphaBeta.beta = std::numeric_limits<Rating>::infinity();
-		return alpha_beta(_tree.initial_board(), _tree.root(),
-			_profile, _searchData, _alphaBeta, true
+		_alphaBeta.alpha = -infinity_v;
+		_alphaBeta.beta = infinity_v;
+
+		// Mate ratings have nothing to centre a window on
+		const auto _expected = _tree.expected_rating();
+		auto _window = aspiration_window_v;
+		if (_expected && std::isfinite(*_expected))
+		{
+			_alphaBeta.alpha = *_expected - _window;
+			_alphaBeta.beta = *_expected + _window;
+		};
+
+		// Single working board and history for the whole search, moves are made and unmade on them
+		auto _board = _tree.initial_board();
+		auto _history = _tree.history();
+
+		// Searches given no tables learn their own
+		auto _ownHeuristics = std::unique_ptr<SearchHeuristics>();
+		auto _heuristics = _tree.search_heuristics();
+		if (!_heuristics)
+		{
+			_ownHeuristics = std::make_unique<SearchHeuristics>();
+			_heuristics = _ownHeuristics.get();
+		};
+
+		while (true)
+		{
+			const auto _value = alpha_beta(_board, _history, _tree.transposition_table(), _tree.search_stop(),
+				_tree.work_pool(), _heuristics, _tree.root(),
+				_profile, _searchData, _alphaBeta, true
 #ifdef SCREEPFISH_DEBUG_ALPHABETA
-			, _prunedNodes
+				, _prunedNodes
 #endif
-		);
+			);
+			if (const auto _stop = _tree.search_stop(); _stop && _stop->stopped())
+			{
+				return _value;
+			};
+
+			// The root never cuts off early, a rating on or past a bound just means every move was
+			// only proven to be no better or no worse than it.
+			const bool _failedLow = _value <= _alphaBeta.alpha && std::isfinite(_alphaBeta.alpha);
+			const bool _failedHigh = _value >= _alphaBeta.beta && std::isfinite(_alphaBeta.beta);
+			if (!_failedLow && !_failedHigh)
+			{
+				return _value;
+			};
+
+			_window *= 4;
+			const bool _unbounded = _window > max_aspiration_window_v || !std::isfinite(_value);
+			if (_failedLow)
+			{
+				_alphaBeta.alpha = (_unbounded) ? -infinity_v : _value - _window;
+			}
+			else
+			{
+				_alphaBeta.beta = (_unbounded) ? infinity_v : _value + _window;
+			};
+		};
 	};
 
 
@@ -751,6 +1295,7 @@ namespace chess
 
 	void MoveTree::evaluate_next(MoveTreeSearchData _searchData, const MoveTreeProfile& _profile)
 	{
+		const auto _arenaScope = impl::ArenaScope(&this->arena_);
 		auto& _board = this->board_;
 		auto& _root = this->root_;
 
@@ -853,10 +1398,10 @@ namespace chess
 		auto bs = std::set<size_t>();
 		for (auto& _move : _moves)
 		{
-			auto b = _board;
-			b.move(_move.move_);
-			bs.insert(hash(b, b.get_toplay() == Color::black));
-			_move.count_duplicates(b, bs);
+			const auto _undo = _board.make(_move.move_);
+			bs.insert(hash(_board, _board.get_toplay() == Color::black));
+			_move.count_duplicates(_board, bs);
+			_board.unmake(_move.move_, _undo);
 		};
 		return bs.size();
 	};
@@ -904,9 +1449,11 @@ namespace chess
 
 	void MoveTree::build_tree(size_t _depth, size_t _maxExtendedDepth, const MoveTreeProfile& _profile)
 	{
-		// Reset state
+		// Reset state, the old tree is freed all at once with the arena
+		const auto _arenaScope = impl::ArenaScope(&this->arena_);
 		auto& _root = this->root();
 		_root.clear();
+		this->arena_.reset();
 
 		// Additional move tree searching data storage
 		auto _searchData = MoveTreeSearchData();
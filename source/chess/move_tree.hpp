@@ -4,15 +4,23 @@
 
 #include "move.hpp"
 #include "rating.hpp"
+#include "history.hpp"
 #include "board_hash.hpp"
+#include "transposition.hpp"
+#include "search_stop.hpp"
+#include "work_pool.hpp"
+#include "search_heuristics.hpp"
 
 #include "utility/bset.hpp"
 #include "utility/arena.hpp"
+#include "utility/monotonic_arena.hpp"
 
 #include <set>
 #include <vector>
+#include <algorithm>
 #include <random>
 #include <unordered_set>
+#include <utility>
 
 //#define SCREEPFISH_DEBUG_ALPHABETA
 
@@ -29,15 +37,47 @@ namespace chess
 			using pointer = value_type*;
 			pointer allocate(size_t n) const;
 			void deallocate(pointer p) const;
+
+			/**
+			 * @brief Gets the number of nodes an allocated block holds.
+			*/
+			static size_t block_size(const value_type* p) noexcept;
 		};
 	};
 
 
 	struct MoveTreeProfile
 	{
-		bool follow_checks_ = false;
-		bool follow_captures_ = false;
+		/**
+		 * @brief Resolves captures at the leaves of the alpha-beta search with a quiescence search instead of
+		 * taking the leaf's static rating.
+		*/
+		bool quiescence_ = true;
+
+		/**
+		 * @brief Lets the alpha-beta search skip and shorten lines that are unlikely to change the result,
+		 * using whichever of the techniques below are enabled.
+		*/
 		bool enable_pruning_ = false;
+
+		/**
+		 * @brief Cuts off nodes where passing the turn still fails high in a shallower search. Positions with
+		 * little material, where passing may be the best move, are checked with a shallower normal search first.
+		*/
+		bool null_move_pruning_ = true;
+
+		/**
+		 * @brief Searches quiet moves late in the move order less deeply, searching them again at full depth
+		 * if they turn out better than expected.
+		*/
+		bool late_move_reductions_ = true;
+
+		/**
+		 * @brief Near the leaves, skips quiet moves that cannot bring the static rating up to alpha and cuts off
+		 * nodes whose static rating is far enough above beta.
+		*/
+		bool futility_pruning_ = true;
+
 		bool alphabeta_ = false;
 
 		MoveTreeProfile() = default;
@@ -62,6 +102,10 @@ namespace chess
 		uint8_t depth_ = 0;
 		uint8_t max_depth_ = 255;
 
+		/**
+		 * @brief Allows the node to try a null move, cleared while verifying a null move cutoff.
+		*/
+		bool allow_null_move_ = true;
 
 
 
@@ -69,6 +113,18 @@ namespace chess
 		{
 			auto o = MoveTreeSearchData{ *this };
 			++o.depth_;
+			o.allow_null_move_ = true;
+			return o;
+		};
+
+		/**
+		 * @brief Searches fewer plies below the node, never cutting it off before it becomes a leaf.
+		 * @param _plies Plies to take off the search depth.
+		*/
+		MoveTreeSearchData with_reduced_depth(uint8_t _plies) const
+		{
+			auto o = MoveTreeSearchData{ *this };
+			o.max_depth_ = static_cast<uint8_t>(std::max(o.max_depth_ - _plies, o.depth_ + 1));
 			return o;
 		};
 
@@ -104,15 +160,6 @@ namespace chess
 	};
 
 
-	struct NodeEvalResult
-	{
-		bool follow_check_ = false;
-		bool follow_capture_ = false;
-
-		NodeEvalResult() = default;
-	};
-
-
 	struct MoveTreeNode
 	{
 	public:
@@ -202,6 +249,52 @@ namespace chess
 			this->responses_.soft_resize(_size);
 		};
 
+		/**
+		 * @brief Makes room for responses that are added one at a time with add_response(), removing any the node had.
+		 * 
+		 * Marks the node as evaluated, even if there is nothing to add. A node searched again keeps its
+		 * block of responses when it is big enough, so searching it again takes no more memory.
+		 * 
+		 * @param _count Maximum number of responses that will be added.
+		*/
+		void reserve_responses(size_type _count)
+		{
+			// The block holds a null node after the responses
+			if (const auto _data = this->responses_.data();
+				_data && impl::MoveTreeNodeBlockAllocator::block_size(_data) > _count)
+			{
+				for (auto& _response : this->responses_)
+				{
+					_response = MoveTreeNode();
+				};
+				return;
+			};
+
+			this->responses_.clear();
+			if (_count == 0)
+			{
+				this->mark_as_evaluated();
+			}
+			else
+			{
+				this->responses_.resize(_count);
+			};
+		};
+
+		/**
+		 * @brief Adds a response after the ones already added, room must have been made with reserve_responses().
+		 * @param _move Move for the response along with its quick rating.
+		 * @param _playedBy Player that played the response move.
+		 * @return The added response node.
+		*/
+		MoveTreeNode& add_response(RatedMove _move, Color _playedBy)
+		{
+			auto& _response = *this->responses_.end();
+			_response.set_move(_move, _playedBy);
+			_response.depth_ = this->depth_ + 1;
+			return _response;
+		};
+
 		size_type size() const
 		{
 			return static_cast<size_type>(this->responses_.size());
@@ -233,20 +326,33 @@ namespace chess
 			return this->responses_.front();
 		};
 
-		void count_duplicates(Board _board, std::set<size_t>& _boards);
+		/**
+		 * @brief Collects the hashes of every position below this node.
+		 * @param _board Board with this node's move played, restored before returning.
+		 * @param _boards Set to add the position hashes to.
+		*/
+		void count_duplicates(Board& _board, std::set<size_t>& _boards);
 		
 
-		NodeEvalResult evaluate_next_with_board(const Board& _board,
+		/**
+		 * @brief Evaluates the responses to this node's move.
+		 * @param _board Board with this node's move played, restored before returning.
+		*/
+		void evaluate_next_with_board(Board& _board,
 			const MoveTreeProfile& _profile, MoveTreeSearchData _data, bool _autoProp = true);
 
-		NodeEvalResult evaluate_next(const Board& _previousBoard,
+		/**
+		 * @brief Plays this node's move and evaluates the responses to it.
+		 * @param _previousBoard Board before this node's move, restored before returning.
+		*/
+		void evaluate_next(Board& _previousBoard,
 			const MoveTreeProfile& _profile, MoveTreeSearchData _data, bool _autoProp = true);
 
 
 		size_t tree_size() const;
 		size_t total_outcomes() const;
 
-		size_t count_checks(Board _board) const;
+		size_t count_checks(Board& _board) const;
 		
 
 
@@ -316,63 +422,89 @@ namespace chess
 	};
 	
 
-	template <jc::cx_invocable<const Board&> T>
-	inline void foreach_final_position(const Board& _board, const MoveTreeNode& _node, const T& _op)
+	namespace impl
 	{
-		if (_node.empty())
+		// The visitors below walk the tree on a single board, making and unmaking each move.
+
+		template <jc::cx_invocable<const Board&> T>
+		inline void foreach_final_position(Board& _board, const MoveTreeNode& _node, const T& _op)
 		{
-			// If it was evaluated then this is a checkmate.
-			if (_node.was_evaluated())
+			if (_node.empty())
 			{
-				return;
+				// If it was evaluated then this is a checkmate.
+				if (_node.was_evaluated())
+				{
+					return;
+				}
+				else
+				{
+					_op(std::as_const(_board));
+				};
 			}
 			else
 			{
-				_op(_board);
+				for (auto& _response : _node)
+				{
+					const auto _undo = _board.make(_response.move_);
+					foreach_final_position(_board, _response, _op);
+					_board.unmake(_response.move_, _undo);
+				};
+			};
+		};
+
+		template <jc::cx_invocable<const Board&, Move> T>
+		inline void foreach_final_move(Board& _board, const MoveTreeNode& _node, const T& _op)
+		{
+			if (!_node.empty())
+			{
+				for (auto& _response : _node)
+				{
+					if (_response.empty())
+					{
+						_op(std::as_const(_board), _response.move_);
+					}
+					else
+					{
+						const auto _undo = _board.make(_response.move_);
+						foreach_final_move(_board, _response, _op);
+						_board.unmake(_response.move_, _undo);
+					};
+				};
 			};
-		}
-		else
+		};
+
+		template <jc::cx_invocable<const Board&> T>
+		inline void foreach_position(Board& _board, const MoveTreeNode& _node, const T& _op)
 		{
+			_op(std::as_const(_board));
 			for (auto& _response : _node)
 			{
-				auto _nextBoard = _board;
-				_nextBoard.move(_response.move_);
-				foreach_final_position(_nextBoard, _response, _op);
+				const auto _undo = _board.make(_response.move_);
+				foreach_position(_board, _response, _op);
+				_board.unmake(_response.move_, _undo);
 			};
 		};
 	};
 
+	template <jc::cx_invocable<const Board&> T>
+	inline void foreach_final_position(const Board& _board, const MoveTreeNode& _node, const T& _op)
+	{
+		auto _workingBoard = _board;
+		impl::foreach_final_position(_workingBoard, _node, _op);
+	};
+
 	template <jc::cx_invocable<const Board&, Move> T>
 	inline void foreach_final_move(const Board& _board, const MoveTreeNode& _node, const T& _op)
 	{
-		if (!_node.empty())
-		{
-			for (auto& _response : _node)
-			{
-				if (_response.empty())
-				{
-					_op(_board, _response.move_);
-				}
-				else
-				{
-					auto _nextBoard = _board;
-					_nextBoard.move(_response.move_);
-					foreach_final_move(_nextBoard, _response, _op);
-				};
-			};
-		};
+		auto _workingBoard = _board;
+		impl::foreach_final_move(_workingBoard, _node, _op);
 	};
 
 	template <jc::cx_invocable<const Board&> T>
 	inline void foreach_position(const Board& _board, const MoveTreeNode& _node, const T& _op)
 	{
-		_op(_board);
-		for (auto& _response : _node)
-		{
-			auto _nextBoard = _board;
-			_nextBoard.move(_response.move_);
-			foreach_position(_nextBoard, _response, _op);
-		};
+		auto _workingBoard = _board;
+		impl::foreach_position(_workingBoard, _node, _op);
 	};
 
 
@@ -606,6 +738,132 @@ namespace chess
 
 		};
 
+		/**
+		 * @brief Gets the positions played before the initial board.
+		*/
+		const PositionHistory& history() const noexcept
+		{
+			return this->history_;
+		};
+
+		/**
+		 * @brief Sets the positions played before the initial board, the search scores lines that
+		 * repeat any of them as a draw.
+		 * @param _history Positions leading up to the initial board.
+		*/
+		void set_history(PositionHistory _history)
+		{
+			this->history_ = std::move(_history);
+		};
+
+		/**
+		 * @brief Gets the transposition table used by the search, may be null.
+		*/
+		TranspositionTable* transposition_table() const noexcept
+		{
+			return this->tt_;
+		};
+
+		/**
+		 * @brief Sets the transposition table for the search to read and fill.
+		 * @param _tt Table that must outlive the search, or null to search without one.
+		*/
+		void set_transposition_table(TranspositionTable* _tt) noexcept
+		{
+			this->tt_ = _tt;
+		};
+
+		/**
+		 * @brief Gets the object the search polls to know when to stop, may be null.
+		*/
+		SearchStop* search_stop() const noexcept
+		{
+			return this->stop_;
+		};
+
+		/**
+		 * @brief Sets the object the search polls to know when to stop.
+		 * 
+		 * A stopped search leaves the tree partly built, check SearchStop::stopped() before using it.
+		 * 
+		 * @param _stop Object that must outlive the search, or null to always search to full depth.
+		*/
+		void set_search_stop(SearchStop* _stop) noexcept
+		{
+			this->stop_ = _stop;
+		};
+
+		/**
+		 * @brief Gets the threads the search splits sibling moves between, may be null.
+		*/
+		WorkStealingPool* work_pool() const noexcept
+		{
+			return this->pool_;
+		};
+
+		/**
+		 * @brief Sets the threads for the alpha-beta search to split sibling moves between.
+		 * 
+		 * The tree comes out the same shape as a serial search would build it, but which moves are
+		 * cut off can differ as siblings are searched before each other's bounds are known.
+		 * 
+		 * @param _pool Pool that must outlive the search, or null to search on the calling thread only.
+		*/
+		void set_work_pool(WorkStealingPool* _pool) noexcept
+		{
+			this->pool_ = _pool;
+		};
+
+		/**
+		 * @brief Gets the move ordering tables used by the search, may be null.
+		*/
+		SearchHeuristics* search_heuristics() const noexcept
+		{
+			return this->heuristics_;
+		};
+
+		/**
+		 * @brief Sets the move ordering tables for the search to use and update.
+		 * 
+		 * Keeping the tables between searches of the same position, such as the depths of an iterative
+		 * deepening search, lets each search start from what the last one learnt.
+		 * 
+		 * @param _heuristics Tables that must outlive the search, or null for the search to start from empty tables.
+		*/
+		void set_search_heuristics(SearchHeuristics* _heuristics) noexcept
+		{
+			this->heuristics_ = _heuristics;
+		};
+
+		/**
+		 * @brief Gets the rating the search expects for the side to move, if any.
+		*/
+		std::optional<Rating> expected_rating() const noexcept
+		{
+			return this->expected_rating_;
+		};
+
+		/**
+		 * @brief Sets the rating the search expects for the side to move, it starts from a narrow window around it.
+		 * 
+		 * Usually the rating the last depth of an iterative deepening search found. A wrong guess only
+		 * costs searching the root again.
+		 * 
+		 * @param _rating Expected rating, or null to search with an unbounded window.
+		*/
+		void set_expected_rating(std::optional<Rating> _rating) noexcept
+		{
+			this->expected_rating_ = _rating;
+		};
+
+		/**
+		 * @brief Gets the arena the tree's nodes are allocated from, for its memory use.
+		*/
+		const sch::MonotonicArena& arena() const noexcept
+		{
+			return this->arena_;
+		};
+
 
 		MoveTree() = default;
 		MoveTree(const chess::Board& _board) :
@@ -621,6 +879,45 @@ namespace chess
 		*/
 		chess::Board board_{};
 
+		/**
+		 * @brief Positions played before the initial board.
+		*/
+		PositionHistory history_{};
+
+		/**
+		 * @brief Transposition table shared with other searches, not owned.
+		*/
+		TranspositionTable* tt_ = nullptr;
+
+		/**
+		 * @brief Polled by the search to know when to stop, not owned.
+		*/
+		SearchStop* stop_ = nullptr;
+
+		/**
+		 * @brief Threads sibling moves are searched on, not owned.
+		*/
+		WorkStealingPool* pool_ = nullptr;
+
+		/**
+		 * @brief Move ordering tables, not owned.
+		*/
+		SearchHeuristics* heuristics_ = nullptr;
+
+		/**
+		 * @brief Rating the root's aspiration window is centred on.
+		*/
+		std::optional<Rating> expected_rating_{};
+
+		/**
+		 * @brief Holds every node below the root that was added while building or evaluating the tree.
+		 * 
+		 * Rebuilding the tree resets it instead of freeing the nodes one block at a time. Declared before
+		 * the root so it outlives the nodes pointing into it, copies of the tree allocate their nodes from
+		 * the heap instead.
+		*/
+		sch::MonotonicArena arena_;
+
 		/**
 		 * @brief The root node for the tree, holds the last move played for the stored initial board.
 		*/
@@ -0,0 +1,77 @@
+#include "perft.hpp"
+
+#include "move.hpp"
+#include "batch.hpp"
+
+#include <array>
+
+namespace chess
+{
+	namespace
+	{
+		template <Color C>
+		size_t perft_for(Board& _board, size_t _depth, BoardBatch& _batch)
+		{
+			auto _movesData = std::array<Move, max_moves_possible_in_any_position_v>{};
+			auto _moves = MoveBuffer(_movesData);
+			get_moves<C, GenType::all>(_board, _moves);
+
+			// Bulk count the last ply
+			const auto _count = static_cast<size_t>(_moves.head() - _movesData.data());
+			if (_depth == 1)
+			{
+				return _count;
+			}
+			else if (_depth == 2)
+			{
+				// Count the replies to every move at once, the positions are built straight from the bitboards
+				const auto _position = BatchPosition(_board);
+				_batch.clear();
+				for (auto it = _movesData.data(); it != _moves.head(); ++it)
+				{
+					_batch.push_back(_position.after(*it));
+				};
+				return _batch.count_legal_moves();
+			};
+
+			size_t _positions = 0;
+			for (auto it = _movesData.data(); it != _moves.head(); ++it)
+			{
+				const auto _undo = _board.make(*it);
+				_positions += perft_for<!C>(_board, _depth - 1, _batch);
+				_board.unmake(*it, _undo);
+			};
+			return _positions;
+		};
+	};
+
+	size_t perft(Board& _board, size_t _depth)
+	{
+		if (_depth == 0)
+		{
+			return 1;
+		};
+
+		auto _batch = BoardBatch();
+		if (_board.get_toplay() == Color::white)
+		{
+			return perft_for<Color::white>(_board, _depth, _batch);
+		}
+		else
+		{
+			return perft_for<Color::black>(_board, _depth, _batch);
+		};
+	};
+
+	std::vector<std::pair<Move, size_t>> perft_divide(Board& _board, size_t _depth)
+	{
+		auto o = std::vector<std::pair<Move, size_t>>{};
+		for (const auto& _move : get_moves(_board, _board.get_toplay()))
+		{
+			const auto _undo = _board.make(_move);
+			o.push_back({ _move, perft(_board, _depth) });
+			_board.unmake(_move, _undo);
+		};
+		return o;
+	};
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+/** @file */
+
+#include "board.hpp"
+#include "piece.hpp"
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace chess
+{
+	/**
+	 * @brief Counts the positions reachable from a board in exactly a number of plies.
+	 *
+	 * Moves are played with make/unmake so no move tree is built. The last two plies are counted with
+	 * batched move generation : the replies to each move are built straight from the bitboards and
+	 * their legal moves counted several boards at a time.
+	 *
+	 * @param _board Board to count from, it is restored before returning.
+	 * @param _depth Number of plies to play.
+	 * @return Number of positions, 1 if depth is 0.
+	*/
+	size_t perft(Board& _board, size_t _depth);
+
+	/**
+	 * @brief Counts the positions reachable after each legal move on a board, see perft().
+	 * @param _board Board to count from, it is restored before returning.
+	 * @param _depth Number of plies to play after each move.
+	 * @return Each legal move along with the number of positions reachable after it.
+	*/
+	std::vector<std::pair<Move, size_t>> perft_divide(Board& _board, size_t _depth);
+};
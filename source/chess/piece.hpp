@@ -57,6 +57,9 @@ namespace chess
 
 	/**
 	 * @brief Represents a movement of a piece by a player.
+	 *
+	 * Packed into 16 bits : bits 0-5 hold the from position and bits 6-11 hold the to position.
+	 * The top 4 bits are left for Move to store its promotion and flags in.
 	*/
 	class PieceMove
 	{
@@ -65,12 +68,18 @@ namespace chess
 		/**
 		 * @brief Gets the position the piece moved from.
 		*/
-		constexpr Position from() const noexcept { return this->from_; };
+		constexpr Position from() const noexcept
+		{
+			return Position::from_bits(static_cast<uint8_t>(this->bits_ & position_mask_v));
+		};
 
 		/**
 		 * @brief Gets the position the piece moved to.
 		*/
-		constexpr Position to() const noexcept { return this->to_; };
+		constexpr Position to() const noexcept
+		{
+			return Position::from_bits(static_cast<uint8_t>((this->bits_ >> to_shift_v) & position_mask_v));
+		};
 
 		/**
 		 * @brief Checks if null.
@@ -78,7 +87,7 @@ namespace chess
 		*/
 		constexpr bool is_null() const noexcept
 		{
-			return this->from() == this->to();
+			return ((this->bits_ ^ (this->bits_ >> to_shift_v)) & position_mask_v) == 0;
 		};
 
 		/**
@@ -110,7 +119,7 @@ namespace chess
 		constexpr PieceMove() = default;
 		
 		constexpr PieceMove(Position _from, Position _to) :
-			from_(_from), to_(_to)
+			bits_(static_cast<uint16_t>(static_cast<uint16_t>(_from) | (static_cast<uint16_t>(_to) << to_shift_v)))
 		{};
 
 		/**
@@ -118,7 +127,7 @@ namespace chess
 		 * @param nt jclib null tag type.
 		*/
 		constexpr PieceMove(jc::null_t nt) noexcept :
-			from_{}, to_{}
+			bits_(0)
 		{};
 
 		/**
@@ -128,21 +137,25 @@ namespace chess
 		*/
 		constexpr PieceMove& operator=(jc::null_t nt) noexcept
 		{
-			this->to_ = this->from_;
+			const auto _from = this->bits_ & position_mask_v;
+			this->bits_ = static_cast<uint16_t>((this->bits_ & ~squares_mask_v) | _from | (_from << to_shift_v));
 			return *this;
 		};
 
-	private:
+	protected:
+
+		constexpr static uint16_t position_mask_v = 0b111111;
+		constexpr static uint16_t to_shift_v = 6;
 
 		/**
-		 * @brief The position the piece moved from.
+		 * @brief Mask for the from and to position bits.
 		*/
-		Position from_;
+		constexpr static uint16_t squares_mask_v = 0x0FFF;
 
 		/**
-		 * @brief The position the piece moved to.
+		 * @brief The packed move, see the class description for the layout.
 		*/
-		Position to_;
+		uint16_t bits_ = 0;
 	};
 
 	/**
@@ -197,41 +210,103 @@ namespace chess
 
 	/**
 	 * @brief Holds a move from one position to another along with promotion info.
+	 *
+	 * Shares the 16 bit packing of PieceMove : bits 12-14 hold the promotion piece type and bit 15 is
+	 * set for castling and en passant moves. The two are told apart by castling staying on its rank.
+	 * The flag is only set by move generation and is ignored when comparing moves, so a move parsed
+	 * from a string still compares equal to the generated one.
 	*/
 	class Move : public PieceMove
 	{
+	private:
+
+		constexpr static uint16_t promotion_shift_v = 12;
+		constexpr static uint16_t promotion_mask_v = 0b111 << promotion_shift_v;
+		constexpr static uint16_t special_bit_v = 1 << 15;
+
 	public:
 
 		constexpr bool operator==(const Move& rhs) const noexcept
 		{
 			auto& lhs = *this;
-			return lhs.from() == rhs.from() && lhs.to() == rhs.to() && lhs.promotion() == rhs.promotion();
+			return ((lhs.bits_ ^ rhs.bits_) & ~special_bit_v) == 0;
 		};
 		constexpr bool operator!=(const Move& rhs) const noexcept
 		{
 			auto& lhs = *this;
-			return lhs.from() != rhs.from() || lhs.to() != rhs.to() || lhs.promotion() != rhs.promotion();
+			return ((lhs.bits_ ^ rhs.bits_) & ~special_bit_v) != 0;
 		};
 
 
 		constexpr PieceType promotion() const
 		{
-			return this->promotion_;
+			return PieceType((this->bits_ & promotion_mask_v) >> promotion_shift_v);
+		};
+
+		/**
+		 * @brief Checks if this is a castling move, only known for generated moves.
+		*/
+		constexpr bool is_castle() const noexcept
+		{
+			return (this->bits_ & special_bit_v) && this->from().rank() == this->to().rank();
+		};
+
+		/**
+		 * @brief Checks if this is an en passant capture, only known for generated moves.
+		*/
+		constexpr bool is_en_passant() const noexcept
+		{
+			return (this->bits_ & special_bit_v) && this->from().rank() != this->to().rank();
+		};
+
+		/**
+		 * @brief Gets the packed 16 bit value of this move.
+		*/
+		constexpr uint16_t to_bits() const noexcept
+		{
+			return this->bits_;
+		};
+
+		/**
+		 * @brief Creates a move from its packed 16 bit value.
+		*/
+		constexpr static Move from_bits(uint16_t _bits) noexcept
+		{
+			auto _move = Move();
+			_move.bits_ = _bits;
+			return _move;
+		};
+
+		/**
+		 * @brief Creates a castling move, from and to are the king positions.
+		*/
+		constexpr static Move castle(Position _from, Position _to) noexcept
+		{
+			return from_bits(Move(_from, _to).bits_ | special_bit_v);
+		};
+
+		/**
+		 * @brief Creates an en passant capture.
+		*/
+		constexpr static Move en_passant(Position _from, Position _to) noexcept
+		{
+			return from_bits(Move(_from, _to).bits_ | special_bit_v);
 		};
 
 		constexpr Move() = default;
 		constexpr Move(PieceMove _move) :
-			PieceMove(_move), promotion_(PieceType::queen)
+			Move(_move.from(), _move.to(), PieceType::queen)
 		{};
 		constexpr Move(PieceMove _move, PieceType _promotion) :
-			PieceMove(_move), promotion_(_promotion)
+			Move(_move.from(), _move.to(), _promotion)
 		{};
 		constexpr Move(Position _from, Position _to, PieceType _promotion) :
-			PieceMove(_from, _to),
-			promotion_{ _promotion }
-		{};
+			PieceMove(_from, _to)
+		{
+			this->bits_ |= static_cast<uint16_t>(jc::to_underlying(_promotion) << promotion_shift_v);
+		};
 		constexpr Move(Position _from, Position _to) :
-			Move(_from, _to, PieceType{})
+			PieceMove(_from, _to)
 		{};
 
 		/**
@@ -239,7 +314,7 @@ namespace chess
 		 * @param nt jclib null tag type.
 		*/
 		constexpr Move(jc::null_t nt) noexcept :
-			PieceMove(nt), promotion_{}
+			PieceMove(nt)
 		{};
 
 		/**
@@ -255,10 +330,10 @@ namespace chess
 
 	private:
 		using PieceMove::PieceMove;
-
-		PieceType promotion_;
 	};
 
+	static_assert(sizeof(Move) == sizeof(uint16_t));
+
 	/**
 	 * @brief Parses a move value from a string.
 	 *
@@ -4,6 +4,7 @@
 
 #include "bitboard.hpp"
 #include "board.hpp"
+#include "sliding.hpp"
 
 
 #include <array>
@@ -12,9 +13,9 @@
 namespace chess
 {
 
-	consteval BitBoardCX compute_pawn_attack_squares(Position _pos, Color _color)
+	consteval BitBoard compute_pawn_attack_squares(Position _pos, Color _color)
 	{
-		auto bb = BitBoardCX();
+		auto bb = BitBoard();
 		if (_pos.file() != File::a)
 		{
 			if (_color == Color::white)
@@ -41,11 +42,14 @@ namespace chess
 	};
 	consteval auto compute_pawn_attack_squares(Color _color)
 	{
-		std::array<BitBoardCX, 64> bbs{};
+		std::array<BitBoard, 64> bbs{};
 		auto it = bbs.begin();
 		for (auto& v : positions_v)
 		{
-			if (v.rank() == Rank::r1 || v.rank() == Rank::r8)
+			// Only skip the rank the pawn would attack off the board from, the first rank entries
+			// are used for reverse lookups (which enemy pawns could attack this square).
+			if ((_color == Color::white && v.rank() == Rank::r8) ||
+				(_color == Color::black && v.rank() == Rank::r1))
 			{
 				++it;
 				continue;
@@ -74,30 +78,142 @@ namespace chess
 
 
 
+	consteval BitBoard compute_knight_attack_squares(Position _pos)
+	{
+		auto bb = BitBoard();
+		constexpr auto _deltaPairs = std::array
+		{
+			std::pair{ 1, 2 },
+			std::pair{ 1, -2 },
+
+			std::pair{ 2, 1 },
+			std::pair{ 2, -1 },
+
+			std::pair{ -1, 2 },
+			std::pair{ -1, -2 },
+
+			std::pair{ -2, -1 },
+			std::pair{ -2, 1 },
+		};
+
+		bool _possible = false;
+		Position _nextPos{};
+		for (const auto& [df, dr] : _deltaPairs)
+		{
+			_nextPos = trynext(_pos, df, dr, _possible);
+			if (_possible)
+			{
+				bb.set(_nextPos);
+			};
+		};
+
+		return bb;
+	};
+	consteval auto compute_knight_attack_squares()
+	{
+		std::array<BitBoard, 64> bbs{};
+		for (auto& v : positions_v)
+		{
+			bbs[static_cast<size_t>(v)] = compute_knight_attack_squares(v);
+		};
+		return bbs;
+	};
+
+	// Precompute attack squares
+	constexpr inline auto knight_attack_squares_v = compute_knight_attack_squares();
+	constexpr inline auto get_knight_attack_squares(Position _pos)
+	{
+		return knight_attack_squares_v[static_cast<size_t>(_pos)];
+	};
+
+	consteval BitBoard compute_king_attack_squares(Position _pos)
+	{
+		auto bb = BitBoard();
+		for (int df = -1; df <= 1; ++df)
+		{
+			for (int dr = -1; dr <= 1; ++dr)
+			{
+				bool _possible = false;
+				const auto _nextPos = trynext(_pos, df, dr, _possible);
+				if (_possible && (df != 0 || dr != 0))
+				{
+					bb.set(_nextPos);
+				};
+			};
+		};
+		return bb;
+	};
+	consteval auto compute_king_attack_squares()
+	{
+		std::array<BitBoard, 64> bbs{};
+		for (auto& v : positions_v)
+		{
+			bbs[static_cast<size_t>(v)] = compute_king_attack_squares(v);
+		};
+		return bbs;
+	};
+
+	// Precompute attack squares
+	constexpr inline auto king_attack_squares_v = compute_king_attack_squares();
+	constexpr inline auto get_king_attack_squares(Position _pos)
+	{
+		return king_attack_squares_v[static_cast<size_t>(_pos)];
+	};
+
+	/**
+	 * @brief Gets the squares a piece attacks.
+	 * @param _piece Attacking piece.
+	 * @param _pos Position of the attacking piece.
+	 * @param _occupied Occupied squares, these block sliding pieces.
+	 * @return Attacked squares, this may include friendly pieces.
+	*/
+	inline BitBoard get_piece_attacks(Piece _piece, Position _pos, BitBoard _occupied)
+	{
+		switch (_piece.type())
+		{
+		case PieceType::pawn:
+			return get_pawn_attacking_squares(_pos, _piece.color());
+		case PieceType::knight:
+			return get_knight_attack_squares(_pos);
+		case PieceType::bishop:
+			return get_bishop_attacks(_pos, _occupied);
+		case PieceType::rook:
+			return get_rook_attacks(_pos, _occupied);
+		case PieceType::queen:
+			return get_queen_attacks(_pos, _occupied);
+		case PieceType::king:
+			return get_king_attack_squares(_pos);
+		default:
+			return BitBoard();
+		};
+	};
+
+
+
 
 
 
-	constexpr BitBoardCX make_rank_bits(Rank _rank)
+	constexpr BitBoard make_rank_bits(Rank _rank)
 	{
-		auto bb = BitBoardCX();
+		auto bb = BitBoard();
 		for (auto& v : files_v)
 		{
 			bb.set(v, _rank);
 		};
 		return bb;
 	};
-	constexpr BitBoardCX make_file_bits(File _file)
+	constexpr BitBoard make_file_bits(File _file)
 	{
-		auto bb = BitBoardCX();
+		auto bb = BitBoard();
 		for (auto& v : ranks_v)
 		{
 			bb.set(_file, v);
 		};
 		return bb;
 	};
-	constexpr BitBoardCX make_file_bits(File _file, Rank _min, Rank _max)
+	constexpr BitBoard make_file_bits(File _file, Rank _min, Rank _max)
 	{
-		auto bb = BitBoardCX();
+		auto bb = BitBoard();
 		for (Rank r = _min; r <= _max; r += 1)
 		{
 			bb.set(_file, r);
@@ -105,9 +221,9 @@ namespace chess
 		return bb;
 	};
 
-	constexpr BitBoardCX make_bits_in_direction(Position _startPos, int df, int dr)
+	constexpr BitBoard make_bits_in_direction(Position _startPos, int df, int dr)
 	{
-		auto bb = BitBoardCX();
+		auto bb = BitBoard();
 
 		bool _possible = false;
 		auto _nextPos = trynext(_startPos, df, dr, _possible);
@@ -118,9 +234,9 @@ namespace chess
 		};
 		return bb;
 	};
-	constexpr BitBoardCX make_diagonal_bits(Position _pos)
+	constexpr BitBoard make_diagonal_bits(Position _pos)
 	{
-		auto bb = BitBoardCX();
+		auto bb = BitBoard();
 		const auto _directions = std::array
 		{
 			std::pair{ 1, 1 },
@@ -0,0 +1,442 @@
+#include "search.hpp"
+
+#include "move_picker.hpp"
+
+#include <cmath>
+#include <span>
+#include <limits>
+#include <algorithm>
+
+namespace chess
+{
+	/**
+	 * @brief Margin added to a capture's gain before delta pruning it, covers the positional swing a capture can bring.
+	*/
+	constexpr inline Rating quiescence_delta_margin_v = 2.0f;
+
+	/**
+	 * @brief Plies the quiescence search may go below a leaf, only reached by long chains of checks.
+	*/
+	constexpr inline uint8_t max_quiescence_depth_v = 16;
+
+
+	Rating quiescence(Board& _board, Rating _alpha, Rating _beta, Rating _standPat,
+		SearchStop* _stop, uint8_t _ply)
+	{
+		if (_stop && _stop->poll())
+		{
+			return Rating(0);
+		};
+
+		const auto _player = _board.get_toplay();
+		const auto _inCheck = is_check(_board, _player);
+
+		// Mates and stalemates are already scored by the static rating, there is nothing left to search
+		auto _best = (_inCheck) ? -std::numeric_limits<Rating>::infinity() : _standPat;
+		if (!std::isfinite(_standPat) || _ply >= max_quiescence_depth_v)
+		{
+			return _standPat;
+		};
+		if (_best >= _beta)
+		{
+			return _best;
+		};
+		_alpha = std::max(_alpha, _best);
+
+		auto _picker = MovePicker(_board, (_inCheck) ? GenType::evasions : GenType::captures);
+		for (auto _move = _picker.next(); _move; _move = _picker.next())
+		{
+			// Losing captures come last, standing pat is at least as good as any of them
+			if (!_inCheck && _picker.stage() == MovePicker::Stage::bad_captures)
+			{
+				break;
+			};
+
+			// Delta pruning
+			if (!_inCheck && _move.promotion() == PieceType::none)
+			{
+				const auto _victim = (_move.is_en_passant()) ? PieceType::pawn : _board.get(_move.to()).type();
+				if (_victim != PieceType::none &&
+					_standPat + material_value(_victim) + quiescence_delta_margin_v <= _alpha)
+				{
+					continue;
+				};
+			};
+
+			const auto _undo = _board.make(_move);
+			const auto _score = -quiescence(_board, -_beta, -_alpha, quick_rate(_board, !_player), _stop, _ply + 1);
+			_board.unmake(_move, _undo);
+
+			if (_score > _best)
+			{
+				_best = _score;
+				if (_best >= _beta)
+				{
+					break;
+				};
+				_alpha = std::max(_alpha, _best);
+			};
+		};
+		return _best;
+	};
+
+	Rating Search::search_move(Rating _alpha, Rating _beta, int _depthLeft, size_t _ply, bool _isFirst, int _reduction)
+	{
+		// The response is searched from its own side's view
+		const auto _search = [&](Rating _moveAlpha, Rating _moveBeta, int _plies = 0)
+		{
+			return -this->negamax(-_moveBeta, -_moveAlpha, std::max(_depthLeft - 1 - _plies, 1), _ply + 1, true);
+		};
+
+		// There is nothing to prove against an unbounded alpha
+		if (_isFirst || !std::isfinite(_alpha))
+		{
+			return _search(_alpha, _beta);
+		};
+
+		// Window just past alpha, cutoffs are strict so the next representable rating is needed
+		const auto _nullBeta = std::nextafter(_alpha, std::numeric_limits<Rating>::infinity());
+
+		// A rating beyond beta cuts off anyway and needs no exact score
+		const auto _beatsBound = [&](Rating _value)
+		{
+			return _value > _alpha && _value <= _beta;
+		};
+		const auto _stopped = [this]()
+		{
+			return this->stop_ && this->stop_->stopped();
+		};
+		if (_reduction != 0)
+		{
+			const auto _value = _search(_alpha, _nullBeta, _reduction);
+			if (!_beatsBound(_value) || _stopped())
+			{
+				return _value;
+			};
+		};
+
+		const auto _value = _search(_alpha, _nullBeta);
+		if (!_beatsBound(_value) || _stopped())
+		{
+			return _value;
+		};
+		return _search(_alpha, _beta);
+	};
+
+	Rating Search::negamax(Rating _alpha, Rating _beta, int _depthLeft, size_t _ply, bool _allowNullMove)
+	{
+		constexpr auto infinity_v = std::numeric_limits<Rating>::infinity();
+
+		auto& _board = this->board_;
+		++this->nodes_;
+		this->pv_length_[_ply] = _ply;
+
+		// Quick ratings are for the player that just moved, the search's are for the side to move
+		const auto _player = _board.get_toplay();
+		const auto _staticRating = -quick_rate(_board, !_player);
+
+		if (_depthLeft <= 1 || _ply + 1 >= max_ply_v)
+		{
+			if (!this->profile_.quiescence_)
+			{
+				return _staticRating;
+			};
+			return quiescence(_board, _alpha, _beta, _staticRating, this->stop_);
+		};
+
+		if (this->stop_ && this->stop_->poll())
+		{
+			return Rating(0);
+		};
+
+		const auto _hash = _board.get_hash();
+		auto _hashMove = Move();
+		if (const auto _entry = (this->tt_) ? this->tt_->probe(_hash) : std::nullopt; _entry)
+		{
+			_hashMove = _entry->move_;
+
+			// Never cut at the root, it needs a move to play
+			if (_ply != 0 && _entry->depth_ >= _depthLeft)
+			{
+				if (_entry->bound_ == Bound::exact ||
+					(_entry->bound_ == Bound::lower && _entry->score_ > _beta) ||
+					(_entry->bound_ == Bound::upper && _entry->score_ < _alpha))
+				{
+					return _entry->score_;
+				};
+			};
+		};
+
+		// Selective search only happens in nodes searched with a null window, the root and the principal
+		// variation are searched in full
+		const auto& _profile = this->profile_;
+		const auto _pliesLeft = _depthLeft - 1;
+		const bool _inCheck = is_check(_board, _player);
+		const bool _isNullWindow = _beta <= std::nextafter(_alpha, infinity_v);
+		const bool _canPrune = _profile.enable_pruning_ && _ply != 0 && _isNullWindow &&
+			!_inCheck && std::isfinite(_staticRating);
+
+		// Reverse futility, far enough above beta that no move is expected to bring the rating back down
+		if (_canPrune && _profile.futility_pruning_ && _pliesLeft <= reverse_futility_max_plies_v)
+		{
+			const auto _margin = futility_margin_v * static_cast<Rating>(_pliesLeft);
+			if (_staticRating - _margin > _beta)
+			{
+				return _staticRating - _margin;
+			};
+		};
+
+		// Null move, if passing the turn still fails high then a real move surely would. Never twice in a row
+		// and never with only pawns left, where passing is often the best move there is.
+		if (_canPrune && _profile.null_move_pruning_ && _allowNullMove && _board.get_last_move() &&
+			_pliesLeft >= null_move_min_plies_v && _staticRating > _beta)
+		{
+			const auto _pieces = non_pawn_piece_count(_board, _player);
+			if (_pieces != 0)
+			{
+				const auto _reduction = null_move_reduction_v + (_pliesLeft >= 6);
+
+				// Null window just past beta. The position is not added to the history, nothing after a
+				// null move can really repeat it.
+				const auto _undo = _board.make_null();
+				auto _value = -this->negamax(-std::nextafter(_beta, infinity_v), -_beta,
+					std::max(_depthLeft - 1 - _reduction, 1), _ply + 1, true);
+				_board.unmake_null(_undo);
+				if (this->stop_ && this->stop_->stopped())
+				{
+					return Rating(0);
+				};
+
+				// Zugzwang is likely with so few pieces, make sure a normal search agrees
+				if (_value > _beta && _pieces <= null_move_verify_max_pieces_v)
+				{
+					_value = this->negamax(_alpha, _beta, std::max(_depthLeft - _reduction, 1), _ply, false);
+					if (this->stop_ && this->stop_->stopped())
+					{
+						return Rating(0);
+					};
+				};
+
+				// A mate found after passing is not a mate the opponent can be forced into
+				if (_value > _beta)
+				{
+					return (std::isfinite(_value)) ? _value : _beta;
+				};
+				this->pv_length_[_ply] = _ply;
+			};
+		};
+
+		// Quiet moves that cut off are remembered to order quiet moves in the rest of the search
+		auto& _heuristics = (this->heuristics_) ? *this->heuristics_ : *this->own_heuristics_;
+		const auto _previousMove = _board.get_last_move();
+		auto _picker = MovePicker(_board, _hashMove, _heuristics, _ply, _previousMove);
+
+		auto _triedQuiets = std::array<Move, 64>{};
+		size_t _triedQuietCount = 0;
+		const auto _isQuiet = [&](Move _move)
+		{
+			return _move.promotion() == PieceType::none && !is_piece_capture(_board, _move);
+		};
+
+		// Rating every futility pruned move is assumed to reach at most
+		const bool _canFutilityPrune = _canPrune && _profile.futility_pruning_ && _pliesLeft <= futility_max_plies_v &&
+			_staticRating + futility_margin_v * static_cast<Rating>(_pliesLeft) <= _alpha;
+		const auto _futilityRating = _staticRating + futility_margin_v * static_cast<Rating>(_pliesLeft);
+
+		// Decides how deep to search a move that was just made on the board, given how many moves came before it
+		// and the stage of the move picker it came from. Returns the plies to reduce it by, or null to skip it.
+		const auto _selectMove = [&](Move _move, bool _isQuietMove, size_t _index, MovePicker::Stage _stage)
+			-> std::optional<int>
+		{
+			// Captures, promotions and checks are always searched in full
+			if (_index == 0 || !_profile.enable_pruning_ || _inCheck || !_isQuietMove ||
+				is_check(_board, _board.get_toplay()))
+			{
+				return 0;
+			};
+			if (_canFutilityPrune)
+			{
+				return std::nullopt;
+			};
+
+			// Killers and the counter move are not reduced, other quiets less so when they have a good history
+			if (!_profile.late_move_reductions_ || _stage != MovePicker::Stage::quiets ||
+				_index < late_move_min_index_v || _pliesLeft < late_move_min_plies_v)
+			{
+				return 0;
+			};
+			int _reduction = 1 + (_index >= 8) + (_index >= 16 && _pliesLeft >= 6);
+			const auto _score = _heuristics.history(_player, _move);
+			if (_score > SearchHeuristics::max_history_v / 2)
+			{
+				--_reduction;
+			}
+			else if (_score < 0)
+			{
+				++_reduction;
+			};
+			return std::clamp(_reduction, 0, _pliesLeft - 1);
+		};
+
+		const auto _initialAlpha = _alpha;
+		auto _best = -infinity_v;
+		auto _bestMove = Move();
+		bool _cutoff = false;
+
+		size_t _index = 0;
+		for (auto _move = _picker.next(); _move; _move = _picker.next(), ++_index)
+		{
+			const bool _isFirst = !_bestMove;
+			const bool _isQuietMove = _isQuiet(_move);
+			this->history_.push(_board);
+			const auto _undo = _board.make(_move);
+			this->pv_length_[_ply + 1] = _ply + 1;
+
+			// Repeating a position or running out the fifty move clock ends the line as a draw
+			auto _score = std::optional<Rating>(Rating(0));
+			const auto _reduction = (_isFirst) ?
+				std::optional<int>(0) : _selectMove(_move, _isQuietMove, _index, _picker.stage());
+			if (!_reduction)
+			{
+				_score.reset();
+			}
+			else if (!this->history_.is_repetition(_board) &&
+				_board.get_half_move_count() < fifty_move_rule_half_moves_v)
+			{
+				_score = this->search_move(_alpha, _beta, _depthLeft, _ply, _isFirst, *_reduction);
+			};
+			_board.unmake(_move, _undo);
+			this->history_.pop();
+
+			if (this->stop_ && this->stop_->stopped())
+			{
+				break;
+			};
+			if (!_score)
+			{
+				_best = std::max(_best, _futilityRating);
+				continue;
+			};
+
+			if (*_score > _best || !_bestMove)
+			{
+				// The best line from here is this move followed by the best line from the response
+				_bestMove = _move;
+				auto& _line = this->pv_[_ply];
+				const auto& _responseLine = this->pv_[_ply + 1];
+				const auto _length = this->pv_length_[_ply + 1];
+				_line[_ply] = _move;
+				std::copy(_responseLine.begin() + _ply + 1, _responseLine.begin() + _length, _line.begin() + _ply + 1);
+				this->pv_length_[_ply] = _length;
+			};
+			_best = std::max(_best, *_score);
+
+			if (std::isfinite(*_score))
+			{
+				if (_best > _beta)
+				{
+					if (_isQuietMove)
+					{
+						_heuristics.update_cutoff(_player, _move, _ply, _previousMove,
+							std::span(_triedQuiets.data(), _triedQuietCount), _depthLeft);
+					};
+					_cutoff = true;
+					break;
+				};
+				_alpha = std::max(_alpha, _best);
+			};
+
+			if (_isQuietMove && _triedQuietCount != _triedQuiets.size())
+			{
+				_triedQuiets[_triedQuietCount++] = _move;
+			};
+		};
+
+		// Mates and stalemates are already scored by the static rating, the first move is never pruned so the
+		// picker only came up empty if there are no legal moves
+		if (_index == 0 && !_bestMove)
+		{
+			return _staticRating;
+		};
+
+		if (this->tt_ && std::isfinite(_best) && !(this->stop_ && this->stop_->stopped()))
+		{
+			const auto _bound = (_cutoff) ? Bound::lower :
+				(_best <= _initialAlpha) ? Bound::upper : Bound::exact;
+			this->tt_->store(_hash, _bestMove, _best, static_cast<uint8_t>(_depthLeft), _bound);
+		};
+		return _best;
+	};
+
+	SearchResult Search::run(const Board& _board, size_t _depth, const MoveTreeProfile& _profile)
+	{
+		constexpr auto infinity_v = std::numeric_limits<Rating>::infinity();
+
+		this->board_ = _board;
+		this->profile_ = _profile;
+		this->nodes_ = 0;
+		this->pv_length_[0] = 0;
+
+		// Searches given no tables learn their own
+		if (!this->heuristics_)
+		{
+			if (!this->own_heuristics_)
+			{
+				this->own_heuristics_ = std::make_unique<SearchHeuristics>();
+			}
+			else
+			{
+				this->own_heuristics_->clear();
+			};
+		};
+		// Mate ratings have nothing to centre a window on
+		auto _alpha = -infinity_v;
+		auto _beta = infinity_v;
+		auto _window = aspiration_window_v;
+		if (const auto& _expected = this->expected_rating_; _expected && std::isfinite(*_expected))
+		{
+			_alpha = *_expected - _window;
+			_beta = *_expected + _window;
+		};
+
+		auto _value = Rating(0);
+		while (true)
+		{
+			_value = this->negamax(_alpha, _beta, static_cast<int>(_depth), 0, true);
+			if (this->stop_ && this->stop_->stopped())
+			{
+				break;
+			};
+
+			// The root never cuts off early, a rating on or past a bound just means every move was
+			// only proven to be no better or no worse than it.
+			const bool _failedLow = _value <= _alpha && std::isfinite(_alpha);
+			const bool _failedHigh = _value >= _beta && std::isfinite(_beta);
+			if (!_failedLow && !_failedHigh)
+			{
+				break;
+			};
+
+			_window *= 4;
+			const bool _unbounded = _window > max_aspiration_window_v || !std::isfinite(_value);
+			if (_failedLow)
+			{
+				_alpha = (_unbounded) ? -infinity_v : _value - _window;
+			}
+			else
+			{
+				_beta = (_unbounded) ? infinity_v : _value + _window;
+			};
+		};
+
+		auto _result = SearchResult();
+		_result.nodes_ = this->nodes_;
+		if (this->pv_length_[0] != 0)
+		{
+			const auto& _line = this->pv_[0];
+			_result.best_move_ = RatedMove(_line[0], _value);
+			_result.line_.assign(_line.begin(), _line.begin() + this->pv_length_[0]);
+		};
+		return _result;
+	};
+};
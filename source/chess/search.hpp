@@ -0,0 +1,233 @@
+#pragma once
+
+/** @file */
+
+#include "move.hpp"
+#include "board.hpp"
+#include "rating.hpp"
+#include "history.hpp"
+#include "move_tree.hpp"
+#include "transposition.hpp"
+#include "search_stop.hpp"
+#include "search_heuristics.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+
+namespace chess
+{
+	/**
+	 * @brief Distance either side of the expected rating, in pawns, the first aspiration window at the root spans.
+	*/
+	constexpr inline Rating aspiration_window_v = 0.25f;
+
+	/**
+	 * @brief Widest aspiration window tried before falling back to searching the root with an unbounded window.
+	*/
+	constexpr inline Rating max_aspiration_window_v = 4.0f;
+
+	/**
+	 * @brief Plies the search after a null move is shortened by, one more far from the leaves.
+	*/
+	constexpr inline uint8_t null_move_reduction_v = 2;
+
+	/**
+	 * @brief Fewest plies left below a node for it to try a null move.
+	*/
+	constexpr inline uint8_t null_move_min_plies_v = 3;
+
+	/**
+	 * @brief Most pieces besides pawns and the king the side to move can have for a null move cutoff to need verifying.
+	*/
+	constexpr inline int null_move_verify_max_pieces_v = 1;
+
+	/**
+	 * @brief Margin per ply left, in pawns, the static rating must miss alpha or clear beta by to prune on it.
+	*/
+	constexpr inline Rating futility_margin_v = 1.0f;
+
+	/**
+	 * @brief Most plies left below a node for its quiet moves to be futility pruned.
+	*/
+	constexpr inline uint8_t futility_max_plies_v = 2;
+
+	/**
+	 * @brief Most plies left below a node for it to be cut off on its static rating.
+	*/
+	constexpr inline uint8_t reverse_futility_max_plies_v = 3;
+
+	/**
+	 * @brief Moves searched at full depth in every node before late move reductions start.
+	*/
+	constexpr inline size_t late_move_min_index_v = 3;
+
+	/**
+	 * @brief Fewest plies left below a node for its moves to be reduced.
+	*/
+	constexpr inline uint8_t late_move_min_plies_v = 3;
+
+	/**
+	 * @brief Searches captures from a leaf until the position is quiet, so the leaf is not rated in the middle of an exchange.
+	 *
+	 * Fail-soft negamax without building any nodes. The side to move may stand pat on the static rating
+	 * instead of capturing, captures are tried most valuable victim first and ones that cannot bring the
+	 * score back up to alpha even with the whole captured piece are skipped. Captures that lose material
+	 * by static exchange evaluation are never searched. In check every evasion is searched as standing
+	 * pat is not an option.
+	 *
+	 * @param _board Board to search from, restored before returning.
+	 * @param _alpha Lower bound for the side to move.
+	 * @param _beta Upper bound for the side to move.
+	 * @param _standPat Static rating for the side to move.
+	 * @param _stop Polled at each position, may be null.
+	 * @param _ply Plies searched below the leaf.
+	 * @return Rating for the side to move.
+	*/
+	Rating quiescence(Board& _board, Rating _alpha, Rating _beta, Rating _standPat,
+		SearchStop* _stop, uint8_t _ply = 0);
+
+	/**
+	 * @brief Counts a player's pieces other than pawns and the king.
+	*/
+	inline int non_pawn_piece_count(const Board& _board, Color _player)
+	{
+		return _board.get_piece_bitboard(PieceType::knight, _player).count() +
+			_board.get_piece_bitboard(PieceType::bishop, _player).count() +
+			_board.get_piece_bitboard(PieceType::rook, _player).count() +
+			_board.get_piece_bitboard(PieceType::queen, _player).count();
+	};
+
+
+
+	/**
+	 * @brief Result of searching a position to a depth.
+	*/
+	struct SearchResult
+	{
+		/**
+		 * @brief Best move with its rating for the side to move, null if there are no legal moves.
+		*/
+		std::optional<RatedMove> best_move_;
+
+		/**
+		 * @brief Line expected to be played from the position, starting with the best move.
+		*/
+		std::vector<Move> line_;
+
+		/**
+		 * @brief Number of positions the alpha-beta search visited, not counting the quiescence search.
+		*/
+		size_t nodes_ = 0;
+	};
+
+	/**
+	 * @brief Alpha-beta search that keeps no tree, only a fixed amount of state per ply.
+	 *
+	 * Searches exactly like a MoveTree built with alpha-beta on one thread : negamax with principal variation
+	 * search, aspiration windows at the root, quiescence at the leaves and the same selective search. The
+	 * moves of each ply live in a MovePicker on the call stack, transpositions come from the table and the best
+	 * line is kept in a triangular table indexed by ply, so memory use does not grow with the depth or with
+	 * the number of positions searched. One search can be reused for every depth and move of a game.
+	*/
+	class Search
+	{
+	public:
+
+		/**
+		 * @brief Deepest ply the search keeps a line for, nodes at it are rated as leaves.
+		*/
+		constexpr static size_t max_ply_v = SearchHeuristics::max_ply_v;
+
+		/**
+		 * @brief Sets the positions played before the searched one, used to find repetitions.
+		*/
+		void set_history(const PositionHistory& _history)
+		{
+			this->history_ = _history;
+		};
+
+		/**
+		 * @brief Sets the transposition table to probe and fill, may be null.
+		*/
+		void set_transposition_table(TranspositionTable* _tt) noexcept
+		{
+			this->tt_ = _tt;
+		};
+
+		/**
+		 * @brief Sets the stop polled at each position, may be null. Once stopped the result is meaningless.
+		*/
+		void set_search_stop(SearchStop* _stop) noexcept
+		{
+			this->stop_ = _stop;
+		};
+
+		/**
+		 * @brief Sets the move ordering tables to use and update, null to learn a fresh set each search.
+		*/
+		void set_search_heuristics(SearchHeuristics* _heuristics) noexcept
+		{
+			this->heuristics_ = _heuristics;
+		};
+
+		/**
+		 * @brief Sets the rating the root is expected to have, its aspiration window is centred on it.
+		 * @param _rating Expected rating for the side to move, null to search the root with an unbounded window.
+		*/
+		void set_expected_rating(std::optional<Rating> _rating) noexcept
+		{
+			this->expected_rating_ = _rating;
+		};
+
+		/**
+		 * @brief Searches a position.
+		 * @param _board Position to search.
+		 * @param _depth Depth to search, counted like the maximum depth of MoveTree::build_tree().
+		 * @param _profile Search settings, the ones only meaning anything to a tree are ignored.
+		 * @return Best move and line found.
+		*/
+		SearchResult run(const Board& _board, size_t _depth, const MoveTreeProfile& _profile = MoveTreeProfile());
+
+		Search() = default;
+		Search(const Search&) = delete;
+		Search& operator=(const Search&) = delete;
+
+	private:
+
+		/**
+		 * @brief Searches the working board, fail-soft negamax.
+		 * @param _alpha Lower bound for the side to move.
+		 * @param _beta Upper bound for the side to move.
+		 * @param _depthLeft Plies left to search including this one, 1 or less rates the board as a leaf.
+		 * @param _ply Plies from the root.
+		 * @param _allowNullMove False right after a null move or while verifying one.
+		 * @return Rating for the side to move.
+		*/
+		Rating negamax(Rating _alpha, Rating _beta, int _depthLeft, size_t _ply, bool _allowNullMove);
+
+		/**
+		 * @brief Searches a move that was just made on the working board, with a null window first unless it
+		 * is the first move. Reduced moves are first searched with a null window at the reduced depth.
+		 * @return Rating for the side that made the move.
+		*/
+		Rating search_move(Rating _alpha, Rating _beta, int _depthLeft, size_t _ply, bool _isFirst, int _reduction);
+
+		Board board_{};
+		PositionHistory history_{};
+		MoveTreeProfile profile_{};
+		TranspositionTable* tt_ = nullptr;
+		SearchStop* stop_ = nullptr;
+		SearchHeuristics* heuristics_ = nullptr;
+		std::unique_ptr<SearchHeuristics> own_heuristics_{};
+		std::optional<Rating> expected_rating_{};
+		size_t nodes_ = 0;
+
+		// Triangular table, row n holds the best line found from ply n onwards
+		std::array<std::array<Move, max_ply_v>, max_ply_v> pv_{};
+		std::array<size_t, max_ply_v> pv_length_{};
+	};
+};
@@ -0,0 +1,89 @@
+#include "search_heuristics.hpp"
+
+#include <random>
+#include <algorithm>
+
+namespace chess
+{
+	std::array<Move, SearchHeuristics::killer_count_v> SearchHeuristics::killers(size_t _ply) const noexcept
+	{
+		auto _killers = std::array<Move, killer_count_v>{};
+		if (_ply < max_ply_v)
+		{
+			for (size_t n = 0; n != killer_count_v; ++n)
+			{
+				_killers[n] = Move::from_bits(this->killers_[_ply][n].load(std::memory_order_relaxed));
+			};
+		};
+		return _killers;
+	};
+
+	void SearchHeuristics::add_history(Color _player, Move _move, int _bonus) noexcept
+	{
+		// Scores close to the limit move less, this keeps them in range and lets newer cutoffs win out
+		auto& _entry = this->history_[history_index(_player, _move)];
+		const int _old = _entry.load(std::memory_order_relaxed);
+		const int _new = _old + _bonus - (_old * std::abs(_bonus)) / max_history_v;
+		_entry.store(static_cast<int16_t>(std::clamp<int>(_new, -max_history_v, max_history_v)),
+			std::memory_order_relaxed);
+	};
+
+	void SearchHeuristics::update_cutoff(Color _player, Move _move, size_t _ply, Move _previous,
+		std::span<const Move> _triedQuiets, int _depthLeft) noexcept
+	{
+		// Newest killer first, without repeating one already stored
+		if (_ply < max_ply_v)
+		{
+			auto& _killers = this->killers_[_ply];
+			const auto _bits = _move.to_bits();
+			if (_killers[0].load(std::memory_order_relaxed) != _bits)
+			{
+				_killers[1].store(_killers[0].load(std::memory_order_relaxed), std::memory_order_relaxed);
+				_killers[0].store(_bits, std::memory_order_relaxed);
+			};
+		};
+
+		const auto _bonus = std::min(_depthLeft * _depthLeft, static_cast<int>(max_history_v) / 8);
+		this->add_history(_player, _move, _bonus);
+		for (const auto& _tried : _triedQuiets)
+		{
+			this->add_history(_player, _tried, -_bonus);
+		};
+
+		if (_previous)
+		{
+			this->counters_[butterfly_index(_previous)].store(_move.to_bits(), std::memory_order_relaxed);
+		};
+	};
+
+	void SearchHeuristics::clear() noexcept
+	{
+		for (auto& _killers : this->killers_)
+		{
+			for (auto& _killer : _killers)
+			{
+				_killer.store(0, std::memory_order_relaxed);
+			};
+		};
+		for (auto& _entry : this->history_)
+		{
+			_entry.store(0, std::memory_order_relaxed);
+		};
+		for (auto& _counter : this->counters_)
+		{
+			_counter.store(0, std::memory_order_relaxed);
+		};
+	};
+
+	void SearchHeuristics::seed(uint32_t _seed) noexcept
+	{
+		this->clear();
+
+		auto _rnd = std::mt19937(_seed);
+		auto _dist = std::uniform_int_distribution<int>(-max_seed_history_v, max_seed_history_v);
+		for (auto& _entry : this->history_)
+		{
+			_entry.store(static_cast<int16_t>(_dist(_rnd)), std::memory_order_relaxed);
+		};
+	};
+};
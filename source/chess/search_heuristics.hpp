@@ -0,0 +1,125 @@
+#pragma once
+
+/** @file */
+
+#include "piece.hpp"
+
+#include <span>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace chess
+{
+	/**
+	 * @brief Move ordering tables learnt while searching, used to order quiet moves without rating them.
+	 *
+	 * Killers are the last two quiet moves that caused a cutoff at each ply, history scores every
+	 * quiet move by how often it caused cutoffs for a player anywhere in the tree and the counter
+	 * move is the quiet move that last refuted the previous move.
+	 *
+	 * Entries are relaxed atomics so threads splitting one search can share the tables, a lost
+	 * update only costs a little ordering quality.
+	*/
+	class SearchHeuristics
+	{
+	public:
+
+		/**
+		 * @brief Deepest ply killers are kept for.
+		*/
+		constexpr static size_t max_ply_v = 128;
+
+		/**
+		 * @brief Number of killers kept per ply.
+		*/
+		constexpr static size_t killer_count_v = 2;
+
+		/**
+		 * @brief Largest magnitude a history score reaches, fits the move picker's scores.
+		*/
+		constexpr static int16_t max_history_v = 16000;
+
+		/**
+		 * @brief Largest magnitude of the random history scores given by seed().
+		*/
+		constexpr static int16_t max_seed_history_v = max_history_v / 32;
+
+		/**
+		 * @brief Gets the killer moves for a ply, null moves if there are none.
+		*/
+		std::array<Move, killer_count_v> killers(size_t _ply) const noexcept;
+
+		/**
+		 * @brief Gets the quiet move that last refuted a move, null if there is none.
+		*/
+		Move counter_move(Move _previous) const noexcept
+		{
+			return Move::from_bits(this->counters_[butterfly_index(_previous)].load(std::memory_order_relaxed));
+		};
+
+		/**
+		 * @brief Gets the history score of a quiet move.
+		*/
+		int16_t history(Color _player, Move _move) const noexcept
+		{
+			return this->history_[history_index(_player, _move)].load(std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Records a quiet move causing a beta cutoff.
+		 * @param _player Player that played the move.
+		 * @param _move Move that caused the cutoff.
+		 * @param _ply Plies from the root to the position the move was played in.
+		 * @param _previous Move that led to the position, may be null.
+		 * @param _triedQuiets Quiet moves searched before it that did not cut off, their history is lowered.
+		 * @param _depthLeft Plies that were left to search, deeper cutoffs count for more.
+		*/
+		void update_cutoff(Color _player, Move _move, size_t _ply, Move _previous,
+			std::span<const Move> _triedQuiets, int _depthLeft) noexcept;
+
+		/**
+		 * @brief Forgets everything learnt.
+		*/
+		void clear() noexcept;
+
+		/**
+		 * @brief Forgets everything learnt and starts the history from small random scores.
+		 *
+		 * Searches of the same position given different seeds try their quiet moves in different orders
+		 * until real cutoffs outweigh the noise, which keeps parallel searches from repeating each other.
+		 *
+		 * @param _seed Seed for the random scores.
+		*/
+		void seed(uint32_t _seed) noexcept;
+
+		SearchHeuristics() = default;
+		SearchHeuristics(const SearchHeuristics&) = delete;
+		SearchHeuristics& operator=(const SearchHeuristics&) = delete;
+
+	private:
+
+		static size_t butterfly_index(Move _move) noexcept
+		{
+			return static_cast<size_t>(_move.from()) * 64 + static_cast<size_t>(_move.to());
+		};
+		static size_t history_index(Color _player, Move _move) noexcept
+		{
+			return static_cast<size_t>(_player == Color::black) * 64 * 64 + butterfly_index(_move);
+		};
+
+		/**
+		 * @brief Moves the history score of a move towards the maximum by a bonus, or the minimum for a negative bonus.
+		*/
+		void add_history(Color _player, Move _move, int _bonus) noexcept;
+
+		std::array<std::array<std::atomic<uint16_t>, killer_count_v>, max_ply_v> killers_{};
+
+		// Indexed [colour][from][to]
+		std::array<std::atomic<int16_t>, 2 * 64 * 64> history_{};
+
+		// Indexed by the previous move's [from][to]
+		std::array<std::atomic<uint16_t>, 64 * 64> counters_{};
+	};
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+/** @file */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace chess
+{
+	/**
+	 * @brief Lets a running search be stopped, either by another thread or once a deadline passes.
+	 *
+	 * The search polls this at every node, the clock is only read every few thousand polls so a
+	 * deadline costs next to nothing. Once stopped the search unwinds and its result must be thrown away.
+	 *
+	 * A stop can be chained to a parent, it then also counts as stopped once the parent is. The
+	 * parallel search uses this to abandon the siblings of a move that caused a cutoff.
+	*/
+	class SearchStop
+	{
+	public:
+
+		using clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Tells the search to stop as soon as it can.
+		*/
+		void stop() noexcept
+		{
+			this->stopped_.store(true, std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Checks if the search was told to stop, does not look at the deadline.
+		*/
+		bool stopped() const noexcept
+		{
+			return this->stopped_.load(std::memory_order_relaxed) ||
+				(this->parent_ && this->parent_->stopped());
+		};
+
+		/**
+		 * @brief Sets the point in time after which the search stops, replacing any earlier deadline.
+		*/
+		void set_deadline(clock::time_point _deadline) noexcept
+		{
+			this->deadline_ = _deadline;
+		};
+
+		/**
+		 * @brief Checks if the search should stop, called by the search at every node.
+		 * @return True once stopped or past the deadline.
+		*/
+		bool poll() noexcept
+		{
+			if (this->stopped_.load(std::memory_order_relaxed) || (this->parent_ && this->parent_->poll()))
+			{
+				return true;
+			};
+			if (this->deadline_ &&
+				(this->polls_.fetch_add(1, std::memory_order_relaxed) & (polls_per_clock_read_v - 1)) == 0 &&
+				clock::now() >= *this->deadline_)
+			{
+				this->stop();
+				return true;
+			};
+			return false;
+		};
+
+		/**
+		 * @brief Clears the stop flag and deadline so the object can be used for another search.
+		*/
+		void reset() noexcept
+		{
+			this->stopped_.store(false, std::memory_order_relaxed);
+			this->deadline_.reset();
+			this->polls_.store(0, std::memory_order_relaxed);
+		};
+
+		SearchStop() = default;
+
+		/**
+		 * @brief Creates a stop that is also stopped once its parent is.
+		 * @param _parent Stop that must outlive this one, may be null.
+		*/
+		explicit SearchStop(SearchStop* _parent) noexcept :
+			parent_(_parent)
+		{};
+
+	private:
+
+		/**
+		 * @brief Number of polls between clock reads, must be a power of two.
+		*/
+		constexpr static uint32_t polls_per_clock_read_v = 1024;
+
+		std::atomic<bool> stopped_{ false };
+		std::atomic<uint32_t> polls_{ 0 };
+		std::optional<clock::time_point> deadline_{};
+		SearchStop* parent_ = nullptr;
+	};
+};
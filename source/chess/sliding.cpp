@@ -0,0 +1,240 @@
+#include "sliding.hpp"
+
+#include <bit>
+#include <array>
+
+namespace chess
+{
+	namespace
+	{
+		/**
+		 * @brief Total table size for all rook squares (sum of 2^popcount(mask)).
+		*/
+		constexpr size_t rook_attack_table_size_v = 102400;
+
+		/**
+		 * @brief Total table size for all bishop squares (sum of 2^popcount(mask)).
+		*/
+		constexpr size_t bishop_attack_table_size_v = 5248;
+
+		constexpr auto rook_directions_v = std::array
+		{
+			std::pair{  1,  0 },
+			std::pair{ -1,  0 },
+			std::pair{  0,  1 },
+			std::pair{  0, -1 },
+		};
+		constexpr auto bishop_directions_v = std::array
+		{
+			std::pair{  1,  1 },
+			std::pair{ -1,  1 },
+			std::pair{  1, -1 },
+			std::pair{ -1, -1 },
+		};
+
+		constexpr bool is_on_board(int f, int r)
+		{
+			return f >= 0 && f < 8 && r >= 0 && r < 8;
+		};
+		constexpr uint64_t position_bit(int f, int r)
+		{
+			return uint64_t(1) << ((f << 3) | r);
+		};
+
+		/**
+		 * @brief Gets the squares a sliding piece could be blocked on, the last square of each ray is left out
+		 * as a piece there cannot hide anything behind it.
+		*/
+		uint64_t compute_sliding_mask(Position _pos, bool _diagonal)
+		{
+			const auto& _directions = (_diagonal) ? bishop_directions_v : rook_directions_v;
+
+			uint64_t _mask = 0;
+			for (const auto& [df, dr] : _directions)
+			{
+				int f = jc::to_underlying(_pos.file()) + df;
+				int r = jc::to_underlying(_pos.rank()) + dr;
+				while (is_on_board(f + df, r + dr))
+				{
+					_mask |= position_bit(f, r);
+					f += df;
+					r += dr;
+				};
+			};
+			return _mask;
+		};
+
+		/**
+		 * @brief Small xorshift64* generator so the magic search is deterministic between runs.
+		*/
+		class MagicPRNG
+		{
+		public:
+
+			uint64_t next() noexcept
+			{
+				this->state_ ^= this->state_ >> 12;
+				this->state_ ^= this->state_ << 25;
+				this->state_ ^= this->state_ >> 27;
+				return this->state_ * 2685821657736338717ULL;
+			};
+
+			/**
+			 * @brief Gets a random value with roughly 1/8th of the bits set, these make for better magic candidates.
+			*/
+			uint64_t sparse() noexcept
+			{
+				return this->next() & this->next() & this->next();
+			};
+
+			constexpr explicit MagicPRNG(uint64_t _seed) noexcept :
+				state_(_seed)
+			{};
+
+		private:
+			uint64_t state_;
+		};
+
+		/**
+		 * @brief Magic search seeds for each file.
+		*/
+		constexpr auto magic_seeds_v = std::array<uint64_t, 8>
+		{
+			728, 10316, 55013, 32803, 12281, 15100, 16645, 255
+		};
+
+		/**
+		 * @brief Fills in the lookup data for one type of sliding piece.
+		 * @param _entries Per-square entries to fill.
+		 * @param _table Attack table shared by all squares, must have room for every square's entries.
+		 * @param _diagonal True for bishops, false for rooks.
+		*/
+		void init_sliding_attacks(std::array<impl::SlidingAttackEntry, 64>& _entries, uint64_t* _table, bool _diagonal)
+		{
+			// Largest blocker subset count for a single square (rook in a corner has 12 relevant bits).
+			constexpr size_t max_subsets_v = 4096;
+
+			auto _occupancies = std::array<uint64_t, max_subsets_v>{};
+			auto _references = std::array<uint64_t, max_subsets_v>{};
+
+			auto _tablePos = _table;
+
+			for (auto& _pos : positions_v)
+			{
+				auto& _entry = _entries[static_cast<size_t>(_pos)];
+				_entry.mask_ = compute_sliding_mask(_pos, _diagonal);
+				_entry.shift_ = 64 - std::popcount(_entry.mask_);
+				_entry.attacks_ = _tablePos;
+				_entry.magic_ = 0;
+
+				// Walk every subset of the mask (carry-rippler) and record the true attack set for each.
+				size_t _count = 0;
+				uint64_t _subset = 0;
+				do
+				{
+					_occupancies[_count] = _subset;
+					_references[_count] = compute_sliding_attacks_slow(_pos, BitBoard(_subset), _diagonal).to_uint64();
+					++_count;
+					_subset = (_subset - _entry.mask_) & _entry.mask_;
+				}
+				while (_subset != 0);
+
+#if SCREEPFISH_SLIDING_PEXT
+				for (size_t n = 0; n != _count; ++n)
+				{
+					_tablePos[_entry.index(_occupancies[n])] = _references[n];
+				};
+#else
+				// Seeds are picked per file as they have been found to give quick searches.
+				auto _rng = MagicPRNG(magic_seeds_v[jc::to_underlying(_pos.file())]);
+
+				// Slots written for the current magic candidate are tagged with its epoch.
+				auto _epochs = std::array<uint32_t, max_subsets_v>{};
+				uint32_t _epoch = 0;
+
+				// Search for a magic that maps every subset to a slot without a destructive collision.
+				bool _found = false;
+				while (!_found)
+				{
+					_entry.magic_ = _rng.sparse();
+					if (std::popcount((_entry.mask_ * _entry.magic_) >> 56) < 6)
+					{
+						continue;
+					};
+
+					++_epoch;
+					_found = true;
+					for (size_t n = 0; n != _count; ++n)
+					{
+						const auto _index = _entry.index(_occupancies[n]);
+						if (_epochs[_index] != _epoch)
+						{
+							_epochs[_index] = _epoch;
+							_tablePos[_index] = _references[n];
+						}
+						else if (_tablePos[_index] != _references[n])
+						{
+							_found = false;
+							break;
+						};
+					};
+				};
+#endif
+				_tablePos += _count;
+			};
+		};
+
+		alignas(64) std::array<uint64_t, rook_attack_table_size_v> rook_attack_table_v{};
+		alignas(64) std::array<uint64_t, bishop_attack_table_size_v> bishop_attack_table_v{};
+	};
+
+	namespace impl
+	{
+		std::array<SlidingAttackEntry, 64> rook_attack_entries_v{};
+		std::array<SlidingAttackEntry, 64> bishop_attack_entries_v{};
+	};
+
+	namespace
+	{
+		/**
+		 * @brief Builds the sliding attack tables during static initialization.
+		*/
+		struct SlidingAttackTableInit
+		{
+			SlidingAttackTableInit()
+			{
+				init_sliding_attacks(impl::rook_attack_entries_v, rook_attack_table_v.data(), false);
+				init_sliding_attacks(impl::bishop_attack_entries_v, bishop_attack_table_v.data(), true);
+			};
+		};
+		const SlidingAttackTableInit sliding_attack_table_init_v{};
+	};
+
+
+
+	BitBoard compute_sliding_attacks_slow(Position _pos, BitBoard _occupied, bool _diagonal)
+	{
+		const auto& _directions = (_diagonal) ? bishop_directions_v : rook_directions_v;
+		const auto _occupiedBits = _occupied.to_uint64();
+
+		uint64_t _attacks = 0;
+		for (const auto& [df, dr] : _directions)
+		{
+			int f = jc::to_underlying(_pos.file()) + df;
+			int r = jc::to_underlying(_pos.rank()) + dr;
+			while (is_on_board(f, r))
+			{
+				const auto _bit = position_bit(f, r);
+				_attacks |= _bit;
+				if (_occupiedBits & _bit)
+				{
+					break;
+				};
+				f += df;
+				r += dr;
+			};
+		};
+		return BitBoard(_attacks);
+	};
+
+};
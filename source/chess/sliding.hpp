@@ -0,0 +1,170 @@
+#pragma once
+
+/** @file */
+
+#include "bitboard.hpp"
+#include "position.hpp"
+
+#include <array>
+#include <cstdint>
+
+/*
+	Sliding attacks are looked up through a per-square hash of the blocking pieces.
+
+	PEXT (BMI2) is used to form the hash when it is available, otherwise a magic multiply
+	is used. Define SCREEPFISH_NO_PEXT to force the magic multiply path.
+*/
+#if !defined(SCREEPFISH_NO_PEXT) && (defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__)))
+	#define SCREEPFISH_SLIDING_PEXT 1
+	#include <immintrin.h>
+#else
+	#define SCREEPFISH_SLIDING_PEXT 0
+#endif
+
+namespace chess
+{
+	namespace impl
+	{
+		/**
+		 * @brief Attack lookup data for a single sliding piece on a single square.
+		*/
+		struct SlidingAttackEntry
+		{
+			/**
+			 * @brief Squares whose occupancy can block the piece, excludes the board edges.
+			*/
+			uint64_t mask_;
+
+			/**
+			 * @brief Magic multiplier mapping masked occupancy to a table index.
+			*/
+			uint64_t magic_;
+
+			/**
+			 * @brief Attack sets for this square, indexed by the hashed occupancy.
+			*/
+			const uint64_t* attacks_;
+
+			/**
+			 * @brief Shift applied after the magic multiply.
+			*/
+			uint32_t shift_;
+
+			uint64_t index(uint64_t _occupied) const noexcept
+			{
+#if SCREEPFISH_SLIDING_PEXT
+				return _pext_u64(_occupied, this->mask_);
+#else
+				return ((_occupied & this->mask_) * this->magic_) >> this->shift_;
+#endif
+			};
+
+			uint64_t attacks(uint64_t _occupied) const noexcept
+			{
+				return this->attacks_[this->index(_occupied)];
+			};
+		};
+
+		/**
+		 * @brief Rook attack lookup data for each position, filled in at startup.
+		*/
+		extern std::array<SlidingAttackEntry, 64> rook_attack_entries_v;
+
+		/**
+		 * @brief Bishop attack lookup data for each position, filled in at startup.
+		*/
+		extern std::array<SlidingAttackEntry, 64> bishop_attack_entries_v;
+	};
+
+	/**
+	 * @brief Gets the squares attacked by a rook, stopping at (and including) the first blocker in each direction.
+	 * @param _pos Position of the rook.
+	 * @param _occupied Bitboard with all occupied squares.
+	 * @return Attacked squares, this may include friendly pieces.
+	*/
+	inline BitBoard get_rook_attacks(Position _pos, BitBoard _occupied) noexcept
+	{
+		const auto& _entry = impl::rook_attack_entries_v[static_cast<size_t>(_pos)];
+		return BitBoard(_entry.attacks(_occupied.to_uint64()));
+	};
+
+	/**
+	 * @brief Gets the squares attacked by a bishop, stopping at (and including) the first blocker in each direction.
+	 * @param _pos Position of the bishop.
+	 * @param _occupied Bitboard with all occupied squares.
+	 * @return Attacked squares, this may include friendly pieces.
+	*/
+	inline BitBoard get_bishop_attacks(Position _pos, BitBoard _occupied) noexcept
+	{
+		const auto& _entry = impl::bishop_attack_entries_v[static_cast<size_t>(_pos)];
+		return BitBoard(_entry.attacks(_occupied.to_uint64()));
+	};
+
+	/**
+	 * @brief Gets the squares attacked by a queen, stopping at (and including) the first blocker in each direction.
+	 * @param _pos Position of the queen.
+	 * @param _occupied Bitboard with all occupied squares.
+	 * @return Attacked squares, this may include friendly pieces.
+	*/
+	inline BitBoard get_queen_attacks(Position _pos, BitBoard _occupied) noexcept
+	{
+		return get_rook_attacks(_pos, _occupied) | get_bishop_attacks(_pos, _occupied);
+	};
+
+	/**
+	 * @brief Gets the squares strictly between two positions that share a file, rank or diagonal.
+	 * @param _from First position.
+	 * @param _to Second position.
+	 * @return Squares between the two positions, empty if they are not aligned.
+	*/
+	inline BitBoard get_squares_between(Position _from, Position _to) noexcept
+	{
+		const auto _fromBits = BitBoard(uint64_t(1) << static_cast<size_t>(_from));
+		const auto _toBits = BitBoard(uint64_t(1) << static_cast<size_t>(_to));
+		if (get_rook_attacks(_from, BitBoard(0)).test(_to))
+		{
+			return get_rook_attacks(_from, _toBits) & get_rook_attacks(_to, _fromBits);
+		}
+		else if (get_bishop_attacks(_from, BitBoard(0)).test(_to))
+		{
+			return get_bishop_attacks(_from, _toBits) & get_bishop_attacks(_to, _fromBits);
+		}
+		else
+		{
+			return BitBoard(0);
+		};
+	};
+
+	/**
+	 * @brief Gets the full file, rank or diagonal running through two positions.
+	 * @param _from First position.
+	 * @param _to Second position.
+	 * @return Squares on the line including both positions, empty if they are not aligned.
+	*/
+	inline BitBoard get_line_through(Position _from, Position _to) noexcept
+	{
+		const auto _ends = BitBoard((uint64_t(1) << static_cast<size_t>(_from)) | (uint64_t(1) << static_cast<size_t>(_to)));
+		if (get_rook_attacks(_from, BitBoard(0)).test(_to))
+		{
+			return (get_rook_attacks(_from, BitBoard(0)) & get_rook_attacks(_to, BitBoard(0))) | _ends;
+		}
+		else if (get_bishop_attacks(_from, BitBoard(0)).test(_to))
+		{
+			return (get_bishop_attacks(_from, BitBoard(0)) & get_bishop_attacks(_to, BitBoard(0))) | _ends;
+		}
+		else
+		{
+			return BitBoard(0);
+		};
+	};
+
+	/**
+	 * @brief Computes sliding attacks by walking each ray, used to build and verify the lookup tables.
+	 * @param _pos Position of the sliding piece.
+	 * @param _occupied Bitboard with all occupied squares.
+	 * @param _diagonal True for bishop rays, false for rook rays.
+	 * @return Attacked squares.
+	*/
+	BitBoard compute_sliding_attacks_slow(Position _pos, BitBoard _occupied, bool _diagonal);
+
+};
@@ -0,0 +1,133 @@
+#include "transposition.hpp"
+
+#include <bit>
+#include <limits>
+#include <algorithm>
+
+namespace chess
+{
+	uint64_t TranspositionTable::pack(Move _move, Rating _score, uint8_t _depth, Bound _bound, uint8_t _age) noexcept
+	{
+		return
+			uint64_t(_move.to_bits()) |
+			(uint64_t(std::bit_cast<uint32_t>(_score)) << 16) |
+			(uint64_t(_depth) << 48) |
+			(uint64_t(static_cast<uint8_t>(_bound)) << 56) |
+			(uint64_t(_age & age_mask_v) << 58);
+	};
+	TTEntry TranspositionTable::unpack(uint64_t _data) noexcept
+	{
+		auto _entry = TTEntry{};
+		_entry.move_ = Move::from_bits(static_cast<uint16_t>(_data));
+		_entry.score_ = std::bit_cast<Rating>(static_cast<uint32_t>(_data >> 16));
+		_entry.depth_ = static_cast<uint8_t>(_data >> 48);
+		_entry.bound_ = Bound(static_cast<uint8_t>(_data >> 56) & 0b11);
+		return _entry;
+	};
+
+	void TranspositionTable::resize(size_t _megabytes)
+	{
+		const auto _buckets = (_megabytes * 1024 * 1024) / sizeof(Bucket);
+		this->bucket_count_ = (_buckets == 0) ? 1 : std::bit_floor(_buckets);
+		this->buckets_ = std::make_unique<Bucket[]>(this->bucket_count_);
+		this->age_ = 0;
+	};
+
+	void TranspositionTable::clear()
+	{
+		for (size_t n = 0; n != this->bucket_count_; ++n)
+		{
+			for (auto& _slot : this->buckets_[n].slots_)
+			{
+				_slot.key_.store(0, std::memory_order_relaxed);
+				_slot.data_.store(0, std::memory_order_relaxed);
+			};
+		};
+		this->age_ = 0;
+	};
+
+	std::optional<TTEntry> TranspositionTable::probe(uint64_t _key) const noexcept
+	{
+		if (this->bucket_count_ == 0)
+		{
+			return std::nullopt;
+		};
+
+		for (auto& _slot : this->bucket_for(_key).slots_)
+		{
+			const auto _data = _slot.data_.load(std::memory_order_relaxed);
+			if ((_slot.key_.load(std::memory_order_relaxed) ^ _data) == _key && _data != 0)
+			{
+				return unpack(_data);
+			};
+		};
+		return std::nullopt;
+	};
+
+	void TranspositionTable::store(uint64_t _key, Move _move, Rating _score, uint8_t _depth, Bound _bound) noexcept
+	{
+		if (this->bucket_count_ == 0)
+		{
+			return;
+		};
+
+		auto& _bucket = this->bucket_for(_key);
+
+		// Use the slot already holding the position if there is one, otherwise the least useful slot.
+		// Slots from older searches count as shallower the older they are.
+		Slot* _replace = nullptr;
+		int _replaceWorth = std::numeric_limits<int>::max();
+		for (auto& _slot : _bucket.slots_)
+		{
+			const auto _data = _slot.data_.load(std::memory_order_relaxed);
+			if ((_slot.key_.load(std::memory_order_relaxed) ^ _data) == _key && _data != 0)
+			{
+				const auto _old = unpack(_data);
+
+				// Keep a deeper result for the position unless the new one is exact
+				if (_bound != Bound::exact && _old.depth_ > _depth + 2 && unpack_age(_data) == this->age_)
+				{
+					return;
+				};
+				if (!_move)
+				{
+					_move = _old.move_;
+				};
+				_replace = &_slot;
+				break;
+			};
+
+			const auto _relativeAge = (this->age_ - unpack_age(_data)) & age_mask_v;
+			const auto _worth = (_data == 0) ?
+				std::numeric_limits<int>::min() :
+				static_cast<int>(unpack(_data).depth_) - static_cast<int>(_relativeAge) * 8;
+			if (_worth < _replaceWorth)
+			{
+				_replace = &_slot;
+				_replaceWorth = _worth;
+			};
+		};
+
+		const auto _data = pack(_move, _score, _depth, _bound, this->age_);
+		_replace->key_.store(_key ^ _data, std::memory_order_relaxed);
+		_replace->data_.store(_data, std::memory_order_relaxed);
+	};
+
+	size_t TranspositionTable::hashfull() const noexcept
+	{
+		const auto _buckets = std::min<size_t>(this->bucket_count_, 1000 / bucket_size_v);
+		size_t _used = 0;
+		for (size_t n = 0; n != _buckets; ++n)
+		{
+			for (auto& _slot : this->buckets_[n].slots_)
+			{
+				const auto _data = _slot.data_.load(std::memory_order_relaxed);
+				if (_data != 0 && unpack_age(_data) == this->age_)
+				{
+					++_used;
+				};
+			};
+		};
+		return (_buckets == 0) ? 0 : (_used * 1000) / (_buckets * bucket_size_v);
+	};
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+/** @file */
+
+#include "piece.hpp"
+#include "rating.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+
+namespace chess
+{
+	/**
+	 * @brief What a stored score says about the true score of a position, from the side to move's view.
+	*/
+	enum class Bound : uint8_t
+	{
+		none = 0,
+
+		/**
+		 * @brief The true score is at most the stored score, no move raised alpha.
+		*/
+		upper = 1,
+
+		/**
+		 * @brief The true score is at least the stored score, a move caused a beta cutoff.
+		*/
+		lower = 2,
+
+		/**
+		 * @brief The stored score is the true score.
+		*/
+		exact = 3,
+	};
+
+	/**
+	 * @brief A search result read back from the transposition table.
+	*/
+	struct TTEntry
+	{
+		/**
+		 * @brief Best move found, may be null.
+		*/
+		Move move_{};
+
+		/**
+		 * @brief Score for the side to move.
+		*/
+		Rating score_ = 0;
+
+		/**
+		 * @brief Number of plies that were searched below the position.
+		*/
+		uint8_t depth_ = 0;
+
+		Bound bound_ = Bound::none;
+	};
+
+	/**
+	 * @brief Fixed size hash table of search results keyed by zobrist hash, shared between searches and threads.
+	 *
+	 * Entries are two 64 bit words, the packed data and the key XOR'd with the data. Both are written with
+	 * relaxed atomics and no lock, a reader that sees halves of two different writes gets a key that does
+	 * not match and treats the entry as missing. Four entries make up a 64 byte bucket so a probe touches
+	 * a single cache line.
+	 *
+	 * Entries are replaced by preferring ones left over from older searches and then shallower ones.
+	*/
+	class TranspositionTable
+	{
+	public:
+
+		/**
+		 * @brief Reallocates the table, clearing it.
+		 * @param _megabytes Size of the table, rounded down to a power of two number of buckets.
+		*/
+		void resize(size_t _megabytes);
+
+		/**
+		 * @brief Empties the table, should be called between games.
+		*/
+		void clear();
+
+		/**
+		 * @brief Marks the start of a new search so that entries from earlier ones are replaced first.
+		*/
+		void new_search() noexcept
+		{
+			this->age_ = static_cast<uint8_t>((this->age_ + 1) & age_mask_v);
+		};
+
+		/**
+		 * @brief Looks up a position.
+		 * @param _key Zobrist hash of the position.
+		 * @return The stored entry, or nullopt if the position is not in the table.
+		*/
+		std::optional<TTEntry> probe(uint64_t _key) const noexcept;
+
+		/**
+		 * @brief Stores a search result for a position.
+		 * @param _key Zobrist hash of the position.
+		 * @param _move Best move found, a null move keeps the move already stored for the position.
+		 * @param _score Score for the side to move.
+		 * @param _depth Number of plies searched below the position.
+		 * @param _bound What the score says about the true score.
+		*/
+		void store(uint64_t _key, Move _move, Rating _score, uint8_t _depth, Bound _bound) noexcept;
+
+		/**
+		 * @brief Gets the number of entries the table can hold.
+		*/
+		size_t capacity() const noexcept
+		{
+			return this->bucket_count_ * bucket_size_v;
+		};
+
+		/**
+		 * @brief Estimates how full the table is from the first thousand buckets.
+		 * @return Entries used by the current search out of every 1000.
+		*/
+		size_t hashfull() const noexcept;
+
+		TranspositionTable() = default;
+		explicit TranspositionTable(size_t _megabytes)
+		{
+			this->resize(_megabytes);
+		};
+
+	private:
+
+		struct Slot
+		{
+			std::atomic<uint64_t> key_{ 0 };
+			std::atomic<uint64_t> data_{ 0 };
+		};
+
+		constexpr static size_t bucket_size_v = 4;
+
+		struct alignas(64) Bucket
+		{
+			std::array<Slot, bucket_size_v> slots_{};
+		};
+		static_assert(sizeof(Bucket) == 64);
+
+		// Data word layout : move (16) | score (32) | depth (8) | bound (2) | age (6)
+		constexpr static uint8_t age_mask_v = 0b111111;
+
+		static uint64_t pack(Move _move, Rating _score, uint8_t _depth, Bound _bound, uint8_t _age) noexcept;
+		static TTEntry unpack(uint64_t _data) noexcept;
+		static uint8_t unpack_age(uint64_t _data) noexcept
+		{
+			return static_cast<uint8_t>(_data >> 58);
+		};
+
+		Bucket& bucket_for(uint64_t _key) const noexcept
+		{
+			return this->buckets_[_key & (this->bucket_count_ - 1)];
+		};
+
+		std::unique_ptr<Bucket[]> buckets_{};
+		size_t bucket_count_ = 0;
+		uint8_t age_ = 0;
+	};
+};
@@ -0,0 +1,142 @@
+#include "work_pool.hpp"
+
+#include "utility/utility.hpp"
+
+namespace chess
+{
+	namespace
+	{
+		/**
+		 * @brief Pool the calling thread belongs to, null for threads outside any pool.
+		*/
+		thread_local const WorkStealingPool* this_thread_pool_ = nullptr;
+
+		/**
+		 * @brief Queue owned by the calling thread within its pool.
+		*/
+		thread_local size_t this_thread_queue_ = 0;
+	};
+
+	size_t WorkStealingPool::own_queue() const noexcept
+	{
+		return (this_thread_pool_ == this) ? this_thread_queue_ : 0;
+	};
+
+	void WorkStealingPool::submit(TaskGroup& _group, task_type _task)
+	{
+		_group.pending_.fetch_add(1, std::memory_order_relaxed);
+		{
+			auto& _queue = *this->queues_[this->own_queue()];
+			const auto lck = std::unique_lock(_queue.mtx_);
+			_queue.jobs_.push_back(Job{ std::move(_task), &_group });
+		};
+		this->queued_.fetch_add(1, std::memory_order_release);
+
+		// Taking the lock orders this with an idle thread checking queued_ before it sleeps
+		{
+			const auto lck = std::unique_lock(this->idle_mtx_);
+		};
+		this->idle_cv_.notify_one();
+	};
+
+	bool WorkStealingPool::run_one(size_t _ownQueue)
+	{
+		if (this->queued_.load(std::memory_order_acquire) == 0)
+		{
+			return false;
+		};
+
+		auto _job = Job{};
+		const auto _queueCount = this->queues_.size();
+		for (size_t n = 0; n != _queueCount && !_job.group_; ++n)
+		{
+			// Newest task from our own queue, oldest from anyone else's
+			const auto _index = (_ownQueue + n) % _queueCount;
+			auto& _queue = *this->queues_[_index];
+			const auto lck = std::unique_lock(_queue.mtx_);
+			if (_queue.jobs_.empty())
+			{
+				continue;
+			};
+
+			if (n == 0)
+			{
+				_job = std::move(_queue.jobs_.back());
+				_queue.jobs_.pop_back();
+			}
+			else
+			{
+				_job = std::move(_queue.jobs_.front());
+				_queue.jobs_.pop_front();
+			};
+		};
+
+		if (!_job.group_)
+		{
+			return false;
+		};
+
+		this->queued_.fetch_sub(1, std::memory_order_relaxed);
+		_job.task_();
+		_job.group_->pending_.fetch_sub(1, std::memory_order_release);
+		return true;
+	};
+
+	void WorkStealingPool::wait(TaskGroup& _group)
+	{
+		const auto _ownQueue = this->own_queue();
+		while (!_group.done())
+		{
+			if (!this->run_one(_ownQueue))
+			{
+				// Our tasks are running on other threads
+				std::this_thread::yield();
+			};
+		};
+	};
+
+	void WorkStealingPool::thread_main(std::stop_token _stop, size_t _queue)
+	{
+		this_thread_pool_ = this;
+		this_thread_queue_ = _queue;
+
+		while (!_stop.stop_requested())
+		{
+			if (this->run_one(_queue))
+			{
+				continue;
+			};
+
+			auto lck = std::unique_lock(this->idle_mtx_);
+			this->idle_cv_.wait(lck, _stop, [this]()
+				{
+					return this->queued_.load(std::memory_order_acquire) != 0;
+				});
+		};
+	};
+
+	WorkStealingPool::WorkStealingPool(size_t _threads)
+	{
+		for (size_t n = 0; n != _threads + 1; ++n)
+		{
+			this->queues_.push_back(std::make_unique<Queue>());
+		};
+		for (size_t n = 0; n != _threads; ++n)
+		{
+			this->threads_.emplace_back([this, n](std::stop_token _stop)
+				{
+					this->thread_main(_stop, n + 1);
+				});
+		};
+	};
+	WorkStealingPool::~WorkStealingPool()
+	{
+		// Join before the members the threads use are destroyed
+		for (auto& _thread : this->threads_)
+		{
+			_thread.request_stop();
+		};
+		this->threads_.clear();
+		SCREEPFISH_ASSERT(this->queued_.load() == 0);
+	};
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+/** @file */
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <functional>
+#include <condition_variable>
+
+namespace chess
+{
+	/**
+	 * @brief Tracks a set of tasks submitted to a WorkStealingPool so they can be waited on together.
+	*/
+	class TaskGroup
+	{
+	public:
+
+		/**
+		 * @brief Checks if every task in the group has finished.
+		*/
+		bool done() const noexcept
+		{
+			return this->pending_.load(std::memory_order_acquire) == 0;
+		};
+
+		TaskGroup() = default;
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+	private:
+		friend class WorkStealingPool;
+		std::atomic<size_t> pending_{ 0 };
+	};
+
+	/**
+	 * @brief Thread pool where each thread keeps its own queue of tasks and steals from the others when it runs dry.
+	 *
+	 * Threads take their own newest tasks first and steal the oldest tasks from others, the oldest
+	 * tasks being the biggest pieces of work in a recursive search. A thread waiting on a group runs
+	 * other tasks in the meantime instead of blocking, so tasks may submit and wait on tasks of their own.
+	 *
+	 * Threads that are not part of the pool can submit and wait too, they share a single queue.
+	*/
+	class WorkStealingPool
+	{
+	public:
+
+		using task_type = std::function<void()>;
+
+		/**
+		 * @brief Queues a task.
+		 * @param _group Group the task is counted in, must outlive the task.
+		 * @param _task Task to run.
+		*/
+		void submit(TaskGroup& _group, task_type _task);
+
+		/**
+		 * @brief Runs queued tasks until every task in a group has finished.
+		 * @param _group Group to wait on.
+		*/
+		void wait(TaskGroup& _group);
+
+		/**
+		 * @brief Gets the number of threads that run tasks, not counting threads waiting on a group.
+		*/
+		size_t thread_count() const noexcept
+		{
+			return this->threads_.size();
+		};
+
+		/**
+		 * @brief Starts the pool's threads.
+		 * @param _threads Number of threads to start, 0 runs every task on the thread that waits for it.
+		*/
+		explicit WorkStealingPool(size_t _threads);
+		~WorkStealingPool();
+
+		WorkStealingPool(const WorkStealingPool&) = delete;
+		WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	private:
+
+		struct Job
+		{
+			task_type task_;
+			TaskGroup* group_ = nullptr;
+		};
+
+		struct alignas(64) Queue
+		{
+			std::mutex mtx_;
+			std::deque<Job> jobs_;
+		};
+
+		/**
+		 * @brief Gets the queue owned by the calling thread.
+		*/
+		size_t own_queue() const noexcept;
+
+		/**
+		 * @brief Runs one queued task, the calling thread's own first and then any other thread's.
+		 * @return True if a task was run.
+		*/
+		bool run_one(size_t _ownQueue);
+
+		void thread_main(std::stop_token _stop, size_t _queue);
+
+		// Queue 0 is shared by every thread outside the pool, the pool's threads own one each after it
+		std::vector<std::unique_ptr<Queue>> queues_;
+		std::vector<std::jthread> threads_;
+		std::atomic<size_t> queued_{ 0 };
+
+		// Idle threads sleep here until a task is queued
+		std::mutex idle_mtx_;
+		std::condition_variable_any idle_cv_;
+	};
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+/** @file */
+
+#include "piece.hpp"
+#include "position.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace chess
+{
+	/**
+	 * @brief Random keys that are combined to form the zobrist hash of a position.
+	*/
+	struct ZobristKeys
+	{
+		/**
+		 * @brief Keys for each piece on each position, see zobrist_piece_key().
+		*/
+		std::array<std::array<uint64_t, 64>, 12> pieces_{};
+
+		/**
+		 * @brief Key present when black is to move.
+		*/
+		uint64_t black_to_move_ = 0;
+
+		/**
+		 * @brief Keys for each combination of castling rights, indexed by CastleBit.
+		*/
+		std::array<uint64_t, 16> castle_{};
+
+		/**
+		 * @brief Keys for the file of the en passant target, if there is one.
+		*/
+		std::array<uint64_t, 8> enpassant_file_{};
+	};
+
+	namespace impl
+	{
+		constexpr uint64_t splitmix64(uint64_t& _state) noexcept
+		{
+			auto z = (_state += 0x9E37'79B9'7F4A'7C15);
+			z = (z ^ (z >> 30)) * 0xBF58'476D'1CE4'E5B9;
+			z = (z ^ (z >> 27)) * 0x94D0'49BB'1331'11EB;
+			return z ^ (z >> 31);
+		};
+
+		/**
+		 * @brief Generates the zobrist keys from a fixed seed so hashes are the same on every run.
+		*/
+		consteval ZobristKeys make_zobrist_keys()
+		{
+			auto o = ZobristKeys{};
+			uint64_t _state = 0x5C5E'E9F1'5C00'0001;
+			for (auto& _piece : o.pieces_)
+			{
+				for (auto& _key : _piece)
+				{
+					_key = splitmix64(_state);
+				};
+			};
+			o.black_to_move_ = splitmix64(_state);
+
+			// Each castling right has its own key, no rights gives no key
+			auto _rights = std::array<uint64_t, 4>{};
+			for (auto& _key : _rights)
+			{
+				_key = splitmix64(_state);
+			};
+			for (size_t n = 0; n != o.castle_.size(); ++n)
+			{
+				for (size_t b = 0; b != _rights.size(); ++b)
+				{
+					if (n & (size_t(1) << b))
+					{
+						o.castle_[n] ^= _rights[b];
+					};
+				};
+			};
+
+			for (auto& _key : o.enpassant_file_)
+			{
+				_key = splitmix64(_state);
+			};
+			return o;
+		};
+	};
+
+	constexpr inline auto zobrist_keys_v = impl::make_zobrist_keys();
+
+	constexpr uint64_t zobrist_piece_key(Piece _piece, Position _pos) noexcept
+	{
+		const auto _index = (static_cast<size_t>(jc::to_underlying(_piece.type()) - 1) << 1) |
+			static_cast<size_t>(_piece.is_white());
+		return zobrist_keys_v.pieces_[_index][static_cast<size_t>(_pos)];
+	};
+	constexpr uint64_t zobrist_castle_key(CastleBit _bits) noexcept
+	{
+		return zobrist_keys_v.castle_[static_cast<size_t>(_bits)];
+	};
+	constexpr uint64_t zobrist_enpassant_key(Position _target) noexcept
+	{
+		return zobrist_keys_v.enpassant_file_[static_cast<size_t>(_target.file())];
+	};
+};
@@ -5,6 +5,7 @@
 
 #include "utility/string.hpp"
 #include "utility/logging.hpp"
+#include "utility/monotonic_arena.hpp"
 
 #include <array>
 #include <vector>
@@ -20,60 +21,135 @@
 
 namespace sch
 {
-	chess::MoveTree ScreepFish::build_move_tree(const chess::Board& _board, chess::Color _forPlayer, int _depth)
+	namespace
 	{
-		using namespace chess;
-
-		// Configure tree profile.
-		auto _profile = MoveTreeProfile();
-		_profile.follow_captures_ = false;
-		_profile.follow_checks_ = false;
-		_profile.enable_pruning_ = false;
-		_profile.alphabeta_ = true;
+		/**
+		 * @brief Settings for the engine's searches, shared by both ways of searching so they agree.
+		*/
+		chess::MoveTreeProfile search_profile()
+		{
+			auto _profile = chess::MoveTreeProfile();
+			_profile.enable_pruning_ = true;
+			_profile.alphabeta_ = true;
+			return _profile;
+		};
+	};
 
+	chess::MoveTree ScreepFish::build_move_tree(const chess::Board& _board, chess::Color _forPlayer, int _depth,
+		chess::SearchStop& _stop, chess::SearchHeuristics& _heuristics, std::optional<chess::Rating> _expectedRating,
+		chess::WorkStealingPool* _pool)
+	{
 		// BUILD THE TREE
 		auto _tree = chess::MoveTree(_board);
-		_tree.build_tree((size_t)_depth, _depth, _profile);
+		_tree.set_history(this->search_history_);
+		_tree.set_transposition_table(&this->tt_);
+		_tree.set_search_stop(&_stop);
+		_tree.set_search_heuristics(&_heuristics);
+		_tree.set_expected_rating(_expectedRating);
+		_tree.set_work_pool(_pool);
+		_tree.build_tree((size_t)_depth, _depth, search_profile());
 
 		return _tree;
 	};
 
+	chess::SearchResult ScreepFish::search_position(const chess::Board& _board, int _depth, chess::Search& _search,
+		chess::SearchStop& _stop, chess::SearchHeuristics& _heuristics, std::optional<chess::Rating> _expectedRating)
+	{
+		_search.set_history(this->search_history_);
+		_search.set_transposition_table(&this->tt_);
+		_search.set_search_stop(&_stop);
+		_search.set_search_heuristics(&_heuristics);
+		_search.set_expected_rating(_expectedRating);
+		return _search.run(_board, static_cast<size_t>(_depth), search_profile());
+	};
+
+	void ScreepFish::helper_search(size_t _helperIndex)
+	{
+		// Half the helpers search the main thread's depth and half one deeper, and each starts its move
+		// ordering from its own random history. This spreads them over the tree as they race each other
+		// through the transposition table.
+		auto _heuristics = std::make_unique<chess::SearchHeuristics>();
+		_heuristics->seed(static_cast<uint32_t>(_helperIndex + 1));
+		auto _search = std::make_unique<chess::Search>();
+		auto _lastRating = std::optional<chess::Rating>();
+		size_t _lastDepth = 0;
+		while (!this->helper_stop_.stopped() && _lastDepth < max_search_depth_v)
+		{
+			const auto _depth = std::max(this->main_depth_.load(std::memory_order_relaxed) + (_helperIndex % 2),
+				_lastDepth + 1);
+			const auto _move = this->search_position(this->search_board_, static_cast<int>(_depth), *_search,
+				this->helper_stop_, *_heuristics, _lastRating).best_move_;
+			if (_move)
+			{
+				_lastRating = _move->rating();
+			};
+			_lastDepth = _depth;
+		};
+	};
+
 	void ScreepFish::set_board(const chess::Board& _board)
 	{
 		const auto lck = std::unique_lock(this->mtx_);
 		this->board_ = _board;
 	};
+	void ScreepFish::set_history(const chess::PositionHistory& _history)
+	{
+		const auto lck = std::unique_lock(this->mtx_);
+		this->history_ = _history;
+	};
 
 	chess::Response ScreepFish::get_move()
 	{
-		// Clear the previous best move
+		auto lck = std::unique_lock(this->mtx_);
+
+		// Clear the previous best move and ask the engine thread to calculate the next one. A search still
+		// running for an earlier request that timed out is for an old board, stop it so this one can start.
+		const auto _request = ++this->move_request_;
+		this->best_move_.reset();
+		this->search_stop_.stop();
+
+		const auto _ready = [this, _request]()
+		{
+			return this->best_move_.has_value() && this->searched_request_ == _request;
+		};
+		const auto _pickedUp = [this, _request]()
 		{
-			const auto lck = std::unique_lock(this->mtx_);
-			this->best_move_.reset();
+			return this->searched_request_ == _request;
 		};
 
-		for(int n = 0; n != 1000; ++n)
+		// The search publishes its deadline when it picks up the request, without one it runs to its fixed
+		// depth however long that takes. A request that is never picked up means the engine thread is not
+		// running, either start() was never called or stop() has already joined it.
+		if (!this->best_move_cv_.wait_for(lck, move_wait_slack_v, _pickedUp))
 		{
-			// Try to get the next move
-			{
-				const auto lck = std::unique_lock(this->mtx_);
-				if (this->best_move_)
-				{
-					return this->best_move_.value();
-				};
-			};
+			return chess::Response{};
+		};
+		if (!this->search_deadline_)
+		{
+			this->best_move_cv_.wait(lck, _ready);
+			return this->best_move_.value();
+		};
 
-			// Wait a bit
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		const bool _hasMove = this->best_move_cv_.wait_until(lck, *this->search_deadline_ + move_wait_slack_v, _ready);
+		if (!_hasMove)
+		{
+			// Timed out
+			return chess::Response{};
 		};
+		return this->best_move_.value();
+	};
 
-		// Timed out
-		return chess::Response{};
+	std::optional<chess::RatedMove> ScreepFish::get_rated_move() const
+	{
+		const auto lck = std::unique_lock(this->mtx_);
+		return this->best_rated_move_;
 	};
 
 	void ScreepFish::start(chess::Board _initialBoard, chess::Color _color)
 	{
 		this->board_ = _initialBoard;
+		this->history_.clear();
+		this->tt_.clear();
 		this->my_color_ = _color;
 
 		sch::log_info("About to start screepfish thread");
@@ -87,43 +163,37 @@ namespace sch
 	};
 	void ScreepFish::stop()
 	{
+		this->search_stop_.stop();
+		this->helper_stop_.stop();
 		this->thread_.request_stop();
 		if (this->thread_.joinable())
 		{
 			this->thread_.join();
 		};
+
+		// No more trees will be built, give the chunks they pooled back to the system
+		sch::MonotonicArena::release_pool();
 	};
 	
 
 
 
-	void ScreepFish::calculate_next_move()
+	std::optional<chess::RatedMove> ScreepFish::calculate_next_move(size_t _threadCount, size_t _searchDepth,
+		bool _treeSearch, const std::optional<std::filesystem::path>& _loggingDir)
 	{
 		using namespace chess;
 
-		const auto& _board = this->board_;
+		const auto& _board = this->search_board_;
 		const auto& _myColor = this->my_color_;
 
-		const size_t _pieceCount = _board.pieces().size();
-		auto _depth = this->search_depth_;
-
-		// Bump depth as many moves will be discarded
-		const bool _isCheck = is_check(_board, _myColor);
-
-		if (_pieceCount <= 8 && !_isCheck)
-		{
-			_depth += 1;
-		}
-		if (_pieceCount <= 4 && !_isCheck)
-		{
-			_depth += 1;
-		};
-
+		// Deepest depth that was fully searched
+		size_t _depth = 0;
 
 		// TODO : Split this function into at least two parts - one for book moves, one for evaluated moves
 
 		auto _move = std::optional<RatedMove>(std::nullopt);
 		auto _tree = chess::MoveTree();
+		auto _result = chess::SearchResult();
 
 		bool _isBookMove = false;
 
@@ -153,9 +223,82 @@ namespace sch
 		if (!_isBookMove)
 		{
 			t0 = _clock.now();
-			_tree = this->build_move_tree(_board, _myColor, _depth);
+			this->tt_.new_search();
+			this->heuristics_.clear();
+
+			// Trees are too big for every thread to build its own, the one tree is split between the threads.
+			// The engine thread waits on the pool so it runs tasks too.
+			auto _pool = std::unique_ptr<WorkStealingPool>();
+			if (_treeSearch && _threadCount > 1)
+			{
+				_pool = std::make_unique<WorkStealingPool>(_threadCount - 1);
+			};
+
+			// Lazy SMP, helpers search the same position and share the transposition table with the main search
+			this->main_depth_.store(2, std::memory_order_relaxed);
+			this->helper_stop_.reset();
+			auto _helpers = std::vector<std::jthread>();
+			for (size_t n = 1; n < _threadCount && !_treeSearch; ++n)
+			{
+				_helpers.emplace_back([this, n]()
+					{
+						this->helper_search(n - 1);
+					});
+			};
+
+			// Search one depth deeper at a time until the time manager says to stop. Shallower depths
+			// fill the transposition table with the move ordering the deeper ones start from.
+			const auto _maxDepth = this->time_manager_.is_limited() ?
+				max_search_depth_v : std::max<size_t>(_searchDepth, 2);
+			for (size_t _nextDepth = 2; _nextDepth <= _maxDepth; ++_nextDepth)
+			{
+				this->main_depth_.store(_nextDepth, std::memory_order_relaxed);
+				// Each depth starts from a narrow window around the last depth's rating
+				const auto _expectedRating = (_move) ? std::optional<Rating>(_move->rating()) : std::nullopt;
+				auto _nextTree = chess::MoveTree();
+				auto _nextResult = chess::SearchResult();
+				if (_treeSearch)
+				{
+					_nextTree = this->build_move_tree(_board, _myColor, static_cast<int>(_nextDepth), this->search_stop_,
+						this->heuristics_, _expectedRating, _pool.get());
+					_nextResult.best_move_ = _nextTree.best_move(this->rnd_);
+				}
+				else
+				{
+					_nextResult = this->search_position(_board, static_cast<int>(_nextDepth), this->search_,
+						this->search_stop_, this->heuristics_, _expectedRating);
+				};
+				if (this->search_stop_.stopped())
+				{
+					// Ran out of time part way through, keep the result from the last full depth
+					break;
+				};
+
+				const auto _nextMove = _nextResult.best_move_;
+				const bool _bestMoveChanged = !_move || !_nextMove ||
+					static_cast<const Move&>(*_move) != static_cast<const Move&>(*_nextMove);
+
+				_tree = std::move(_nextTree);
+				_result = std::move(_nextResult);
+				_move = _nextMove;
+				_depth = _nextDepth;
+
+				if (!_move || !this->time_manager_.next_depth(_bestMoveChanged, _move->rating()))
+				{
+					break;
+				};
+
+				// Only the first depth is searched without a deadline so there is always a move to play
+				if (this->time_manager_.is_limited())
+				{
+					this->search_stop_.set_deadline(this->time_manager_.deadline());
+				};
+			};
+
+			this->helper_stop_.stop();
+			_helpers.clear();
+
 			t1 = _clock.now();
-			_move = _tree.best_move(this->rnd_);
 			t2 = _clock.now();
 		};
 
@@ -164,7 +307,7 @@ namespace sch
 		const auto td = t2 - t0;
 
 		// Log if set
-		if (auto& _loggingDir = this->logging_dir_; _loggingDir)
+		if (_loggingDir)
 		{
 			// Log the text data
 			{
@@ -188,14 +331,22 @@ namespace sch
 					const auto _path = _dirPath / "perf.txt";
 					auto _file = std::ofstream(_path);
 					_file << "Total		  : " << cvt(td) << '\n';
-					if (!_isBookMove)
+					if (!_isBookMove && _treeSearch)
 					{
 						_file << "Tree Build      : " << cvt(tdA) << '\n';
 						_file << "Tree Search     : " << cvt(tdB) << '\n';
 						_file << "Total Tree Size : " << _tree.tree_size() << '\n';
 						_file << "Nodes / Second  : " <<
 							(double)_tree.tree_size() / cvt(td).count() << '\n';
-
+						_file << "Arena Peak      : " << _tree.arena().peak_bytes() << " bytes\n";
+						_file << "Arena Chunks    : " << _tree.arena().chunk_count() << '\n';
+					}
+					else if (!_isBookMove)
+					{
+						_file << "Search          : " << cvt(tdA) << '\n';
+						_file << "Nodes           : " << _result.nodes_ << '\n';
+						_file << "Nodes / Second  : " <<
+							(double)_result.nodes_ / cvt(td).count() << '\n';
 					};
 				};
 
@@ -216,7 +367,7 @@ namespace sch
 				};
 
 				// Top level moves
-				if(!_isBookMove)
+				if (!_isBookMove && _treeSearch)
 				{
 					const auto _path = _dirPath / "moves.txt";
 					auto _file = std::ofstream(_path);
@@ -229,7 +380,7 @@ namespace sch
 				};
 
 				// Second level moves
-				if (!_isBookMove)
+				if (!_isBookMove && _treeSearch)
 				{
 					const auto _path = _dirPath / "moves2.txt";
 					auto _file = std::ofstream(_path);
@@ -253,7 +404,7 @@ namespace sch
 				};
 
 				// Lines
-				if (!_isBookMove)
+				if (!_isBookMove && _treeSearch)
 				{
 					const auto _topLines = _tree.get_top_lines(3);
 					size_t _lineN = 0;
@@ -283,13 +434,33 @@ namespace sch
 							_file << get_fen(b) << '\n' << '\n' << str::rep('=', 80) << '\n' << '\n';
 						};
 					};
+				}
+				else if (!_isBookMove && _move)
+				{
+					// Only the best line is known without a tree
+					const auto _path = _dirPath / "line0.txt";
+					auto _file = std::ofstream(_path);
+
+					_file << "Final Rating : " << _move->rating() << '\n';
+					for (auto& v : _result.line_)
+					{
+						_file << v << '\n';
+					};
+					_file << '\n' << '\n';
+
+					auto b = _board;
+					for (auto& v : _result.line_)
+					{
+						b.move(v);
+						_file << v << '\n' << '\n';
+						_file << b << '\n' << '\n';
+						_file << get_fen(b) << '\n' << '\n' << str::rep('=', 80) << '\n' << '\n';
+					};
 				};
 			};
 		};
 
-		Response _resp{};
-		_resp.move = _move;
-		this->best_move_ = _resp;
+		return _move;
 	};
 
 
@@ -297,16 +468,48 @@ namespace sch
 	{
 		this->init_barrier_.arrive_and_wait();
 
-		// Storage for tracking calcultion times
 		while (!_stop.stop_requested())
 		{
+			auto lck = std::unique_lock(this->mtx_);
+			if (this->searched_request_ != this->move_request_)
 			{
-				const auto lck = std::unique_lock(this->mtx_);
-				if (!this->best_move_)
+				// Pick up the request. Everything the search reads is copied so the lock is only held again
+				// to publish the move, and the deadline is published for get_move() to wait on.
+				const auto _request = this->move_request_;
+				this->searched_request_ = _request;
+				this->search_board_ = this->board_;
+				this->search_history_ = this->history_;
+				if (this->hash_size_mb_)
+				{
+					// No search is running, nothing else is using the table
+					this->tt_.resize(*this->hash_size_mb_);
+					this->hash_size_mb_.reset();
+				};
+				this->search_stop_.reset();
+				this->time_manager_.start(this->clock_);
+				this->search_deadline_ = (this->time_manager_.is_limited()) ?
+					std::optional(this->time_manager_.deadline()) : std::nullopt;
+				const auto _threadCount = this->thread_count_;
+				const auto _searchDepth = this->search_depth_;
+				const auto _treeSearch = this->tree_search_;
+				const auto _loggingDir = this->logging_dir_;
+				this->best_move_cv_.notify_all();
+
+				lck.unlock();
+				const auto _move = this->calculate_next_move(_threadCount, _searchDepth, _treeSearch, _loggingDir);
+				lck.lock();
+
+				// Nobody is waiting for a move from a request that has been replaced
+				if (this->searched_request_ == this->move_request_)
 				{
-					this->calculate_next_move();
+					chess::Response _resp{};
+					_resp.move = _move;
+					this->best_move_ = _resp;
+					this->best_rated_move_ = _move;
+					this->best_move_cv_.notify_all();
 				};
 			};
+			lck.unlock();
 
 			std::this_thread::sleep_for(std::chrono::milliseconds(1));
 		};
@@ -326,13 +529,30 @@ namespace sch
 
 	void ScreepFish::set_search_depth(size_t _depth)
 	{
+		const auto lck = std::unique_lock(this->mtx_);
 		this->search_depth_ = _depth;
 	};
+	void ScreepFish::set_clock(std::optional<GameClock> _clock)
+	{
+		const auto lck = std::unique_lock(this->mtx_);
+		this->clock_ = _clock;
+	};
+	void ScreepFish::set_thread_count(size_t _threads)
+	{
+		const auto lck = std::unique_lock(this->mtx_);
+		this->thread_count_ = std::max<size_t>(_threads, 1);
+	};
+	void ScreepFish::set_hash_size(size_t _megabytes)
+	{
+		const auto lck = std::unique_lock(this->mtx_);
+		this->hash_size_mb_ = _megabytes;
+	};
 
 	ScreepFish::ScreepFish() :
 		init_barrier_(2),
 		rnd_(std::random_device{}()),
 		logging_dir_{},
+		tt_(default_hash_size_mb_v),
 		search_depth_{ 6 }
 	{
 		
@@ -5,8 +5,13 @@
 #include "chess/book.hpp"
 #include "chess/chess.hpp"
 #include "chess/move_tree.hpp"
+#include "chess/search.hpp"
+#include "chess/search_stop.hpp"
+
+#include "time_manager.hpp"
 
 #include <mutex>
+#include <condition_variable>
 #include <thread>
 #include <barrier>
 #include <variant> 
@@ -21,7 +26,33 @@ namespace sch
 	{
 	private:
 
-		chess::MoveTree build_move_tree(const chess::Board& _board, chess::Color _forPlayer, int _depth);
+		/**
+		 * @brief Builds and searches the whole tree for a board to a depth, the search used when tree_search_ is set.
+		 * @param _pool Threads to split the search between, or null to search on the calling thread only.
+		 * @return Searched tree.
+		*/
+		chess::MoveTree build_move_tree(const chess::Board& _board, chess::Color _forPlayer, int _depth,
+			chess::SearchStop& _stop, chess::SearchHeuristics& _heuristics, std::optional<chess::Rating> _expectedRating,
+			chess::WorkStealingPool* _pool);
+
+		/**
+		 * @brief Searches a board to a depth without building a tree, the search used unless tree_search_ is set.
+		 * @param _search Search to run, its settings are overwritten.
+		 * @return Best move and line found.
+		*/
+		chess::SearchResult search_position(const chess::Board& _board, int _depth, chess::Search& _search,
+			chess::SearchStop& _stop, chess::SearchHeuristics& _heuristics, std::optional<chess::Rating> _expectedRating);
+
+		/**
+		 * @brief Searches the board being searched on a helper thread until helper_stop_ is stopped, only used
+		 * when searching without trees.
+		 *
+		 * Helpers run their own iterative deepening and only share what they find through the
+		 * transposition table, their results are thrown away.
+		 *
+		 * @param _helperIndex Index of the helper, used to vary the depths it searches and its move ordering.
+		*/
+		void helper_search(size_t _helperIndex);
 		
 		void thread_main(std::stop_token _stop);
 
@@ -131,23 +162,82 @@ namespace sch
 		};
 
 		/**
-		 * @brief Calculates the next move, should be called when "best_move_" is null (empty).
+		 * @brief Calculates the next move for search_board_, run on the engine thread without holding mtx_.
+		 * @param _threadCount Threads to search with, one main thread plus helpers.
+		 * @param _searchDepth Depth to search to when there is no clock.
+		 * @param _treeSearch True to search with trees, see set_tree_search().
+		 * @param _loggingDir Directory to log the search to, if any.
+		 * @return Move to play, null if no move was found.
 		*/
-		void calculate_next_move();
+		std::optional<chess::RatedMove> calculate_next_move(size_t _threadCount, size_t _searchDepth,
+			bool _treeSearch, const std::optional<std::filesystem::path>& _loggingDir);
 
 	public:
 
 		void set_board(const chess::Board& _board) final;
 		chess::Response get_move() final;
 
+		/**
+		 * @brief Gets the move the last search picked along with its rating for the engine.
+		 * @return Rated move, null if no move was found.
+		*/
+		std::optional<chess::RatedMove> get_rated_move() const;
+
+		/**
+		 * @brief Sets the positions played before the current board, used to avoid or aim for repetitions.
+		 * @param _history Positions leading up to the board given to set_board().
+		*/
+		void set_history(const chess::PositionHistory& _history);
+
 		void start(chess::Board _initialBoard, chess::Color _color) final;
 		void stop() final;
 
 		void set_logging_dir(std::filesystem::path _path);
 
 
+		/**
+		 * @brief Sets the depth searched to when the engine has no clock.
+		 * @param _depth Search depth in plies.
+		*/
 		void set_search_depth(size_t _depth);
 
+		/**
+		 * @brief Sets the engine's clock for the next get_move() call, the engine will then search as deep as its time allows.
+		 * @param _clock Engine's clock, or nullopt to search to the fixed search depth.
+		*/
+		void set_clock(std::optional<GameClock> _clock);
+
+		/**
+		 * @brief Sets the number of threads to search with, one main thread plus helpers.
+		 * @param _threads Thread count, at least 1.
+		*/
+		void set_thread_count(size_t _threads);
+
+		/**
+		 * @brief Resizes the transposition table, clearing it.
+		 *
+		 * The table is only resized once the engine thread picks up the next move request, so a running
+		 * search never has its table pulled out from under it.
+		 *
+		 * @param _megabytes New table size.
+		*/
+		void set_hash_size(size_t _megabytes);
+
+		/**
+		 * @brief Builds the whole search tree in memory at each depth instead of searching with a fixed stack.
+		 *
+		 * Slower and its memory use grows with the depth searched, but every searched line is kept and
+		 * logged, which helps debugging and analysing the search. With more than one thread the single
+		 * tree is split between them instead of each thread building its own. Off by default.
+		 *
+		 * @param _enabled True to search with trees.
+		*/
+		void set_tree_search(bool _enabled)
+		{
+			const auto lck = std::unique_lock(this->mtx_);
+			this->tree_search_ = _enabled;
+		};
+
 		/**
 		 * @brief Sets the opening book for the engine to use.
 		 * @param _book Opening book.
@@ -168,16 +258,118 @@ namespace sch
 		chess::Board board_;
 		chess::Color my_color_;
 
+		/**
+		 * @brief Positions played before board_.
+		*/
+		chess::PositionHistory history_;
+
 		std::barrier<> init_barrier_;
 		mutable std::mutex mtx_;
 
+		/**
+		 * @brief Number of moves asked for by get_move(), the engine thread searches whenever it is behind.
+		*/
+		size_t move_request_ = 0;
+
+		/**
+		 * @brief Move request the engine thread last picked up, best_move_ is only set once it is answered.
+		*/
+		size_t searched_request_ = 0;
+
+		/**
+		 * @brief Point in time the picked up search will stop at, nullopt if it has no time limit.
+		*/
+		std::optional<TimeManager::clock::time_point> search_deadline_{};
+
 		std::optional<chess::Response> best_move_;
+
+		/**
+		 * @brief Move picked by the last search with its rating, set along with best_move_.
+		*/
+		std::optional<chess::RatedMove> best_rated_move_;
+
+		/**
+		 * @brief Notified when a move request is picked up and when best_move_ is set.
+		*/
+		std::condition_variable best_move_cv_;
+
 		std::optional<std::filesystem::path> logging_dir_{};
 
 		std::jthread thread_;
 
 		std::mt19937 rnd_;
 
+		/**
+		 * @brief Default transposition table size in megabytes.
+		*/
+		constexpr static size_t default_hash_size_mb_v = 64;
+
+		/**
+		 * @brief Transposition table kept for the whole game, cleared by start().
+		*/
+		chess::TranspositionTable tt_;
+
+		/**
+		 * @brief Size to resize tt_ to when the next move request is picked up, nullopt to keep its size.
+		*/
+		std::optional<size_t> hash_size_mb_{};
+
+		/**
+		 * @brief Time past the search's deadline that get_move() waits for it before giving up, only used with a clock.
+		 * Also how long get_move() waits for the engine thread to pick up its request.
+		*/
+		constexpr static auto move_wait_slack_v = std::chrono::seconds(1);
+
+		/**
+		 * @brief Deepest the engine will search when it has a clock.
+		*/
+		constexpr static size_t max_search_depth_v = 64;
+
+		/**
+		 * @brief Engine's clock for the next move, nullopt if the engine is not playing on a clock.
+		*/
+		std::optional<GameClock> clock_{};
+
+		/**
+		 * @brief Decides how many depths to search each move.
+		*/
+		TimeManager time_manager_;
+
+		/**
+		 * @brief Copy of board_ taken when the search started, only used by the engine thread and its helpers.
+		*/
+		chess::Board search_board_;
+
+		/**
+		 * @brief Copy of history_ taken when the search started, only used by the engine thread and its helpers.
+		*/
+		chess::PositionHistory search_history_;
+
+		/**
+		 * @brief Stops the running search once it runs out of time or the engine is stopped.
+		*/
+		chess::SearchStop search_stop_;
+
+		/**
+		 * @brief Stops the helper threads once the main search has picked its move.
+		*/
+		chess::SearchStop helper_stop_;
+
+		/**
+		 * @brief Depth the main thread is searching, helpers search this depth or deeper.
+		*/
+		std::atomic<size_t> main_depth_{ 0 };
+
+		/**
+		 * @brief Move ordering tables for the main thread, kept over the depths of a move.
+		*/
+		chess::SearchHeuristics heuristics_;
+
+		/**
+		 * @brief Main thread's search, reused for every depth and move so its stack is only allocated once.
+		*/
+		chess::Search search_;
+
 
 		/**
 		 * @brief The opening book to follow.
@@ -187,6 +379,8 @@ namespace sch
 
 		// Configuration settings
 		size_t search_depth_ = 5;
+		size_t thread_count_ = 1;
+		bool tree_search_ = false;
 	};
 
 };
\ No newline at end of file
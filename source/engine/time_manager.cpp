@@ -0,0 +1,91 @@
+#include "time_manager.hpp"
+
+#include <algorithm>
+
+namespace sch
+{
+	namespace
+	{
+		/**
+		 * @brief Time kept back on every move for the move to reach the server.
+		*/
+		constexpr auto move_overhead_v = std::chrono::milliseconds(100);
+
+		/**
+		 * @brief Number of moves the clock is shared between when the time control does not say.
+		*/
+		constexpr int default_moves_to_go_v = 30;
+
+		/**
+		 * @brief Drop in score, in pawns, between two depths that counts as the position getting worse.
+		*/
+		constexpr chess::Rating score_drop_v = 0.3f;
+	};
+
+	void TimeManager::start(std::optional<GameClock> _clock)
+	{
+		this->start(_clock, clock::now());
+	};
+	void TimeManager::start(std::optional<GameClock> _clock, clock::time_point _startTime)
+	{
+		namespace ch = std::chrono;
+
+		this->start_ = _startTime;
+		this->last_score_.reset();
+		this->stable_depths_ = 0;
+		this->limited_ = _clock.has_value();
+		if (!_clock)
+		{
+			return;
+		};
+
+		const auto _available = std::max(_clock->remaining_ - move_overhead_v, ch::milliseconds(0));
+		const auto _movesToGo = (_clock->moves_to_go_ > 0) ?
+			std::min(_clock->moves_to_go_, default_moves_to_go_v) : default_moves_to_go_v;
+
+		// Never plan to use more than a fraction of what is left, the increment only helps once the move is made
+		this->maximum_ = std::min(_available / 4 + _clock->increment_ / 2, _available * 3 / 4);
+		this->optimum_ = std::min(_available / _movesToGo + _clock->increment_ * 3 / 4, this->maximum_);
+	};
+
+	bool TimeManager::next_depth(bool _bestMoveChanged, chess::Rating _score)
+	{
+		if (_bestMoveChanged)
+		{
+			this->stable_depths_ = 0;
+		}
+		else
+		{
+			++this->stable_depths_;
+		};
+
+		const auto _scoreDropped = this->last_score_ && _score < *this->last_score_ - score_drop_v;
+		this->last_score_ = _score;
+
+		if (!this->limited_)
+		{
+			return true;
+		};
+
+		// A settled best move needs less time, an unsettled or worsening one more
+		auto _scale = 1.0;
+		if (_bestMoveChanged)
+		{
+			_scale *= 1.4;
+		}
+		else if (this->stable_depths_ >= 3)
+		{
+			_scale *= 0.6;
+		};
+		if (_scoreDropped)
+		{
+			_scale *= 1.5;
+		};
+
+		// The next depth takes several times as long as this one, only start it if it can likely finish
+		const auto _target = std::min(
+			std::chrono::duration_cast<std::chrono::milliseconds>(this->optimum_ * _scale),
+			this->maximum_);
+		return this->elapsed() * 2 < _target;
+	};
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+/** @file */
+
+#include "chess/rating.hpp"
+
+#include <chrono>
+#include <optional>
+
+namespace sch
+{
+	/**
+	 * @brief The engine's side of the game clock when it is asked for a move.
+	*/
+	struct GameClock
+	{
+		/**
+		 * @brief Time left on the engine's clock.
+		*/
+		std::chrono::milliseconds remaining_{ 0 };
+
+		/**
+		 * @brief Time added to the engine's clock after each move.
+		*/
+		std::chrono::milliseconds increment_{ 0 };
+
+		/**
+		 * @brief Moves until the next time control, 0 if the rest of the game must be played on this clock.
+		*/
+		int moves_to_go_ = 0;
+	};
+
+	/**
+	 * @brief Decides how long to think about a move when searching with iterative deepening.
+	 *
+	 * Each move gets an optimum time, a share of the clock plus most of the increment, and a maximum
+	 * time the search is never allowed to run past. After every completed depth the search asks if it
+	 * should go one deeper : it stops early once the best move has held for a few depths and gives
+	 * itself more time while the best move keeps changing or the score is falling.
+	*/
+	class TimeManager
+	{
+	public:
+
+		using clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Starts timing a move.
+		 * @param _clock Engine's clock, or nullopt to think without a time limit.
+		*/
+		void start(std::optional<GameClock> _clock);
+
+		/**
+		 * @brief Starts timing a move that began at a given point in time.
+		 * @param _clock Engine's clock, or nullopt to think without a time limit.
+		 * @param _startTime Point in time the move is timed from.
+		*/
+		void start(std::optional<GameClock> _clock, clock::time_point _startTime);
+
+		/**
+		 * @brief Checks if there is a time limit for the current move.
+		*/
+		bool is_limited() const noexcept
+		{
+			return this->limited_;
+		};
+
+		/**
+		 * @brief Gets the point in time the running search must be stopped at, only valid when limited.
+		*/
+		clock::time_point deadline() const noexcept
+		{
+			return this->start_ + this->maximum_;
+		};
+
+		/**
+		 * @brief Gets the time the current move is planned to take, only valid when limited.
+		*/
+		std::chrono::milliseconds optimum() const noexcept
+		{
+			return this->optimum_;
+		};
+
+		/**
+		 * @brief Gets the most time the current move may take, only valid when limited.
+		*/
+		std::chrono::milliseconds maximum() const noexcept
+		{
+			return this->maximum_;
+		};
+
+		/**
+		 * @brief Gets the time spent on the current move so far.
+		*/
+		std::chrono::milliseconds elapsed() const
+		{
+			return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - this->start_);
+		};
+
+		/**
+		 * @brief Records a completed depth and decides if the next one should be searched.
+		 * @param _bestMoveChanged True if this depth picked a different best move than the previous one.
+		 * @param _score Score of the best move for the engine.
+		 * @return True to search one depth deeper, false to play the best move now.
+		*/
+		bool next_depth(bool _bestMoveChanged, chess::Rating _score);
+
+	private:
+
+		clock::time_point start_{};
+		std::chrono::milliseconds optimum_{ 0 };
+		std::chrono::milliseconds maximum_{ 0 };
+
+		std::optional<chess::Rating> last_score_{};
+		int stable_depths_ = 0;
+		bool limited_ = false;
+	};
+};
@@ -8,6 +8,7 @@
 
 #include "chess/chess.hpp"
 #include "chess/fen.hpp"
+#include "chess/perft.hpp"
 
 #include "lichess/lichess.hpp"
 
@@ -21,6 +22,7 @@
 
 #include <array>
 #include <vector>
+#include <chrono>
 #include <utility>
 #include <iostream>
 #include <filesystem>
@@ -58,14 +60,24 @@ namespace sch
 			};
 
 			auto _board = this->initial_board_;
+			auto _history = chess::PositionHistory();
 			for (auto& _move : _moves)
 			{
+				_history.push(_board);
 				_board.move(_move);
 			};
 
+			this->engine_.set_history(_history);
 			this->engine_.set_board(_board);
 			if (this->my_color_ == _board.get_toplay())
 			{
+				// Lichess gives clock times in milliseconds
+				const bool _isWhite = *this->my_color_ == chess::Color::white;
+				auto _clock = sch::GameClock{};
+				_clock.remaining_ = std::chrono::milliseconds(_isWhite ? _event.wtime : _event.btime);
+				_clock.increment_ = std::chrono::milliseconds(_isWhite ? _event.winc : _event.binc);
+				this->engine_.set_clock(_clock);
+
 				const auto _response = this->engine_.get_move();
 				bool _passed = false;
 				if (_response.move)
@@ -176,6 +188,7 @@ namespace sch
 		{
 
 			this->engine_.set_search_depth(6);
+			this->engine_.set_thread_count(std::thread::hardware_concurrency());
 
 			this->proc_.set_callback(jc::functor(&GameStream::on_game_full, this));
 			this->proc_.set_callback(jc::functor(&GameStream::on_game_state, this));
@@ -502,8 +515,6 @@ namespace sch
 			chess::reset_board(_board);
 
 			auto _profile = chess::MoveTreeProfile();
-			_profile.follow_captures_ = false;
-			_profile.follow_checks_ = false;
 			_profile.enable_pruning_ = false;
 
 			auto _tree = chess::MoveTree(_board);
@@ -536,8 +547,6 @@ namespace sch
 			auto _board = *parse_fen(_fen);
 			auto _tree = MoveTree(_board);
 			auto _profile = MoveTreeProfile();
-			_profile.follow_captures_ = false;
-			_profile.follow_checks_ = false;
 			_profile.alphabeta_ = _alphaBetaPrune;
 			_tree.build_tree(4, 4, _profile);
 			auto _move = _tree.best_move();
@@ -563,8 +572,6 @@ namespace sch
 
 			auto _tree = chess::MoveTree(_board);
 			auto _profile = chess::MoveTreeProfile();
-			_profile.follow_captures_ = false;
-			_profile.follow_checks_ = false;
 			_profile.alphabeta_ = false;
 			_profile.enable_pruning_ = false;
 
@@ -636,7 +643,7 @@ namespace sch
 			size_t _bRooks = 0;
 			size_t _wRooks = 0;
 
-			for (auto& p : _board.pieces())
+			for (const auto p : _board.pieces())
 			{
 				if (p == Piece::rook)
 				{
@@ -925,8 +932,6 @@ namespace sch
 			{
 				auto _profile = MoveTreeProfile{};
 				_profile.enable_pruning_ = false;
-				_profile.follow_captures_ = false;
-				_profile.follow_checks_ = false;
 
 				const auto _searchData = MoveTreeSearchData();
 				auto t = MoveTree(b);
@@ -946,8 +951,6 @@ namespace sch
 			{
 				auto _profile = MoveTreeProfile{};
 				_profile.enable_pruning_ = false;
-				_profile.follow_captures_ = false;
-				_profile.follow_checks_ = false;
 				_profile.alphabeta_ = true;
 
 				const auto _searchData = MoveTreeSearchData();
@@ -969,8 +972,6 @@ namespace sch
 				const auto _searchData = MoveTreeSearchData();
 				auto t = MoveTree(b);
 				auto p = MoveTreeProfile();
-				p.follow_captures_ = false;
-				p.follow_checks_ = false;
 				p.enable_pruning_ = false;
 				p.alphabeta_ = false;
 				t.build_tree(3, 3, p);
@@ -989,8 +990,6 @@ namespace sch
 			{
 				auto _profile = MoveTreeProfile{};
 				_profile.enable_pruning_ = false;
-				_profile.follow_captures_ = false;
-				_profile.follow_checks_ = false;
 				_profile.alphabeta_ = true;
 
 				const auto _searchData = MoveTreeSearchData();
@@ -1012,8 +1011,6 @@ namespace sch
 				const auto _searchData = MoveTreeSearchData();
 				auto t = MoveTree(b);
 				auto p = MoveTreeProfile();
-				p.follow_captures_ = false;
-				p.follow_checks_ = false;
 				p.enable_pruning_ = false;
 				p.alphabeta_ = false;
 				t.build_tree(4, 4, p);
@@ -1137,55 +1134,27 @@ namespace sch
 	inline size_t count_final_positions_from_initial(const chess::Board& _board,
 		size_t _depth)
 	{
-		using namespace chess;
-		
-		auto _profile = chess::MoveTreeProfile();
-		_profile.follow_captures_ = false;
-		_profile.follow_captures_ = false;
-		_profile.alphabeta_ = false;
-
-		auto _tree = chess::MoveTree(_board);
-		_tree.build_tree(_depth, _depth, _profile);
-
-		return count_final_positions(_board, _tree.root());
+		auto _perftBoard = _board;
+		return chess::perft(_perftBoard, _depth);
 	};
 
 	inline std::vector<std::pair<chess::Move, size_t>>
 		count_final_positions_for_each_branch_from_initial(const chess::Board& _board, size_t _depth)
 	{
-		using namespace chess;
-
-		auto _profile = chess::MoveTreeProfile();
-		_profile.follow_captures_ = false;
-		_profile.follow_captures_ = false;
-		_profile.alphabeta_ = false;
-
-		auto _tree = chess::MoveTree(_board);
-		_tree.build_tree(_depth, _depth, _profile);
-
-		auto o = std::vector<std::pair<chess::Move, size_t>>{};
-		for (auto& _move : _tree.root())
-		{
-			auto _nextBoard = _board;
-			_nextBoard.move(_move.move_);
-			o.push_back({ _move.move_,
-				chess::count_final_positions(_nextBoard, _move)}
-			);
-		};
-
-		return o;
+		auto _perftBoard = _board;
+		return chess::perft_divide(_perftBoard, _depth);
 	};
 
-	inline auto make_tree_for(const chess::Board& _board, size_t _depth)
+	/**
+	 * @brief Logs the node count and speed of a perft run.
+	*/
+	inline void log_perft_speed(size_t _nodes, std::chrono::steady_clock::duration _elapsed)
 	{
-		auto _profile = chess::MoveTreeProfile();
-		_profile.follow_captures_ = false;
-		_profile.follow_captures_ = false;
-		_profile.alphabeta_ = false;
-
-		auto _tree = chess::MoveTree(_board);
-		_tree.build_tree(_depth + 2, _depth + 2, _profile);
-		return _tree;
+		const auto _seconds = std::chrono::duration<double>(_elapsed).count();
+		const auto _nodesPerSecond = (_seconds > 0.0) ? static_cast<size_t>(static_cast<double>(_nodes) / _seconds) : _nodes;
+		sch::log_info(str::concat_to_string(
+			"Nodes : ", _nodes, " Time : ", _seconds, "s Nodes/sec : ", _nodesPerSecond
+		));
 	};
 
 
@@ -1240,27 +1209,23 @@ namespace sch
 				return 1;
 			};
 
-			// Build tree
-			auto _tree = make_tree_for(*rfb0, _depth);
-			
+			// Follow the fens down from the initial board. Positions are counted <depth> + 2 plies from the initial
+			// board, so each fen found is a ply deeper and has one less ply left to count.
+			chess::Board _searchFromBoard{ *rfb0 };
 
-			chess::MoveTreeNode* _searchFrom = &_tree.root();
-			chess::Board _searchFromBoard{ _tree.initial_board() };
-
-			for (size_t n = 0; n != rfs.size(); ++n)
+			for (size_t n = 0; n != rfs.size() && n <= _depth + 1; ++n)
 			{
 				bool _found = false;
-				for (auto& _node : *_searchFrom)
+				for (const auto& _move : get_moves(_searchFromBoard, _searchFromBoard.get_toplay()))
 				{
 					auto b = _searchFromBoard;
-					b.move(_node.move_);
+					b.move(_move);
 
 					if (get_fen(b) == rfs[n])
 					{
 						std::cout <<
-							str::concat_to_string(_node.move_, " : \"", rfs[n], "\" : ", count_final_positions(b, _node)) <<
+							str::concat_to_string(_move, " : \"", rfs[n], "\" : ", count_final_positions_from_initial(b, _depth + 1 - n)) <<
 							'\n';
-						_searchFrom = &_node;
 						_searchFromBoard = b;
 						_found = true;
 						break;
@@ -1290,7 +1255,6 @@ namespace sch
 			));
 			return 1;
 		};
-		_depth += 2;
 
 		const auto _pFen = chess::parse_fen(_fenArg);
 		if (!_pFen)
@@ -1313,14 +1277,22 @@ namespace sch
 
 
 		auto _board = *_pFen;
-		auto _branches = count_final_positions_for_each_branch_from_initial(_board, _depth);
 
+		const auto _startTime = std::chrono::steady_clock::now();
+		// Each branch counts <depth> + 1 plies after its move
+		auto _branches = count_final_positions_for_each_branch_from_initial(_board, _depth + 1);
+		const auto _elapsed = std::chrono::steady_clock::now() - _startTime;
+
+		size_t _nodes = 0;
 		for (const auto& [_move, _outcomes] : _branches)
 		{
 			auto nb = _board;
 			nb.move(_move);
 			std::cout << _outcomes << '\n' << chess::get_fen(nb) << "\n\n";
+			_nodes += _outcomes;
 		};
+
+		log_perft_speed(_nodes, _elapsed);
 		return 0;
 	};
 
@@ -0,0 +1,68 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/move_tree.hpp"
+
+#include "utility/string.hpp"
+
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that searching the root from an aspiration window finds the same rating as an unbounded
+	 * search, however far off the expected rating is.
+	*/
+	class Test_Aspiration : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			using namespace chess;
+
+			auto _profile = MoveTreeProfile();
+			_profile.alphabeta_ = true;
+
+			auto _unbounded = MoveTree(this->board_);
+			_unbounded.build_tree(this->depth_, this->depth_, _profile);
+			const auto _expected = _unbounded.best_move();
+			if (!_expected)
+			{
+				return TestResult(this->name_, -1, "Search found no move");
+			};
+
+			// Spot on, far too low and far too high
+			for (const auto _guess : { _expected->rating(), _expected->rating() - 3.0f, _expected->rating() + 3.0f })
+			{
+				auto _tree = MoveTree(this->board_);
+				_tree.set_expected_rating(_guess);
+				_tree.build_tree(this->depth_, this->depth_, _profile);
+				const auto _move = _tree.best_move();
+				if (!_move || _move->rating() != _expected->rating())
+				{
+					return TestResult(this->name_, -1, str::concat_to_string("Expected rating ",
+						_expected->rating(), " from guess ", _guess, " got ", (_move) ? _move->rating() : 0.0f));
+				};
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_Aspiration(std::string_view _name, chess::Board _board, size_t _depth) :
+			name_(_name),
+			board_(_board),
+			depth_(_depth)
+		{};
+
+	private:
+		std::string name_;
+		chess::Board board_;
+		size_t depth_;
+	};
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/chess.hpp"
+#include "chess/move.hpp"
+
+#include <array>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that the attack maps updated by make() and unmake() match freshly synced ones
+	 * for every position reached within a number of plies.
+	*/
+	class Test_AttackMaps : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			auto _board = this->board_;
+			if (!this->walk(_board, this->depth_))
+			{
+				return TestResult(this->name_, -1, "Attack maps do not match\n fen = " + chess::get_fen(this->failed_));
+			};
+			return TestResult(this->name_);
+		};
+
+		Test_AttackMaps(std::string_view _name, chess::Board _board, size_t _depth) :
+			name_(_name), board_(_board), depth_(_depth)
+		{};
+
+	private:
+
+		bool matches(const chess::Board& _board) const
+		{
+			using namespace chess;
+
+			auto _synced = BoardPieceAttackData();
+			_synced.sync(_board);
+			const auto& _tracked = _board.get_extras().get<BoardPieceAttackData>();
+			for (const auto _player : colors_v)
+			{
+				for (const auto _pos : positions_v)
+				{
+					if (_synced.get_attacker_count(_player, _pos) != _tracked.get_attacker_count(_player, _pos))
+					{
+						return false;
+					};
+				};
+			};
+			return true;
+		};
+
+		bool walk(chess::Board& _board, size_t _depth)
+		{
+			if (!this->matches(_board))
+			{
+				this->failed_ = _board;
+				return false;
+			};
+			if (_depth == 0)
+			{
+				return true;
+			};
+
+			auto _data = std::array<chess::Move, chess::max_moves_possible_in_any_position_v>{};
+			auto _buffer = chess::MoveBuffer(_data);
+			chess::get_moves(_board, _board.get_toplay(), _buffer);
+			for (auto it = _data.data(); it != _buffer.head(); ++it)
+			{
+				const auto _undo = _board.make(*it);
+				const auto _ok = this->walk(_board, _depth - 1);
+				_board.unmake(*it, _undo);
+				if (!_ok)
+				{
+					return false;
+				};
+			};
+			return this->matches(_board);
+		};
+
+		std::string name_;
+		chess::Board board_;
+		chess::Board failed_;
+		size_t depth_;
+	};
+};
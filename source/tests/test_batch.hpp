@@ -0,0 +1,112 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/chess.hpp"
+#include "chess/move.hpp"
+#include "chess/batch.hpp"
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that batched move generation gives the same moves and move counts as the
+	 * regular generator for every position reached within a number of plies.
+	*/
+	class Test_BatchMoveGen : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			auto _board = this->board_;
+			if (!this->walk(_board, this->depth_))
+			{
+				return TestResult(this->name_, -1, "Batched moves do not match\n fen = " + chess::get_fen(this->failed_));
+			};
+			return TestResult(this->name_);
+		};
+
+		Test_BatchMoveGen(std::string_view _name, chess::Board _board, size_t _depth) :
+			name_(_name), board_(_board), depth_(_depth)
+		{};
+
+	private:
+
+		static std::vector<chess::Move> sorted(const chess::Move* _begin, const chess::Move* _end)
+		{
+			auto o = std::vector<chess::Move>(_begin, _end);
+			std::ranges::sort(o, [](chess::Move lhs, chess::Move rhs)
+			{
+				return lhs.to_bits() < rhs.to_bits();
+			});
+			return o;
+		};
+
+		bool walk(chess::Board& _board, size_t _depth)
+		{
+			auto _data = std::array<chess::Move, chess::max_moves_possible_in_any_position_v>{};
+			auto _buffer = chess::MoveBuffer(_data);
+			chess::get_moves(_board, _board.get_toplay(), _buffer);
+			const auto _moves = sorted(_data.data(), _buffer.head());
+
+			auto _batchData = std::array<chess::Move, chess::max_moves_possible_in_any_position_v>{};
+			auto _batchBuffer = chess::MoveBuffer(_batchData);
+			const auto _position = chess::BatchPosition(_board);
+			chess::get_legal_moves(_position, _batchBuffer);
+			if (sorted(_batchData.data(), _batchBuffer.head()) != _moves)
+			{
+				this->failed_ = _board;
+				return false;
+			};
+
+			// Count the replies to each move both ways
+			auto _batch = chess::BoardBatch();
+			auto _expected = std::vector<uint32_t>{};
+			for (const auto& _move : _moves)
+			{
+				_batch.push_back(_position.after(_move));
+				const auto _undo = _board.make(_move);
+				_expected.push_back(static_cast<uint32_t>(chess::get_moves(_board, _board.get_toplay()).size()));
+				_board.unmake(_move, _undo);
+			};
+
+			auto _counts = std::vector<uint32_t>(_batch.size());
+			_batch.count_legal_moves(_counts);
+			if (_counts != _expected)
+			{
+				this->failed_ = _board;
+				return false;
+			};
+
+			if (_depth <= 1)
+			{
+				return true;
+			};
+			for (const auto& _move : _moves)
+			{
+				const auto _undo = _board.make(_move);
+				const auto _ok = this->walk(_board, _depth - 1);
+				_board.unmake(_move, _undo);
+				if (!_ok)
+				{
+					return false;
+				};
+			};
+			return true;
+		};
+
+		std::string name_;
+		chess::Board board_;
+		chess::Board failed_;
+		size_t depth_;
+	};
+};
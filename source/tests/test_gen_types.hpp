@@ -0,0 +1,81 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/chess.hpp"
+#include "chess/move.hpp"
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that the captures and quiets generators split the full move list between them, and
+	 * that the captures and checks generators find the expected number of moves.
+	*/
+	class Test_GenTypes : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			using namespace chess;
+
+			const auto _all = this->generate(GenType::all);
+			const auto _captures = this->generate(GenType::captures);
+			const auto _quiets = this->generate(GenType::quiets);
+			const auto _checks = this->generate(GenType::checks);
+
+			const auto _fen = "\n fen = " + chess::get_fen(this->board_);
+
+			auto _combined = _captures;
+			_combined.insert(_combined.end(), _quiets.begin(), _quiets.end());
+			if (!std::ranges::is_permutation(_combined, _all))
+			{
+				return TestResult(this->name_, -1, "Captures and quiets do not match all moves" + _fen);
+			};
+
+			if (_captures.size() != this->captures_)
+			{
+				const auto s = "Expected " + std::to_string(this->captures_) +
+					" captures - got " + std::to_string(_captures.size()) + _fen;
+				return TestResult(this->name_, -1, s);
+			};
+			if (_checks.size() != this->checks_)
+			{
+				const auto s = "Expected " + std::to_string(this->checks_) +
+					" checks - got " + std::to_string(_checks.size()) + _fen;
+				return TestResult(this->name_, -1, s);
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_GenTypes(std::string_view _name, chess::Board _board, size_t _captures, size_t _checks) :
+			name_(_name), board_(_board),
+			captures_(_captures), checks_(_checks)
+		{};
+
+	private:
+
+		std::vector<chess::Move> generate(chess::GenType _type) const
+		{
+			auto _data = std::array<chess::Move, chess::max_moves_possible_in_any_position_v>{};
+			auto _buffer = chess::MoveBuffer(_data);
+			chess::get_moves(this->board_, this->board_.get_toplay(), _buffer, _type);
+			return std::vector<chess::Move>(_data.data(), _buffer.head());
+		};
+
+		std::string name_;
+		chess::Board board_;
+		size_t captures_;
+		size_t checks_;
+	};
+};
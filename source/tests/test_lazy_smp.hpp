@@ -0,0 +1,100 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "engine/engine.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/move.hpp"
+
+#include "utility/string.hpp"
+
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that the engine searching with Lazy SMP helpers plays a legal move rated like the one it finds on a single thread.
+	 *
+	 * Helpers search deeper than the main thread and share what they find through the transposition table, so
+	 * the rating only has to match what a single thread finds at the same depth or a few plies deeper.
+	*/
+	class Test_LazySMP : public ITest
+	{
+	public:
+
+		/**
+		 * @brief Most the ratings may differ by, in pawns.
+		*/
+		constexpr static chess::Rating max_rating_difference_v = 0.1f;
+
+		/**
+		 * @brief Plies past the searched depth the single threaded ratings are taken from.
+		*/
+		constexpr static size_t max_extra_depth_v = 3;
+
+		TestResult run() final
+		{
+			const auto _parallel = this->search(this->depth_, this->threads_);
+			if (!_parallel)
+			{
+				return TestResult(this->name_, -1, "Engine found no move");
+			};
+
+			const auto _moves = chess::get_moves(this->board_, this->board_.get_toplay());
+			if (std::ranges::find(_moves, static_cast<const chess::Move&>(*_parallel)) == _moves.end())
+			{
+				return TestResult(this->name_, -1, "Engine played an illegal move");
+			};
+
+			auto _expected = std::string();
+			for (size_t _depth = this->depth_; _depth <= this->depth_ + max_extra_depth_v; ++_depth)
+			{
+				const auto _serial = this->search(_depth, 1);
+				if (!_serial)
+				{
+					return TestResult(this->name_, -1, "Engine found no move on a single thread");
+				};
+				if (std::abs(_serial->rating() - _parallel->rating()) <= max_rating_difference_v)
+				{
+					return TestResult(this->name_);
+				};
+				_expected += str::concat_to_string(" ", _serial->rating());
+			};
+			return TestResult(this->name_, -1, str::concat_to_string("Expected a rating near one of",
+				_expected, " got ", _parallel->rating()));
+		};
+
+		Test_LazySMP(std::string_view _name, chess::Board _board, size_t _depth, size_t _threads) :
+			name_(_name),
+			board_(_board),
+			depth_(_depth),
+			threads_(_threads)
+		{};
+
+	private:
+
+		std::optional<chess::RatedMove> search(size_t _depth, size_t _threads) const
+		{
+			auto _engine = ScreepFish();
+			_engine.set_thread_count(_threads);
+			_engine.set_search_depth(_depth);
+			_engine.start(this->board_, this->board_.get_toplay());
+			_engine.get_move();
+			const auto _move = _engine.get_rated_move();
+			_engine.stop();
+			return _move;
+		};
+
+		std::string name_;
+		chess::Board board_;
+		size_t depth_;
+		size_t threads_;
+	};
+};
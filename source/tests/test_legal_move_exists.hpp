@@ -0,0 +1,76 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/chess.hpp"
+#include "chess/move.hpp"
+
+#include <array>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that has_any_legal_move() agrees with move generation for every position reached
+	 * within a number of plies.
+	*/
+	class Test_LegalMoveExists : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			auto _board = this->board_;
+			if (!this->walk(_board, this->depth_))
+			{
+				return TestResult(this->name_, -1, "has_any_legal_move does not match move generation\n fen = " + chess::get_fen(this->failed_));
+			};
+			return TestResult(this->name_);
+		};
+
+		Test_LegalMoveExists(std::string_view _name, chess::Board _board, size_t _depth) :
+			name_(_name), board_(_board), depth_(_depth)
+		{};
+
+	private:
+
+		bool walk(chess::Board& _board, size_t _depth)
+		{
+			auto _data = std::array<chess::Move, chess::max_moves_possible_in_any_position_v>{};
+			auto _buffer = chess::MoveBuffer(_data);
+			chess::get_moves(_board, _board.get_toplay(), _buffer);
+
+			const auto _hasMoves = _buffer.head() != _data.data();
+			if (chess::has_any_legal_move(_board, _board.get_toplay()) != _hasMoves)
+			{
+				this->failed_ = _board;
+				return false;
+			};
+			if (_depth == 0)
+			{
+				return true;
+			};
+
+			for (auto it = _data.data(); it != _buffer.head(); ++it)
+			{
+				const auto _undo = _board.make(*it);
+				const auto _ok = this->walk(_board, _depth - 1);
+				_board.unmake(*it, _undo);
+				if (!_ok)
+				{
+					return false;
+				};
+			};
+			return true;
+		};
+
+		std::string name_;
+		chess::Board board_;
+		chess::Board failed_;
+		size_t depth_;
+	};
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "utility/monotonic_arena.hpp"
+#include "utility/string.hpp"
+
+#include <array>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks the alignment, chunk reuse, byte counting and thread safety of MonotonicArena.
+	*/
+	class Test_MonotonicArena : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			constexpr auto chunk_size_v = MonotonicArena::chunk_size_v;
+
+			// The address after the prefix lands on the alignment
+			{
+				auto _arena = MonotonicArena();
+				for (size_t n = 0; n != 100; ++n)
+				{
+					const auto _address = reinterpret_cast<uintptr_t>(_arena.allocate(24 + n, 64, 16));
+					if ((_address + 16) % 64 != 0)
+					{
+						return TestResult(this->name_, -1, str::concat_to_string("Allocation ", n, " is not aligned after its prefix"));
+					};
+				};
+			};
+
+			// Allocations bigger than a chunk get one of their own
+			{
+				auto _arena = MonotonicArena();
+				_arena.allocate(64, 8);
+				const auto _big = _arena.allocate(chunk_size_v * 2, 64);
+				std::memset(_big, 0xAB, chunk_size_v * 2);
+				if (_arena.chunk_count() != 2)
+				{
+					return TestResult(this->name_, -1, str::concat_to_string("Expected 2 chunks after a big allocation, got ", _arena.chunk_count()));
+				};
+			};
+
+			// Resetting reuses the chunks and remembers the most ever used
+			{
+				auto _arena = MonotonicArena();
+				const auto _fill = [&_arena]()
+				{
+					for (size_t n = 0; n != 3 * chunk_size_v / 1024; ++n)
+					{
+						_arena.allocate(1000, 8);
+					};
+				};
+
+				_fill();
+				const auto _chunks = _arena.chunk_count();
+				const auto _used = _arena.bytes_used();
+				if (_chunks < 3 || _used < 3 * chunk_size_v / 1024 * 1000)
+				{
+					return TestResult(this->name_, -1, str::concat_to_string("Filling used ", _used, " bytes in ", _chunks, " chunks"));
+				};
+
+				_arena.reset();
+				if (_arena.bytes_used() != 0 || _arena.peak_bytes() != _used)
+				{
+					return TestResult(this->name_, -1, str::concat_to_string("After reset used ", _arena.bytes_used(),
+						" bytes with a peak of ", _arena.peak_bytes(), ", expected 0 and ", _used));
+				};
+
+				_fill();
+				if (_arena.chunk_count() != _chunks)
+				{
+					return TestResult(this->name_, -1, str::concat_to_string("Refilling grew the arena from ",
+						_chunks, " to ", _arena.chunk_count(), " chunks"));
+				};
+
+				_arena.reset();
+				_arena.allocate(100, 8);
+				if (_arena.peak_bytes() != _used)
+				{
+					return TestResult(this->name_, -1, str::concat_to_string("Peak is ", _arena.peak_bytes(), ", expected ", _used));
+				};
+			};
+
+			// Threads allocating at once never get overlapping memory
+			{
+				constexpr size_t thread_count_v = 4;
+				constexpr size_t allocation_count_v = 20000;
+
+				auto _arena = MonotonicArena();
+				auto _ranges = std::array<std::vector<std::pair<uintptr_t, size_t>>, thread_count_v>{};
+				{
+					auto _threads = std::vector<std::jthread>();
+					for (size_t t = 0; t != thread_count_v; ++t)
+					{
+						_threads.emplace_back([&_arena, &_ranges, t]()
+							{
+								for (size_t n = 0; n != allocation_count_v; ++n)
+								{
+									const auto _bytes = 8 + (n * 37 + t * 11) % 300;
+									const auto _mem = _arena.allocate(_bytes, 16);
+									std::memset(_mem, static_cast<int>(t + 1), _bytes);
+									_ranges[t].push_back({ reinterpret_cast<uintptr_t>(_mem), _bytes });
+								};
+							});
+					};
+				};
+
+				auto _all = std::vector<std::pair<uintptr_t, size_t>>();
+				for (size_t t = 0; t != thread_count_v; ++t)
+				{
+					for (const auto& _range : _ranges[t])
+					{
+						// Another thread writing into this range would have changed its bytes
+						const auto _mem = reinterpret_cast<const unsigned char*>(_range.first);
+						if (std::any_of(_mem, _mem + _range.second, [t](unsigned char v) { return v != t + 1; }))
+						{
+							return TestResult(this->name_, -1, "Memory handed to one thread was written by another");
+						};
+						_all.push_back(_range);
+					};
+				};
+
+				std::ranges::sort(_all);
+				for (size_t n = 1; n < _all.size(); ++n)
+				{
+					if (_all[n - 1].first + _all[n - 1].second > _all[n].first)
+					{
+						return TestResult(this->name_, -1, "Two allocations overlap");
+					};
+				};
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_MonotonicArena(std::string_view _name) :
+			name_(_name)
+		{};
+
+	private:
+		std::string name_;
+	};
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/chess.hpp"
+#include "chess/move.hpp"
+#include "chess/move_picker.hpp"
+
+#include <span>
+#include <array>
+#include <algorithm>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that is_legal() and the move picker agree with move generation for every position reached
+	 * within a number of plies.
+	 *
+	 * The moves of the previous position are used as hash moves and killers, these are often not legal in the
+	 * position they are tried in.
+	*/
+	class Test_MovePicker : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			auto _board = this->board_;
+			if (!this->walk(_board, this->depth_, {}))
+			{
+				return TestResult(this->name_, -1, this->failure_ + "\n fen = " + chess::get_fen(this->failed_));
+			};
+			return TestResult(this->name_);
+		};
+
+		Test_MovePicker(std::string_view _name, chess::Board _board, size_t _depth) :
+			name_(_name), board_(_board), depth_(_depth)
+		{};
+
+	private:
+
+		bool fail(const chess::Board& _board, std::string_view _failure)
+		{
+			this->failed_ = _board;
+			this->failure_ = _failure;
+			return false;
+		};
+
+		bool walk(chess::Board& _board, size_t _depth, std::span<const chess::Move> _previousMoves)
+		{
+			using namespace chess;
+
+			auto _data = std::array<Move, max_moves_possible_in_any_position_v>{};
+			auto _buffer = MoveBuffer(_data);
+			get_moves(_board, _board.get_toplay(), _buffer);
+			const auto _moves = std::span<const Move>(_data.data(), _buffer.head());
+
+			const auto _isGenerated = [&](Move _move)
+			{
+				return std::find(_moves.begin(), _moves.end(), _move) != _moves.end();
+			};
+			for (auto& _move : _moves)
+			{
+				if (!is_legal(_board, _move))
+				{
+					return this->fail(_board, "is_legal rejected a generated move");
+				};
+			};
+			for (auto& _move : _previousMoves)
+			{
+				if (is_legal(_board, _move) != _isGenerated(_move))
+				{
+					return this->fail(_board, "is_legal does not match move generation");
+				};
+			};
+
+			// Every legal move must come out of the picker exactly once
+			const auto _hashMove = (_previousMoves.empty()) ? Move() : _previousMoves.front();
+			auto _picker = MovePicker(_board, _hashMove, _previousMoves.subspan(std::min<size_t>(_previousMoves.size(), 1)));
+			auto _picked = std::array<Move, max_moves_possible_in_any_position_v>{};
+			size_t _pickedCount = 0;
+			for (auto _move = _picker.next(); _move; _move = _picker.next())
+			{
+				if (_pickedCount == _picked.size() || !_isGenerated(_move) ||
+					std::find(_picked.begin(), _picked.begin() + _pickedCount, _move) != _picked.begin() + _pickedCount)
+				{
+					return this->fail(_board, "Move picker handed out an illegal or repeated move");
+				};
+				_picked[_pickedCount++] = _move;
+			};
+			if (_pickedCount != _moves.size())
+			{
+				return this->fail(_board, "Move picker did not hand out every legal move");
+			};
+			if (_isGenerated(_hashMove) && _picked.front() != _hashMove)
+			{
+				return this->fail(_board, "Move picker did not hand out the hash move first");
+			};
+
+			if (_depth == 0)
+			{
+				return true;
+			};
+			for (auto& _move : _moves)
+			{
+				const auto _undo = _board.make(_move);
+				const auto _ok = this->walk(_board, _depth - 1, _moves);
+				_board.unmake(_move, _undo);
+				if (!_ok)
+				{
+					return false;
+				};
+			};
+			return true;
+		};
+
+		std::string name_;
+		std::string failure_;
+		chess::Board board_;
+		chess::Board failed_;
+		size_t depth_;
+	};
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/move_tree.hpp"
+#include "chess/work_pool.hpp"
+
+#include "utility/string.hpp"
+
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that splitting the alpha-beta search between threads finds the same best move rating as searching serially.
+	*/
+	class Test_ParallelSearch : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			using namespace chess;
+
+			auto _profile = MoveTreeProfile();
+			_profile.alphabeta_ = true;
+
+			auto _serial = MoveTree(this->board_);
+			_serial.build_tree(this->depth_, this->depth_, _profile);
+			const auto _serialMove = _serial.best_move();
+
+			auto _pool = WorkStealingPool(3);
+			auto _parallel = MoveTree(this->board_);
+			_parallel.set_work_pool(&_pool);
+			_parallel.build_tree(this->depth_, this->depth_, _profile);
+			const auto _parallelMove = _parallel.best_move();
+
+			if (!_serialMove || !_parallelMove)
+			{
+				return TestResult(this->name_, -1, "Search found no move");
+			};
+			if (_serialMove->rating() != _parallelMove->rating())
+			{
+				return TestResult(this->name_, -1, str::concat_to_string("Expected rating ",
+					_serialMove->rating(), " got ", _parallelMove->rating()));
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_ParallelSearch(std::string_view _name, chess::Board _board, size_t _depth) :
+			name_(_name),
+			board_(_board),
+			depth_(_depth)
+		{};
+
+	private:
+		std::string name_;
+		chess::Board board_;
+		size_t depth_;
+	};
+};
@@ -8,6 +8,7 @@
 #include "chess/chess.hpp"
 #include "chess/move.hpp"
 #include "chess/move_tree.hpp"
+#include "chess/perft.hpp"
 
 #include <vector>
 #include <string_view>
@@ -27,13 +28,26 @@ namespace sch
 			auto _profile = chess::MoveTreeProfile();
 			_profile.alphabeta_ = false;
 			_profile.enable_pruning_ = false;
-			_profile.follow_captures_ = false;
-			_profile.follow_checks_ = false;
 
 			auto _result = TestResult(this->name_);
 			
+			size_t _depth = 0;
 			for (auto& v : this->expected_)
 			{
+				++_depth;
+
+				// The tree free perft must agree with the tree
+				auto _perftBoard = this->board_;
+				if (const auto _perft = chess::perft(_perftBoard, _depth); _perft != v)
+				{
+					const auto s =
+						"Expected " + std::to_string(v) +
+						" positions - perft got " + std::to_string(_perft) +
+						"\n fen = " + chess::get_fen(this->board_) +
+						"\n depth = " + std::to_string(_depth);
+					return TestResult(this->name_, 1, s);
+				};
+
 				_tree.evaluate_next(_searchData, _profile);
 				const auto u = chess::count_final_positions(_tree.initial_board(), _tree.root());
 				if (u != v)
@@ -0,0 +1,63 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/move_tree.hpp"
+
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that the quiescence search sees a recapture the search depth cuts off.
+	*/
+	class Test_Quiescence : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			using namespace chess;
+
+			auto _profile = MoveTreeProfile();
+			_profile.alphabeta_ = true;
+
+			// Searched one ply deep, the queen taking a pawn defended by a pawn is the best move
+			// unless the leaf resolves the recapture
+			_profile.quiescence_ = false;
+			auto _static = MoveTree(this->board_);
+			_static.build_tree(2, 2, _profile);
+			const auto _staticMove = _static.best_move();
+			if (!_staticMove || static_cast<const Move&>(*_staticMove) != this->losing_capture_)
+			{
+				return TestResult(this->name_, -1, "Expected the static search to take the defended pawn");
+			};
+
+			_profile.quiescence_ = true;
+			auto _quiet = MoveTree(this->board_);
+			_quiet.build_tree(2, 2, _profile);
+			const auto _quietMove = _quiet.best_move();
+			if (!_quietMove || static_cast<const Move&>(*_quietMove) == this->losing_capture_)
+			{
+				return TestResult(this->name_, -1, "Quiescence search still took the defended pawn");
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_Quiescence(std::string_view _name, chess::Board _board, chess::Move _losingCapture) :
+			name_(_name),
+			board_(_board),
+			losing_capture_(_losingCapture)
+		{};
+
+	private:
+		std::string name_;
+		chess::Board board_;
+		chess::Move losing_capture_;
+	};
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/chess.hpp"
+#include "chess/history.hpp"
+
+#include <vector>
+#include <string>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Plays a line of moves and checks the repetition count of the final position.
+	*/
+	class Test_Repetition : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			auto _board = this->board_;
+			auto _history = chess::PositionHistory();
+			for (auto& _str : this->moves_)
+			{
+				const auto _move = chess::try_parse_move(_str);
+				if (!_move)
+				{
+					return TestResult(this->name_, -1, "Bad move string " + _str);
+				};
+				_history.push(_board);
+				_board.move(_move);
+			};
+
+			const auto _count = _history.count_repetitions(_board);
+			if (_count != this->repetitions_)
+			{
+				return TestResult(this->name_, -1,
+					"Expected " + std::to_string(this->repetitions_) + " repetitions, got " + std::to_string(_count) +
+					"\n fen = " + chess::get_fen(_board));
+			};
+			if (_history.is_repetition(_board) != (_count != 0))
+			{
+				return TestResult(this->name_, -1, "is_repetition does not match count_repetitions");
+			};
+			return TestResult(this->name_);
+		};
+
+		Test_Repetition(std::string_view _name, chess::Board _board, std::vector<std::string> _moves, size_t _repetitions) :
+			name_(_name), board_(_board), moves_(std::move(_moves)), repetitions_(_repetitions)
+		{};
+
+	private:
+		std::string name_;
+		chess::Board board_;
+		std::vector<std::string> moves_;
+		size_t repetitions_;
+	};
+};
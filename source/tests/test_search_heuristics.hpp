@@ -0,0 +1,105 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/move.hpp"
+#include "chess/move_picker.hpp"
+#include "chess/search_heuristics.hpp"
+
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that cutoffs update the killer, history and counter move tables and that the move picker uses them.
+	*/
+	class Test_SearchHeuristics : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			using namespace chess;
+
+			auto _heuristics = std::make_unique<SearchHeuristics>();
+			const auto _previous = Move(Position(File::e, Rank::r7), Position(File::e, Rank::r5));
+			const auto _first = Move(Position(File::g, Rank::r1), Position(File::f, Rank::r3));
+			const auto _second = Move(Position(File::b, Rank::r1), Position(File::c, Rank::r3));
+			const auto _tried = Move(Position(File::a, Rank::r2), Position(File::a, Rank::r3));
+
+			_heuristics->update_cutoff(Color::white, _first, 3, _previous, std::span(&_tried, 1), 4);
+			_heuristics->update_cutoff(Color::white, _second, 3, Move(), {}, 2);
+
+			// Newest killer first
+			const auto _killers = _heuristics->killers(3);
+			if (_killers[0] != _second || _killers[1] != _first)
+			{
+				return TestResult(this->name_, -1, "Killers were not stored newest first");
+			};
+			if (_heuristics->killers(4)[0])
+			{
+				return TestResult(this->name_, -1, "Killer leaked into another ply");
+			};
+
+			// Deeper cutoffs earn more history, moves tried before a cutoff lose some
+			if (!(_heuristics->history(Color::white, _first) > _heuristics->history(Color::white, _second) &&
+				_heuristics->history(Color::white, _tried) < 0 &&
+				_heuristics->history(Color::black, _first) == 0))
+			{
+				return TestResult(this->name_, -1, "History scores were not updated as expected");
+			};
+
+			if (_heuristics->counter_move(_previous) != _first)
+			{
+				return TestResult(this->name_, -1, "Counter move was not stored");
+			};
+
+			// With no killer for the ply the picker hands out quiets by history, best first
+			const auto _board = *parse_fen(standard_start_pos_fen_v);
+			auto _picker = MovePicker(_board, Move(), *_heuristics, 0, Move());
+			if (_picker.next() != _first)
+			{
+				return TestResult(this->name_, -1, "Move picker did not order quiets by history");
+			};
+
+			_heuristics->clear();
+			if (_heuristics->history(Color::white, _first) != 0 || _heuristics->killers(3)[0])
+			{
+				return TestResult(this->name_, -1, "Tables survived clear()");
+			};
+
+			// Seeded tables start from small random history scores that depend on the seed
+			_heuristics->update_cutoff(Color::white, _first, 3, _previous, {}, 4);
+			_heuristics->seed(1);
+			auto _seeded = std::make_unique<SearchHeuristics>();
+			_seeded->seed(2);
+			bool _differs = false;
+			for (const auto _move : get_moves(_board, Color::white))
+			{
+				const auto _score = _heuristics->history(Color::white, _move);
+				if (_score < -SearchHeuristics::max_seed_history_v || _score > SearchHeuristics::max_seed_history_v)
+				{
+					return TestResult(this->name_, -1, "Seeded history score out of range");
+				};
+				_differs = _differs || _score != _seeded->history(Color::white, _move);
+			};
+			if (!_differs || _heuristics->killers(3)[0] || _heuristics->counter_move(_previous))
+			{
+				return TestResult(this->name_, -1, "seed() did not reset the tables to seeded scores");
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_SearchHeuristics(std::string_view _name) :
+			name_(_name)
+		{};
+
+	private:
+		std::string name_;
+	};
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/move_tree.hpp"
+
+#include "utility/string.hpp"
+
+#include <limits>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that a search with each selective search technique enabled still finds a forced mate.
+	*/
+	class Test_SelectiveSearch : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			using namespace chess;
+
+			for (int _techniques = 1; _techniques != 8; ++_techniques)
+			{
+				auto _profile = MoveTreeProfile();
+				_profile.alphabeta_ = true;
+				_profile.enable_pruning_ = true;
+				_profile.null_move_pruning_ = (_techniques & 1) != 0;
+				_profile.late_move_reductions_ = (_techniques & 2) != 0;
+				_profile.futility_pruning_ = (_techniques & 4) != 0;
+
+				auto _tree = MoveTree(this->board_);
+				_tree.build_tree(this->depth_, this->depth_, _profile);
+				const auto _move = _tree.best_move();
+				if (!_move || _move->rating() != std::numeric_limits<Rating>::infinity())
+				{
+					return TestResult(this->name_, -1, str::concat_to_string("Missed the mate with techniques ",
+						_techniques, ", got rating ", (_move) ? _move->rating() : 0.0f));
+				};
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_SelectiveSearch(std::string_view _name, chess::Board _board, size_t _depth) :
+			name_(_name),
+			board_(_board),
+			depth_(_depth)
+		{};
+
+	private:
+		std::string name_;
+		chess::Board board_;
+		size_t depth_;
+	};
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/search.hpp"
+#include "chess/move_tree.hpp"
+
+#include "utility/string.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that the stack based search rates a position the same as a move tree searched to the same
+	 * depth, with and without selective search, and that its best line can be played out.
+	*/
+	class Test_StackSearch : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			using namespace chess;
+
+			for (const bool _pruning : { false, true })
+			{
+				auto _profile = MoveTreeProfile();
+				_profile.alphabeta_ = true;
+				_profile.enable_pruning_ = _pruning;
+
+				auto _tree = MoveTree(this->board_);
+				_tree.build_tree(this->depth_, this->depth_, _profile);
+				const auto _expected = _tree.best_move();
+
+				auto _search = Search();
+				const auto _result = _search.run(this->board_, this->depth_, _profile);
+				if (!_expected || !_result.best_move_)
+				{
+					return TestResult(this->name_, -1, "Search found no move");
+				};
+				if (_result.best_move_->rating() != _expected->rating())
+				{
+					return TestResult(this->name_, -1, str::concat_to_string("Expected rating ",
+						_expected->rating(), " got ", _result.best_move_->rating(), (_pruning) ? " with pruning" : ""));
+				};
+
+				if (_result.line_.empty() || _result.line_.front() != static_cast<const Move&>(*_result.best_move_))
+				{
+					return TestResult(this->name_, -1, "Best line does not start with the best move");
+				};
+				auto _board = this->board_;
+				for (const auto& _move : _result.line_)
+				{
+					const auto _legal = get_moves(_board, _board.get_toplay());
+					if (std::ranges::find(_legal, _move) == _legal.end())
+					{
+						return TestResult(this->name_, -1, str::concat_to_string("Illegal move in best line ", _move));
+					};
+					_board.move(_move);
+				};
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_StackSearch(std::string_view _name, chess::Board _board, size_t _depth) :
+			name_(_name),
+			board_(_board),
+			depth_(_depth)
+		{};
+
+	private:
+		std::string name_;
+		chess::Board board_;
+		size_t depth_;
+	};
+};
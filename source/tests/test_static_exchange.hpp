@@ -0,0 +1,47 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/move.hpp"
+
+#include "utility/string.hpp"
+
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks the material static exchange evaluation finds a move wins.
+	*/
+	class Test_StaticExchange : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			const auto _value = chess::static_exchange(this->board_, this->move_);
+			if (_value != this->expected_)
+			{
+				return TestResult(this->name_, -1, str::concat_to_string("Expected ", this->expected_, " got ", _value));
+			};
+			return TestResult(this->name_);
+		};
+
+		Test_StaticExchange(std::string_view _name, chess::Board _board, chess::Move _move, chess::Rating _expected) :
+			name_(_name),
+			board_(_board),
+			move_(_move),
+			expected_(_expected)
+		{};
+
+	private:
+		std::string name_;
+		chess::Board board_;
+		chess::Move move_;
+		chess::Rating expected_;
+	};
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "engine/time_manager.hpp"
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks the time a TimeManager plans for a move and when it decides to stop deepening.
+	*/
+	class Test_TimeManager : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			using std::chrono::milliseconds;
+
+			auto _tm = TimeManager();
+
+			// No clock, always go deeper
+			_tm.start(std::nullopt);
+			if (_tm.is_limited() || !_tm.next_depth(false, 0.0f) || !_tm.next_depth(false, 0.0f))
+			{
+				return TestResult(this->name_, -1, "Search without a clock was limited");
+			};
+
+			// The clock less the move overhead is shared between the moves to go, and at most a quarter of it is used
+			_tm.start(GameClock{ milliseconds(60100), milliseconds(0), 0 });
+			if (!_tm.is_limited() || _tm.optimum() != milliseconds(2000) || _tm.maximum() != milliseconds(15000))
+			{
+				return TestResult(this->name_, -1, "Wrong time planned without an increment" + this->times(_tm));
+			};
+			if (_tm.deadline() > TimeManager::clock::now() + _tm.maximum())
+			{
+				return TestResult(this->name_, -1, "Deadline is later than the maximum time");
+			};
+
+			// Most of the increment is spent as well
+			_tm.start(GameClock{ milliseconds(60100), milliseconds(2000), 10 });
+			if (_tm.optimum() != milliseconds(7500) || _tm.maximum() != milliseconds(16000))
+			{
+				return TestResult(this->name_, -1, "Wrong time planned with an increment" + this->times(_tm));
+			};
+
+			// A big increment cannot push the move past what is left on the clock
+			_tm.start(GameClock{ milliseconds(1100), milliseconds(10000), 0 });
+			if (_tm.optimum() != milliseconds(750) || _tm.maximum() != milliseconds(750))
+			{
+				return TestResult(this->name_, -1, "Increment was spent before it was added" + this->times(_tm));
+			};
+
+			// Nothing left after the move overhead, play the first move found
+			_tm.start(GameClock{ milliseconds(50), milliseconds(0), 0 });
+			if (_tm.maximum() != milliseconds(0) || _tm.next_depth(true, 0.0f))
+			{
+				return TestResult(this->name_, -1, "Went deeper with no time left" + this->times(_tm));
+			};
+
+			// A 1s optimum, past half of it another depth is only started while the move is unsettled
+			_tm.start(GameClock{ milliseconds(30100), milliseconds(0), 0 });
+			if (!_tm.next_depth(true, 0.0f))
+			{
+				return TestResult(this->name_, -1, "Stopped deepening straight away" + this->times(_tm));
+			};
+
+			// Timed as if the move started 600ms ago, so the checks below do not depend on how long a sleep takes
+			_tm.start(GameClock{ milliseconds(30100), milliseconds(0), 0 }, TimeManager::clock::now() - milliseconds(600));
+			if (!_tm.next_depth(true, 0.0f))
+			{
+				return TestResult(this->name_, -1, "Stopped deepening while the best move was changing" + this->times(_tm));
+			};
+			if (_tm.next_depth(false, 0.0f))
+			{
+				return TestResult(this->name_, -1, "Kept deepening on a settled best move" + this->times(_tm));
+			};
+			if (!_tm.next_depth(false, -1.0f))
+			{
+				return TestResult(this->name_, -1, "Stopped deepening while the score was falling" + this->times(_tm));
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_TimeManager(std::string_view _name) :
+			name_(_name)
+		{};
+
+	private:
+
+		std::string times(const TimeManager& _tm) const
+		{
+			return "\n optimum = " + std::to_string(_tm.optimum().count()) + "ms" +
+				"\n maximum = " + std::to_string(_tm.maximum().count()) + "ms" +
+				"\n elapsed = " + std::to_string(_tm.elapsed().count()) + "ms";
+		};
+
+		std::string name_;
+	};
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/transposition.hpp"
+
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks storing, probing and replacing transposition table entries.
+	*/
+	class Test_TranspositionTable : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			using namespace chess;
+
+			auto _tt = TranspositionTable(1);
+			const auto _move = Move(Position(File::e, Rank::r2), Position(File::e, Rank::r4));
+
+			// Round trip
+			_tt.store(0x1234'5678'9abc'def0, _move, -1.5f, 6, Bound::lower);
+			const auto _entry = _tt.probe(0x1234'5678'9abc'def0);
+			if (!_entry || _entry->move_ != _move || _entry->score_ != -1.5f ||
+				_entry->depth_ != 6 || _entry->bound_ != Bound::lower)
+			{
+				return TestResult(this->name_, -1, "Stored entry did not read back the same");
+			};
+
+			// Same bucket, different key
+			if (_tt.probe(0x1234'5678'9abc'def0 ^ (uint64_t(1) << 63)))
+			{
+				return TestResult(this->name_, -1, "Probe matched a key that was never stored");
+			};
+
+			// A shallower result does not replace a much deeper one from the same search
+			_tt.store(0x1234'5678'9abc'def0, Move(), 0.5f, 2, Bound::upper);
+			if (const auto _kept = _tt.probe(0x1234'5678'9abc'def0); !_kept || _kept->depth_ != 6)
+			{
+				return TestResult(this->name_, -1, "Deeper entry was replaced by a shallower one");
+			};
+
+			// An exact result does, and keeps the stored move when given none
+			_tt.store(0x1234'5678'9abc'def0, Move(), 0.5f, 2, Bound::exact);
+			if (const auto _exact = _tt.probe(0x1234'5678'9abc'def0); !_exact || _exact->bound_ != Bound::exact || _exact->move_ != _move)
+			{
+				return TestResult(this->name_, -1, "Exact entry did not replace the old one or lost its move");
+			};
+
+			// Filling a bucket past its size keeps the newest entry
+			for (uint64_t n = 1; n != 9; ++n)
+			{
+				_tt.new_search();
+				_tt.store(n << 32, _move, 0.0f, 1, Bound::exact);
+			};
+			if (!_tt.probe(uint64_t(8) << 32))
+			{
+				return TestResult(this->name_, -1, "Newest entry was not stored");
+			};
+
+			_tt.clear();
+			if (_tt.probe(uint64_t(8) << 32))
+			{
+				return TestResult(this->name_, -1, "Entry survived clear()");
+			};
+
+			return TestResult(this->name_);
+		};
+
+		Test_TranspositionTable(std::string_view _name) :
+			name_(_name)
+		{};
+
+	private:
+		std::string name_;
+	};
+};
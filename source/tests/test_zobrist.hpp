@@ -0,0 +1,129 @@
+#pragma once
+
+/** @file */
+
+#include "test_base.hpp"
+
+#include "chess/fen.hpp"
+#include "chess/chess.hpp"
+#include "chess/move.hpp"
+
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+
+
+namespace sch
+{
+	/**
+	 * @brief Checks that the hash updated by make() and unmake() matches a freshly computed one
+	 * for every position reached within a number of plies.
+	*/
+	class Test_ZobristHash : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			auto _board = this->board_;
+			if (!this->walk(_board, this->depth_))
+			{
+				return TestResult(this->name_, -1, "Zobrist hash does not match\n fen = " + chess::get_fen(this->failed_));
+			};
+			return TestResult(this->name_);
+		};
+
+		Test_ZobristHash(std::string_view _name, chess::Board _board, size_t _depth) :
+			name_(_name), board_(_board), depth_(_depth)
+		{};
+
+	private:
+
+		bool walk(chess::Board& _board, size_t _depth)
+		{
+			const auto _hash = _board.get_hash();
+			if (_hash != chess::compute_hash(_board))
+			{
+				this->failed_ = _board;
+				return false;
+			};
+			if (_depth == 0)
+			{
+				return true;
+			};
+
+			auto _data = std::array<chess::Move, chess::max_moves_possible_in_any_position_v>{};
+			auto _buffer = chess::MoveBuffer(_data);
+			chess::get_moves(_board, _board.get_toplay(), _buffer);
+			for (auto it = _data.data(); it != _buffer.head(); ++it)
+			{
+				const auto _undo = _board.make(*it);
+				const auto _ok = this->walk(_board, _depth - 1);
+				_board.unmake(*it, _undo);
+				if (!_ok)
+				{
+					return false;
+				};
+			};
+
+			if (_board.get_hash() != _hash)
+			{
+				this->failed_ = _board;
+				return false;
+			};
+			return true;
+		};
+
+		std::string name_;
+		chess::Board board_;
+		chess::Board failed_;
+		size_t depth_;
+	};
+
+	/**
+	 * @brief Plays two lines of moves reaching the same position and checks that both end on the same hash.
+	*/
+	class Test_ZobristTransposition : public ITest
+	{
+	public:
+
+		TestResult run() final
+		{
+			auto _boards = std::array<chess::Board, 2>{ this->board_, this->board_ };
+			for (size_t n = 0; n != _boards.size(); ++n)
+			{
+				for (auto& _str : this->lines_[n])
+				{
+					const auto _move = chess::try_parse_move(_str);
+					if (!_move)
+					{
+						return TestResult(this->name_, -1, "Bad move string " + _str);
+					};
+					_boards[n].move(_move);
+				};
+				if (_boards[n].get_hash() != chess::compute_hash(_boards[n]))
+				{
+					return TestResult(this->name_, -1, "Zobrist hash does not match\n fen = " + chess::get_fen(_boards[n]));
+				};
+			};
+
+			if (_boards[0].get_hash() != _boards[1].get_hash())
+			{
+				return TestResult(this->name_, -1, "Transposed positions have different hashes\n fen = " +
+					chess::get_fen(_boards[0]) + "\n fen = " + chess::get_fen(_boards[1]));
+			};
+			return TestResult(this->name_);
+		};
+
+		Test_ZobristTransposition(std::string_view _name, chess::Board _board,
+			std::vector<std::string> _first, std::vector<std::string> _second) :
+			name_(_name), board_(_board), lines_{ std::move(_first), std::move(_second) }
+		{};
+
+	private:
+		std::string name_;
+		chess::Board board_;
+		std::array<std::vector<std::string>, 2> lines_;
+	};
+};
@@ -1,9 +1,27 @@
 #include "tests.hpp"
 
 #include "test_base.hpp"
+#include "test_attack_maps.hpp"
+#include "test_batch.hpp"
 #include "test_book.hpp"
 #include "test_castling.hpp"
+#include "test_gen_types.hpp"
+#include "test_lazy_smp.hpp"
+#include "test_legal_move_exists.hpp"
+#include "test_monotonic_arena.hpp"
+#include "test_move_picker.hpp"
+#include "test_parallel_search.hpp"
 #include "test_position_count.hpp"
+#include "test_quiescence.hpp"
+#include "test_repetition.hpp"
+#include "test_search_heuristics.hpp"
+#include "test_aspiration.hpp"
+#include "test_selective_search.hpp"
+#include "test_stack_search.hpp"
+#include "test_static_exchange.hpp"
+#include "test_time_manager.hpp"
+#include "test_transposition.hpp"
+#include "test_zobrist.hpp"
 
 
 #include "chess/fen.hpp"
@@ -58,6 +76,18 @@ namespace sch
 			*chess::parse_fen("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"),
 			std::vector<size_t>{ 44, 1486, 62'379 }
 		));
+		_tests.push_back(jc::make_unique<Test_PositionCount>
+		(
+			std::string_view("Position Count - Enpassant Discovered Check"),
+			*chess::parse_fen("3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1"),
+			std::vector<size_t>{ 18, 92, 1'670, 10'138 }
+		));
+		_tests.push_back(jc::make_unique<Test_PositionCount>
+		(
+			std::string_view("Position Count - Rook Captures Rook"),
+			*chess::parse_fen("r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1"),
+			std::vector<size_t>{ 26, 1'141, 27'826, 1'274'206 }
+		));
 
 		// Castling
 		_tests.push_back(jc::make_unique<Test_Castling>
@@ -85,6 +115,283 @@ namespace sch
 			false, false, false, false
 		));
 
+		// Move generation kinds
+		_tests.push_back(jc::make_unique<Test_GenTypes>
+		(
+			std::string_view("Gen Types - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			8, 0
+		));
+		_tests.push_back(jc::make_unique<Test_GenTypes>
+		(
+			std::string_view("Gen Types - Rook Endgame"),
+			*chess::parse_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+			1, 2
+		));
+		_tests.push_back(jc::make_unique<Test_GenTypes>
+		(
+			std::string_view("Gen Types - Promotions"),
+			*chess::parse_fen("n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1"),
+			6, 3
+		));
+
+		// Incremental attack maps
+		_tests.push_back(jc::make_unique<Test_AttackMaps>
+		(
+			std::string_view("Attack Maps - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			3
+		));
+		_tests.push_back(jc::make_unique<Test_AttackMaps>
+		(
+			std::string_view("Attack Maps - Promotions"),
+			*chess::parse_fen("n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1"),
+			3
+		));
+
+		// Batched move generation
+		_tests.push_back(jc::make_unique<Test_BatchMoveGen>
+		(
+			std::string_view("Batch Move Gen - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			2
+		));
+		_tests.push_back(jc::make_unique<Test_BatchMoveGen>
+		(
+			std::string_view("Batch Move Gen - Pins and En Passant"),
+			*chess::parse_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+			3
+		));
+
+		// Incremental zobrist hashing
+		_tests.push_back(jc::make_unique<Test_ZobristHash>
+		(
+			std::string_view("Zobrist Hash - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			3
+		));
+		_tests.push_back(jc::make_unique<Test_ZobristHash>
+		(
+			std::string_view("Zobrist Hash - En Passant"),
+			*chess::parse_fen("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"),
+			3
+		));
+		_tests.push_back(jc::make_unique<Test_ZobristHash>
+		(
+			std::string_view("Zobrist Hash - Discovered Check"),
+			*chess::parse_fen("8/8/8/7k/5p2/8/4P3/K2B4 w - - 0 1"),
+			4
+		));
+		_tests.push_back(jc::make_unique<Test_ZobristTransposition>
+		(
+			std::string_view("Zobrist Transposition - Double Push"),
+			*chess::parse_fen(chess::standard_start_pos_fen_v),
+			std::vector<std::string>{ "g1f3", "b8c6", "f3g1", "c6b8", "g1f3", "b8c6", "f3g1", "c6b8", "e2e4" },
+			std::vector<std::string>{ "e2e3", "b8c6", "f1d3", "c6b8", "d3e2", "b8c6", "e2f1", "c6b8", "e3e4" }
+		));
+		_tests.push_back(jc::make_unique<Test_ZobristTransposition>
+		(
+			std::string_view("Zobrist Transposition - Pinned En Passant"),
+			*chess::parse_fen("8/8/8/8/R4p1k/8/4P3/4K3 w - - 0 1"),
+			std::vector<std::string>{ "a4a2", "h4h5", "a2a3", "h5g5", "a3a4", "g5h4", "e2e4" },
+			std::vector<std::string>{ "e2e3", "h4h5", "a4a3", "h5g5", "a3a4", "g5h4", "e3e4" }
+		));
+		_tests.push_back(jc::make_unique<Test_ZobristTransposition>
+		(
+			std::string_view("Zobrist Transposition - Discovered Check"),
+			*chess::parse_fen("8/8/8/7k/5p2/8/4P3/K2B4 w - - 0 1"),
+			std::vector<std::string>{ "a1b1", "h5h6", "b1a1", "h6h5", "e2e4" },
+			std::vector<std::string>{ "d1c2", "h5h6", "e2e4", "h6h5", "c2d1" }
+		));
+
+		// Legal move existence
+		_tests.push_back(jc::make_unique<Test_LegalMoveExists>
+		(
+			std::string_view("Legal Move Exists - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			3
+		));
+		_tests.push_back(jc::make_unique<Test_LegalMoveExists>
+		(
+			std::string_view("Legal Move Exists - Rook Endgame"),
+			*chess::parse_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+			4
+		));
+		_tests.push_back(jc::make_unique<Test_LegalMoveExists>
+		(
+			std::string_view("Legal Move Exists - Mates and Stalemates"),
+			*chess::parse_fen("7k/5Q2/5K2/8/8/8/8/8 w - - 0 1"),
+			3
+		));
+		_tests.push_back(jc::make_unique<Test_LegalMoveExists>
+		(
+			std::string_view("Legal Move Exists - En Passant"),
+			*chess::parse_fen("8/8/8/8/k2Pp3/8/8/2R1K3 b - d3 0 1"),
+			2
+		));
+
+		// Staged move picking
+		_tests.push_back(jc::make_unique<Test_MovePicker>
+		(
+			std::string_view("Move Picker - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			2
+		));
+		_tests.push_back(jc::make_unique<Test_MovePicker>
+		(
+			std::string_view("Move Picker - Rook Endgame"),
+			*chess::parse_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+			3
+		));
+		_tests.push_back(jc::make_unique<Test_MovePicker>
+		(
+			std::string_view("Move Picker - Promotions"),
+			*chess::parse_fen("n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1"),
+			3
+		));
+		_tests.push_back(jc::make_unique<Test_MovePicker>
+		(
+			std::string_view("Move Picker - En Passant"),
+			*chess::parse_fen("8/8/8/8/k2Pp3/8/8/2R1K3 b - d3 0 1"),
+			2
+		));
+
+		// Repetition detection
+		_tests.push_back(jc::make_unique<Test_Repetition>
+		(
+			std::string_view("Repetition - Knight Shuffle"),
+			*chess::parse_fen(chess::standard_start_pos_fen_v),
+			std::vector<std::string>{ "g1f3", "g8f6", "f3g1", "f6g8", "g1f3", "g8f6", "f3g1", "f6g8" },
+			2
+		));
+		_tests.push_back(jc::make_unique<Test_Repetition>
+		(
+			std::string_view("Repetition - After Pawn Move"),
+			*chess::parse_fen(chess::standard_start_pos_fen_v),
+			std::vector<std::string>{ "g1f3", "g8f6", "f3g1", "f6g8", "e2e4", "g8f6", "g1f3", "f6g8", "f3g1" },
+			1
+		));
+
+		// Transposition table
+		_tests.push_back(jc::make_unique<Test_TranspositionTable>
+		(
+			std::string_view("Transposition Table")
+		));
+
+		// Search memory
+		_tests.push_back(jc::make_unique<Test_MonotonicArena>
+		(
+			std::string_view("Monotonic Arena")
+		));
+
+		// Time management
+		_tests.push_back(jc::make_unique<Test_TimeManager>
+		(
+			std::string_view("Time Manager")
+		));
+
+		// Move ordering tables
+		_tests.push_back(jc::make_unique<Test_SearchHeuristics>
+		(
+			std::string_view("Search Heuristics")
+		));
+
+		// Quiescence search
+		_tests.push_back(jc::make_unique<Test_Quiescence>
+		(
+			std::string_view("Quiescence - Defended Pawn"),
+			*chess::parse_fen("4k3/8/2p5/3p4/8/8/3Q4/4K3 w - - 0 1"),
+			chess::Move(chess::Position(chess::File::d, chess::Rank::r2), chess::Position(chess::File::d, chess::Rank::r5))
+		));
+
+		// Static exchange evaluation
+		_tests.push_back(jc::make_unique<Test_StaticExchange>
+		(
+			std::string_view("Static Exchange - Undefended Pawn"),
+			*chess::parse_fen("4k3/8/8/3p4/8/8/8/3RK3 w - - 0 1"),
+			chess::Move(chess::Position(chess::File::d, chess::Rank::r1), chess::Position(chess::File::d, chess::Rank::r5)),
+			1.0f
+		));
+		_tests.push_back(jc::make_unique<Test_StaticExchange>
+		(
+			std::string_view("Static Exchange - Pawn Defended by Pawn"),
+			*chess::parse_fen("4k3/8/2p5/3p4/8/8/8/3RK3 w - - 0 1"),
+			chess::Move(chess::Position(chess::File::d, chess::Rank::r1), chess::Position(chess::File::d, chess::Rank::r5)),
+			-4.0f
+		));
+		_tests.push_back(jc::make_unique<Test_StaticExchange>
+		(
+			std::string_view("Static Exchange - X-Ray"),
+			*chess::parse_fen("3rk3/8/8/3p4/8/8/3R4/3R3K w - - 0 1"),
+			chess::Move(chess::Position(chess::File::d, chess::Rank::r2), chess::Position(chess::File::d, chess::Rank::r5)),
+			1.0f
+		));
+		_tests.push_back(jc::make_unique<Test_StaticExchange>
+		(
+			std::string_view("Static Exchange - King Cannot Recapture"),
+			*chess::parse_fen("8/8/8/3k4/4p3/8/6B1/4R2K w - - 0 1"),
+			chess::Move(chess::Position(chess::File::e, chess::Rank::r1), chess::Position(chess::File::e, chess::Rank::r4)),
+			1.0f
+		));
+
+		// Parallel search
+		_tests.push_back(jc::make_unique<Test_ParallelSearch>
+		(
+			std::string_view("Parallel Search - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			5
+		));
+		_tests.push_back(jc::make_unique<Test_ParallelSearch>
+		(
+			std::string_view("Parallel Search - Endgame"),
+			*chess::parse_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+			5
+		));
+		_tests.push_back(jc::make_unique<Test_LazySMP>
+		(
+			std::string_view("Lazy SMP - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			7,
+			4
+		));
+		_tests.push_back(jc::make_unique<Test_LazySMP>
+		(
+			std::string_view("Lazy SMP - Endgame"),
+			*chess::parse_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+			9,
+			4
+		));
+
+		// Aspiration windows
+		_tests.push_back(jc::make_unique<Test_Aspiration>
+		(
+			std::string_view("Aspiration - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			4
+		));
+
+		// Selective search
+		_tests.push_back(jc::make_unique<Test_SelectiveSearch>
+		(
+			std::string_view("Selective Search - Rook Mate in 2"),
+			*chess::parse_fen("k7/8/2K5/8/8/8/8/7R w - - 0 1"),
+			6
+		));
+
+		// Stack based search
+		_tests.push_back(jc::make_unique<Test_StackSearch>
+		(
+			std::string_view("Stack Search - Kiwipete"),
+			*chess::parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			5
+		));
+		_tests.push_back(jc::make_unique<Test_StackSearch>
+		(
+			std::string_view("Stack Search - Endgame"),
+			*chess::parse_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"),
+			7
+		));
+
 
 
 
@@ -14,7 +14,7 @@ namespace sch
 	struct binary_set
 	{
 	public:
-		using value_type = uint32_t;
+		using value_type = uint64_t;
 		using size_type = size_t;
 
 		auto begin()
@@ -0,0 +1,213 @@
+#include "monotonic_arena.hpp"
+
+#include "utility.hpp"
+
+#include <new>
+#include <memory>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+namespace sch
+{
+	namespace
+	{
+		/**
+		 * @brief Standard sized chunks no arena is using, shared by every arena.
+		*/
+		struct ChunkPool
+		{
+			std::mutex mtx_;
+			std::vector<void*> free_;
+
+			~ChunkPool()
+			{
+				for (auto _chunk : this->free_)
+				{
+					::operator delete(_chunk, std::align_val_t(64));
+				};
+			};
+		};
+
+		ChunkPool& chunk_pool()
+		{
+			static ChunkPool _pool{};
+			return _pool;
+		};
+	};
+
+	void MonotonicArena::release_pool() noexcept
+	{
+		auto& _pool = chunk_pool();
+		auto _free = std::vector<void*>();
+		{
+			const auto lck = std::unique_lock(_pool.mtx_);
+			std::swap(_free, _pool.free_);
+		};
+		for (auto _chunk : _free)
+		{
+			::operator delete(_chunk, std::align_val_t(64));
+		};
+	};
+
+	MonotonicArena::Chunk* MonotonicArena::new_chunk(size_t _bytes)
+	{
+		void* _mem = nullptr;
+		if (_bytes <= chunk_size_v)
+		{
+			_bytes = chunk_size_v;
+			auto& _pool = chunk_pool();
+			const auto lck = std::unique_lock(_pool.mtx_);
+			if (!_pool.free_.empty())
+			{
+				_mem = _pool.free_.back();
+				_pool.free_.pop_back();
+			};
+		};
+		if (!_mem)
+		{
+			_mem = ::operator new(sizeof(Chunk) + _bytes, std::align_val_t(64));
+		};
+
+		auto _chunk = new (_mem) Chunk{};
+		_chunk->size_ = _bytes;
+		return _chunk;
+	};
+	void MonotonicArena::free_chunk(Chunk* _chunk) noexcept
+	{
+		const auto _size = _chunk->size_;
+		_chunk->~Chunk();
+		if (_size == chunk_size_v)
+		{
+			auto& _pool = chunk_pool();
+			const auto lck = std::unique_lock(_pool.mtx_);
+			if (_pool.free_.size() < max_pooled_chunks_v)
+			{
+				_pool.free_.push_back(_chunk);
+				return;
+			};
+		};
+		::operator delete(_chunk, std::align_val_t(64));
+	};
+
+	void* MonotonicArena::allocate(size_t _bytes, size_t _alignment, size_t _prefix)
+	{
+		SCREEPFISH_ASSERT(_alignment != 0 && (_alignment & (_alignment - 1)) == 0);
+
+		auto _chunk = this->current_.load(std::memory_order_acquire);
+		while (true)
+		{
+			if (_chunk)
+			{
+				const auto _base = reinterpret_cast<uintptr_t>(_chunk->data());
+				auto _used = _chunk->used_.load(std::memory_order_relaxed);
+				while (true)
+				{
+					// Bump past the padding that puts the address after the prefix on the alignment
+					const auto _aligned = (_base + _used + _prefix + _alignment - 1) & ~(uintptr_t(_alignment) - 1);
+					const auto _start = static_cast<size_t>(_aligned - _prefix - _base);
+					if (_start + _bytes > _chunk->size_)
+					{
+						break;
+					};
+					if (_chunk->used_.compare_exchange_weak(_used, _start + _bytes, std::memory_order_relaxed))
+					{
+						return _chunk->data() + _start;
+					};
+				};
+			};
+
+			this->next_chunk(_chunk, _bytes + _prefix + _alignment);
+			_chunk = this->current_.load(std::memory_order_acquire);
+		};
+	};
+
+	void MonotonicArena::next_chunk(Chunk* _full, size_t _bytes)
+	{
+		const auto lck = std::unique_lock(this->mtx_);
+		if (this->current_.load(std::memory_order_relaxed) != _full)
+		{
+			// Another thread moved on first
+			return;
+		};
+
+		auto _next = this->current_index_ + static_cast<size_t>(_full != nullptr);
+		if (_full)
+		{
+			this->retired_bytes_ += _full->used_.load(std::memory_order_relaxed);
+		};
+
+		// Chunks kept from before a reset are reused when they are big enough
+		if (_next == this->chunks_.size() || this->chunks_[_next]->size_ < _bytes)
+		{
+			this->chunks_.insert(this->chunks_.begin() + _next, new_chunk(_bytes));
+		};
+		this->current_index_ = _next;
+		this->current_.store(this->chunks_[_next], std::memory_order_release);
+	};
+
+	void MonotonicArena::reset() noexcept
+	{
+		const auto lck = std::unique_lock(this->mtx_);
+		const auto _current = this->current_.load(std::memory_order_relaxed);
+		if (!_current)
+		{
+			return;
+		};
+
+		this->peak_bytes_ = std::max(this->peak_bytes_,
+			this->retired_bytes_ + _current->used_.load(std::memory_order_relaxed));
+		for (size_t n = 0; n <= this->current_index_; ++n)
+		{
+			this->chunks_[n]->used_.store(0, std::memory_order_relaxed);
+		};
+		this->retired_bytes_ = 0;
+		this->current_index_ = 0;
+		this->current_.store(this->chunks_.front(), std::memory_order_release);
+	};
+
+	size_t MonotonicArena::bytes_used() const noexcept
+	{
+		const auto lck = std::unique_lock(this->mtx_);
+		const auto _current = this->current_.load(std::memory_order_relaxed);
+		return this->retired_bytes_ + ((_current) ? _current->used_.load(std::memory_order_relaxed) : 0);
+	};
+	size_t MonotonicArena::peak_bytes() const noexcept
+	{
+		return std::max(this->bytes_used(), this->peak_bytes_);
+	};
+	size_t MonotonicArena::chunk_count() const noexcept
+	{
+		const auto lck = std::unique_lock(this->mtx_);
+		return this->chunks_.size();
+	};
+
+	void MonotonicArena::swap(MonotonicArena& other) noexcept
+	{
+		std::swap(this->chunks_, other.chunks_);
+		const auto _current = this->current_.load(std::memory_order_relaxed);
+		this->current_.store(other.current_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		other.current_.store(_current, std::memory_order_relaxed);
+		std::swap(this->current_index_, other.current_index_);
+		std::swap(this->retired_bytes_, other.retired_bytes_);
+		std::swap(this->peak_bytes_, other.peak_bytes_);
+	};
+
+	MonotonicArena::MonotonicArena(MonotonicArena&& other) noexcept
+	{
+		this->swap(other);
+	};
+	MonotonicArena& MonotonicArena::operator=(MonotonicArena&& other) noexcept
+	{
+		this->swap(other);
+		return *this;
+	};
+
+	MonotonicArena::~MonotonicArena()
+	{
+		for (auto _chunk : this->chunks_)
+		{
+			free_chunk(_chunk);
+		};
+	};
+};
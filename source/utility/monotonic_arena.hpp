@@ -0,0 +1,129 @@
+#pragma once
+
+/** @file */
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+namespace sch
+{
+	/**
+	 * @brief Hands out memory by bumping a pointer through large chunks, everything is freed at once by resetting it.
+	 *
+	 * Nothing handed out is freed on its own and nothing in it is destroyed, it is only for objects that can
+	 * be dropped without running their destructors. Threads may allocate from the same arena at once, an
+	 * allocation only takes a compare and swap until its chunk runs out.
+	 *
+	 * Chunks an arena no longer needs go to a pool shared by every arena, so arenas that come and go,
+	 * such as one per search, rarely touch the system allocator once the pool has warmed up.
+	*/
+	class MonotonicArena
+	{
+	public:
+
+		/**
+		 * @brief Bytes in each chunk, larger allocations get a chunk of their own.
+		*/
+		constexpr static size_t chunk_size_v = size_t(1) << 20;
+
+		/**
+		 * @brief Most chunks kept in the shared pool, any more are returned to the system.
+		 *
+		 * A full pool holds on to 256 MiB after the arenas that used it are gone. That is about what one deep
+		 * tree search peaks at, so the next search does not have to ask the system for it again. Call
+		 * release_pool() to hand it back once no more searches are coming.
+		*/
+		constexpr static size_t max_pooled_chunks_v = 256;
+
+		/**
+		 * @brief Returns every chunk in the shared pool to the system, chunks held by live arenas are kept.
+		*/
+		static void release_pool() noexcept;
+
+		/**
+		 * @brief Allocates memory that stays valid until the arena is reset or destroyed.
+		 * @param _bytes Bytes to allocate.
+		 * @param _alignment Power of two the address _prefix bytes into the memory is aligned to.
+		 * @param _prefix Bytes in front of the aligned part, for a header before an aligned block.
+		 * @return Allocated memory.
+		*/
+		void* allocate(size_t _bytes, size_t _alignment, size_t _prefix = 0);
+
+		/**
+		 * @brief Frees everything allocated at once, keeping the chunks for the allocations that follow.
+		 *
+		 * Nothing may allocate from the arena at the same time.
+		*/
+		void reset() noexcept;
+
+		/**
+		 * @brief Gets the number of bytes handed out since the last reset, including alignment padding.
+		*/
+		size_t bytes_used() const noexcept;
+
+		/**
+		 * @brief Gets the most bytes that were ever handed out between resets.
+		*/
+		size_t peak_bytes() const noexcept;
+
+		/**
+		 * @brief Gets the number of chunks the arena holds.
+		*/
+		size_t chunk_count() const noexcept;
+
+		MonotonicArena() = default;
+
+		// Copies start out empty, nothing allocated from one arena belongs to another
+		MonotonicArena(const MonotonicArena&) :
+			MonotonicArena()
+		{};
+		MonotonicArena& operator=(const MonotonicArena&) noexcept
+		{
+			return *this;
+		};
+
+		// Moves swap, so memory the destination handed out lives on until the source is destroyed
+		MonotonicArena(MonotonicArena&& other) noexcept;
+		MonotonicArena& operator=(MonotonicArena&& other) noexcept;
+
+		~MonotonicArena();
+
+	private:
+
+		struct alignas(64) Chunk
+		{
+			std::atomic<size_t> used_{ 0 };
+			size_t size_ = 0;
+
+			std::byte* data() noexcept
+			{
+				return reinterpret_cast<std::byte*>(this + 1);
+			};
+		};
+
+		/**
+		 * @brief Moves on from a full chunk to the next one, unless another thread already has.
+		 * @param _full Chunk that could not fit an allocation, null if there is none yet.
+		 * @param _bytes Bytes the next chunk must have room for.
+		*/
+		void next_chunk(Chunk* _full, size_t _bytes);
+
+		void swap(MonotonicArena& other) noexcept;
+
+		static Chunk* new_chunk(size_t _bytes);
+		static void free_chunk(Chunk* _chunk) noexcept;
+
+		// Chunks in the order they are used, the ones after the current chunk are empty
+		std::vector<Chunk*> chunks_{};
+		std::atomic<Chunk*> current_{ nullptr };
+		size_t current_index_ = 0;
+
+		// Bytes used in the chunks before the current one
+		size_t retired_bytes_ = 0;
+		size_t peak_bytes_ = 0;
+
+		mutable std::mutex mtx_;
+	};
+};